@@ -5,11 +5,17 @@ layout(location = 1) in vec4 color;
 
 layout(location = 0) out vec4 passColor;
 
+layout(std140, row_major) uniform Camera {
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+	float time;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main() {
-	gl_Position = projection * view * model * vec4(position, 1.0);
+	gl_Position = viewProjection * model * vec4(position, 1.0);
 	passColor = color;
 }
\ No newline at end of file
@@ -3,13 +3,36 @@
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec2 texCoord;
 
+#ifdef INSTANCED
+// Rows of the row-major model matrix and the albedo, advanced once per instance
+layout(location = 2) in mat4 instanceModel;
+layout(location = 6) in vec4 instanceAlbedo;
+#endif
+
 layout(location = 0) out vec2 passTexCoord;
+#ifdef INSTANCED
+layout(location = 1) flat out vec4 passAlbedo;
+#endif
+
+layout(std140, row_major) uniform Camera {
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+	float time;
+};
 
+#ifdef INSTANCED
+void main() {
+	gl_Position = viewProjection * transpose(instanceModel) * vec4(position, 1.0);
+	passTexCoord = texCoord;
+	passAlbedo = instanceAlbedo;
+}
+#else
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main() {
-	gl_Position = projection * view * model * vec4(position, 1.0);
+	gl_Position = viewProjection * model * vec4(position, 1.0);
 	passTexCoord = texCoord;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
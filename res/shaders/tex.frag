@@ -4,11 +4,18 @@ layout (location = 0) in vec2 passTexCoords;
 
 layout (location = 0) out vec4 color;
 
+#ifdef INSTANCED
+layout (location = 1) flat in vec4 passAlbedo;
+#define albedo passAlbedo
+#else
 uniform vec4 albedo;
+#endif
 uniform sampler2D tex;
+// Sub-rectangle of the texture to sample when it is part of an atlas
+uniform vec4 uvRect = vec4(0.0, 0.0, 1.0, 1.0);
 
 void main() {
-	vec4 texColor = texture(tex, passTexCoords);
+	vec4 texColor = texture(tex, uvRect.xy + passTexCoords * uvRect.zw);
 	vec4 finalColor = texColor * albedo;
 	color = finalColor;
 }
\ No newline at end of file
@@ -4,10 +4,35 @@ layout (location = 0) in vec2 passTexCoords;
 
 layout (location = 0) out vec4 color;
 
+#ifdef INSTANCED
+layout (location = 1) flat in vec4 passAlbedo;
+#define albedo passAlbedo
+#else
 uniform vec4 albedo;
+#endif
+
+// Permutations define TEX_COUNT, MIX_LAYERS and USE_MIX_MODE_<mode> for the modes they use,
+// without them the texture count and mix modes are read from uniforms at runtime.
+// TEX_ARRAY permutations sample layers of texture arrays instead of 2D textures.
+#ifdef TEX_COUNT
+#if TEX_COUNT > 0
+#ifdef TEX_ARRAY
+uniform sampler2DArray textures[TEX_COUNT];
+uniform int layers[TEX_COUNT];
+#define SAMPLE(i, uv) texture(textures[i], vec3(uv, layers[i]))
+#else
+uniform sampler2D textures[TEX_COUNT];
+#define SAMPLE(i, uv) texture(textures[i], uv)
+#endif
+uniform vec4 uvRects[TEX_COUNT];
+#endif
+#else
+#define ALL_MIX_MODES
 uniform int texCount;
 uniform sampler2D textures[32];
+uniform vec4 uvRects[32];
 uniform int mixModes[31];
+#endif
 
 #define MIX_MODE_MULTIPLY 0
 #define MIX_MODE_ADD 1
@@ -120,113 +145,183 @@ vec3 hsvToRgb(vec3 hsv) {
 }
 
 vec3 mix(vec3 a, vec3 b, int mode) {
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_0)
 	if (mode == MIX_MODE_MULTIPLY) {
 		return a * b;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_1)
 	if (mode == MIX_MODE_ADD) {
 		return a + b;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_2)
 	if (mode == MIX_MODE_SUBTRACT) {
 		return a - b;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_3)
 	if (mode == MIX_MODE_DIVIDE) {
 		return a / b;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_4)
 	if (mode == MIX_MODE_SCREEN) {
 		return 1.0 - (1.0 - a) * (1.0 - b);
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_5)
 	if (mode == MIX_MODE_OVERLAY) {
 		return a * (1.0 - b) + b * (1.0 - a);
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_6)
 	if (mode == MIX_MODE_DARKEN) {
 		return min(a, b);
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_7)
 	if (mode == MIX_MODE_LIGHTEN) {
 		return max(a, b);
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_8)
 	if (mode == MIX_MODE_DIFFERENCE) {
 		return abs(a - b);
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_9)
 	if (mode == MIX_MODE_EXCLUSION) {
 		return a + b - 2.0 * a * b;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_10)
 	if (mode == MIX_MODE_SOFT_LIGHT) {
 		return (1.0 - b) * a * a + 2.0 * b * a;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_11)
 	if (mode == MIX_MODE_HARD_LIGHT) {
 		vec3 c = 2.0 * a * b;
 		vec3 d = 1.0 - 2.0 * (1.0 - a) * (1.0 - b);
 		vec3 e = step(0.5, b);
 		return c * e + d * (1.0 - e);
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_12)
 	if (mode == MIX_MODE_COLOR_DODGE) {
 		return a / (1.0 - b);
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_13)
 	if (mode == MIX_MODE_COLOR_BURN) {
 		return 1.0 - (1.0 - a) / b;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_14)
 	if (mode == MIX_MODE_LINEAR_DODGE) {
 		return a + b;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_15)
 	if (mode == MIX_MODE_LINEAR_BURN) {
 		return a + b - 1.0;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_16)
 	if (mode == MIX_MODE_LINEAR_LIGHT) {
 		return a + 2.0 * b - 1.0;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_17)
 	if (mode == MIX_MODE_VIVID_LIGHT) {
 		return a + 2.0 * b - 1.0;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_18)
 	if (mode == MIX_MODE_PIN_LIGHT) {
 		return a + 2.0 * b - 1.0;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_19)
 	if (mode == MIX_MODE_HARD_MIX) {
 		return step(0.5, a + b);
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_20)
 	if (mode == MIX_MODE_REFLECT) {
 		return a * a / (1.0 - b);
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_21)
 	if (mode == MIX_MODE_GLOW) {
 		return b * b / (1.0 - a);
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_22)
 	if (mode == MIX_MODE_PHOENIX) {
 		return min(a, b) - max(a, b) + 1.0;
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_23)
 	if (mode == MIX_MODE_HUE) {
 		vec3 hsvA = rgbToHsv(a);
 		vec3 hsvB = rgbToHsv(b);
 		return hsvToRgb(vec3(hsvB.x, hsvA.y, hsvA.z));
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_24)
 	if (mode == MIX_MODE_SATURATION) {
 		vec3 hsvA = rgbToHsv(a);
 		vec3 hsvB = rgbToHsv(b);
 		return hsvToRgb(vec3(hsvA.x, hsvB.y, hsvA.z));
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_25)
 	if (mode == MIX_MODE_COLOR) {
 		vec3 hsvA = rgbToHsv(a);
 		vec3 hsvB = rgbToHsv(b);
 		return hsvToRgb(vec3(hsvB.x, hsvB.y, hsvA.z));
 	}
+#endif
+#if defined(ALL_MIX_MODES) || defined(USE_MIX_MODE_26)
 	if (mode == MIX_MODE_LUMINOSITY) {
 		vec3 hsvA = rgbToHsv(a);
 		vec3 hsvB = rgbToHsv(b);
 		return hsvToRgb(vec3(hsvA.x, hsvA.y, hsvB.z));
 	}
+#endif
 	return a;
 }
 
+#ifdef TEX_COUNT
+#define MIX_LAYER(i, mode) texColor = clamp(mix(texColor, SAMPLE(i, uvRects[i].xy + passTexCoords * uvRects[i].zw).rgb, mode), 0.0, 1.0);
+
+void main() {
+#if TEX_COUNT == 0
+	color = albedo;
+#else
+	vec4 originalTexColor = SAMPLE(0, uvRects[0].xy + passTexCoords * uvRects[0].zw);
+	vec3 texColor = originalTexColor.rgb;
+	MIX_LAYERS
+	vec4 finalColor = vec4(texColor, originalTexColor.a) * albedo;
+	color = finalColor;
+#endif
+}
+#else
 void main() {
 	if (texCount == 0) {
 		color = albedo;
 		return;
 	}
-	vec4 originalTexColor = texture(textures[0], passTexCoords);
+	vec4 originalTexColor = texture(textures[0], uvRects[0].xy + passTexCoords * uvRects[0].zw);
 	vec3 texColor = originalTexColor.rgb;
 	for (int i = 1; i < texCount; i++) {
-		vec4 nextTexColor = texture(textures[i], passTexCoords);
+		vec4 nextTexColor = texture(textures[i], uvRects[i].xy + passTexCoords * uvRects[i].zw);
 		texColor = mix(texColor, nextTexColor.rgb, mixModes[i - 1]);
 		texColor = clamp(texColor, 0.0, 1.0);
 	}
 	vec4 finalColor = vec4(texColor, originalTexColor.a) * albedo;
 	color = finalColor;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
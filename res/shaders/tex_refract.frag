@@ -4,7 +4,12 @@ layout (location = 0) in vec2 passTexCoords;
 
 layout (location = 0) out vec4 color;
 
+#ifdef INSTANCED
+layout (location = 1) flat in vec4 passAlbedo;
+#define albedo passAlbedo
+#else
 uniform vec4 albedo;
+#endif
 uniform float offsetScale;
 uniform sampler2D tex;
 uniform sampler2D offsetMap;
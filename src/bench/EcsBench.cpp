@@ -0,0 +1,183 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include <cmath>
+
+#include "../engine/math/Mat4.hpp"
+#include "../engine/math/Frustum.hpp"
+#include "../engine/object/Object.hpp"
+#include "../engine/render/FrustumCuller.hpp"
+#include "../engine/render/InstanceRenderer.hpp"
+#include "../engine/ecs/Registry.hpp"
+#include "../engine/ecs/RenderSystem.hpp"
+
+// Compares one frame of transform update, frustum culling and draw list build between the
+// Object/Renderable path and the ecs::Registry path. Nothing is drawn, so no GL context is needed.
+// Usage: EcsBench [entity count] [frames]
+
+namespace {
+	constexpr float WORLD_SIZE = 1000;
+	
+	using Clock = std::chrono::steady_clock;
+	
+	double milliseconds(Clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+	
+	struct Timings {
+		double transform = 0;
+		double cull = 0;
+		double draw_list = 0;
+		size_t visible = 0;
+		size_t instances = 0;
+	};
+	
+	void print(const std::string& name, const Timings& timings, int frames) {
+		double total = timings.transform + timings.cull + timings.draw_list;
+		std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(12) << timings.transform / frames
+			<< std::setw(12) << timings.cull / frames
+			<< std::setw(12) << timings.draw_list / frames
+			<< std::setw(12) << total / frames
+			<< std::setw(12) << timings.visible / frames
+			<< std::setw(12) << timings.instances / frames << std::endl;
+	}
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::stoul(argv[1]) : 100000;
+	int frames = argc > 2 ? std::stoi(argv[2]) : 60;
+	
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> position(-WORLD_SIZE / 2, WORLD_SIZE / 2);
+	std::uniform_real_distribution<float> angle(0, 2 * M_PI);
+	std::uniform_real_distribution<float> scale(0.5f, 2);
+	std::uniform_real_distribution<float> step(-1, 1);
+	
+	// Without a context meshes can't be uploaded, so every entity shares an empty one
+	engine::render::Mesh mesh;
+	
+	std::vector<engine::object::Object> objects;
+	objects.reserve(count);
+	engine::ecs::Registry registry;
+	std::vector<engine::ecs::Entity> entities(count);
+	std::vector<engine::math::Vec3> velocities(count);
+	for (size_t i = 0; i < count; i++) {
+		engine::math::Vec3 p(position(rng), position(rng) * 0.1f, position(rng));
+		engine::math::Vec3 r(angle(rng), angle(rng), angle(rng));
+		engine::math::Vec3 s(scale(rng));
+		engine::math::Vec4 albedo(1, 1, 1, i % 10 == 0 ? 0.5f : 1);
+		
+		engine::object::Object obj(mesh);
+		obj.position() = p;
+		obj.rotation() = r;
+		obj.scale() = s;
+		obj.albedo() = albedo;
+		objects.push_back(obj);
+		
+		entities[i] = registry.create();
+		registry.add_transform(entities[i], p, r, s);
+		registry.add_render(entities[i], mesh, nullptr, albedo);
+		
+		velocities[i] = engine::math::Vec3(step(rng), 0, step(rng));
+	}
+	
+	// Both paths have to agree on the model matrices
+	registry.update_transforms();
+	for (size_t i = 0; i < count; i++) {
+		engine::math::Mat4 model = objects[i].model();
+		const float* a = model.data();
+		const float* b = registry.world(entities[i]).data();
+		for (int j = 0; j < 16; j++) {
+			if (std::abs(a[j] - b[j]) > 1e-3f) {
+				std::cerr << "World matrix of entity " << i << " differs from Object::model()" << std::endl;
+				return 1;
+			}
+		}
+	}
+	
+	engine::math::Mat4 projection = engine::math::Mat4::perspective(1.2f, 16.0f / 9, 0.1f, 300);
+	engine::render::FrustumCuller culler;
+	engine::render::InstanceRenderer renderer;
+	engine::ecs::RenderSystem system;
+	Timings objectTimings;
+	Timings ecsTimings;
+	std::vector<engine::object::Renderable*> all;
+	std::vector<engine::object::Renderable*> visible;
+	std::vector<engine::object::Renderable*> blendedObjects;
+	std::vector<uint32_t> blended;
+	for (int frame = 0; frame < frames; frame++) {
+		float yaw = frame * 0.05f;
+		engine::math::Mat4 view = engine::math::Mat4::lookAt(engine::math::Vec3(0, 5, 0),
+			engine::math::Vec3(std::cos(yaw), 5, std::sin(yaw)), engine::math::Vec3(0, 1, 0));
+		engine::math::Frustum frustum(projection * view);
+		
+		// Object path, as render_all() did it: the model matrix is rebuilt on every get_model()
+		Clock::time_point start = Clock::now();
+		for (size_t i = 0; i < count; i++) {
+			objects[i].position() += velocities[i];
+		}
+		objectTimings.transform += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		all.clear();
+		for (auto& obj : objects) {
+			all.push_back(&obj);
+		}
+		visible.clear();
+		culler.cull(all, frustum, visible);
+		objectTimings.cull += milliseconds(Clock::now() - start);
+		objectTimings.visible += visible.size();
+		
+		start = Clock::now();
+		renderer.begin();
+		blendedObjects.clear();
+		for (auto* obj : visible) {
+			if (obj->get_albedo().w() < 1) {
+				blendedObjects.push_back(obj);
+			}
+			else {
+				renderer.add(*obj);
+			}
+		}
+		objectTimings.draw_list += milliseconds(Clock::now() - start);
+		objectTimings.instances += renderer.instance_count();
+		
+		// Registry path
+		start = Clock::now();
+		std::vector<engine::math::Vec3>& positions = registry.positions();
+		for (size_t i = 0; i < count; i++) {
+			positions[i] += velocities[i];
+		}
+		registry.update_transforms();
+		ecsTimings.transform += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		system.cull(registry, frustum);
+		ecsTimings.cull += milliseconds(Clock::now() - start);
+		ecsTimings.visible += system.visible().size();
+		
+		start = Clock::now();
+		renderer.begin();
+		blended.clear();
+		system.submit(registry, renderer, blended);
+		ecsTimings.draw_list += milliseconds(Clock::now() - start);
+		ecsTimings.instances += renderer.instance_count();
+	}
+	
+	std::cout << count << " entities, " << frames << " frames, average per frame in ms" << std::endl;
+	std::cout << std::left << std::setw(10) << "" << std::right << std::setw(12) << "transform" << std::setw(12)
+		<< "cull" << std::setw(12) << "draw list" << std::setw(12) << "total" << std::setw(12) << "visible"
+		<< std::setw(12) << "instances" << std::endl;
+	print("Object", objectTimings, frames);
+	print("ecs", ecsTimings, frames);
+	
+	if (objectTimings.visible != ecsTimings.visible || objectTimings.instances != ecsTimings.instances) {
+		std::cerr << "Results differ between the Object and ecs paths" << std::endl;
+		return 1;
+	}
+	return 0;
+}
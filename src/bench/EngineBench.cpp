@@ -0,0 +1,584 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "../engine/Camera.hpp"
+#include "../engine/object/Mesh.hpp"
+#include "../engine/object/Material.hpp"
+#include "../engine/ecs/Registry.hpp"
+#include "../engine/ecs/RenderSystem.hpp"
+#include "../engine/ecs/Prefabs.hpp"
+#include "../engine/scene/SceneGraph.hpp"
+#include "../engine/scene/StaticBVH.hpp"
+#include "../engine/scene/HashGrid.hpp"
+#include "../engine/render/Shader.hpp"
+#include "../engine/render/ShaderVariants.hpp"
+#include "../engine/render/CameraUniforms.hpp"
+#include "../engine/render/InstanceRenderer.hpp"
+#include "../engine/render/GeometryArena.hpp"
+#include "../engine/render/IndirectRenderer.hpp"
+#include "../engine/render/OcclusionCuller.hpp"
+#include "../engine/render/FrameSnapshot.hpp"
+#include "../engine/render/RenderStats.hpp"
+#include "../engine/render/Framebuffer.hpp"
+#include "../engine/render/GLBackend.hpp"
+#include "../engine/profile/MemoryTracker.hpp"
+
+// Builds parameterized scenes, renders them offscreen and reports load times and per-frame CPU timings.
+// Every scenario starts from an empty scene and replays the same camera motion, so runs of different
+// builds on the same machine can be compared through the JSON output.
+// Frames take the same path as in main.cpp: the scene is an ecs::Registry culled through a StaticBVH and
+// the OcclusionCuller, and arena meshes are drawn with IndirectRenderer where it is supported. Moving
+// scenes are culled through a HashGrid instead.
+// Usage: EngineBench [scenario=size]... [--frames N] [--size WxH] [--json path]
+//   cubes=N        N opaque cubes from ecs::Prefabs::add_cube(), the ones next to the camera are occluders
+//   transparent=M  M blended quads, sorted back to front every frame
+//   terrain=K      one K x K vertex heightmap mesh from Mesh::fromHeightmap()
+//   textures=T     T cubes, each with its own two-layer tex_mix material
+//   moving=N       N cubes circling around their grid cells, moved through the scene graph every frame
+// Without scenarios all five run with their default sizes.
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+	
+	// Frames rendered before measuring, so driver warm-up and first uploads aren't counted
+	constexpr int WARMUP_FRAMES = 10;
+	constexpr float SPACING = 4;
+	// Radius of the circles of the moving cubes, and how fast they go round
+	constexpr float ORBIT = 2 * SPACING;
+	constexpr float ORBIT_SPEED = 0.05f;
+	
+	const char* VERTEX_PATH = "../res/shaders/tex-3d.vert";
+	const char* FRAGMENT_PATH = "../res/shaders/tex_mix.frag";
+	const char* ASSETS[] = {"../res/assets/Untitled.jpg", "../res/assets/13391-normal.jpg", "../res/assets/height.png"};
+	const char* HEIGHTMAP_PATH = "../res/assets/height.png";
+	
+	struct Scenario {
+		std::string name;
+		int size;
+	};
+	
+	const Scenario DEFAULT_SCENARIOS[] = {{"cubes", 1000}, {"transparent", 1000}, {"terrain", 256}, {"textures", 32},
+		{"moving", 1000}};
+	
+	double milliseconds(Clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+	
+	struct Summary {
+		double mean, p50, p95, p99, max;
+	};
+	
+	Summary summarize(const std::vector<double>& values) {
+		if (values.empty()) {
+			return {0, 0, 0, 0, 0};
+		}
+		double sum = 0;
+		for (double value : values) {
+			sum += value;
+		}
+		engine::render::RenderStats::Percentiles p = engine::render::RenderStats::percentiles(values);
+		return {sum / values.size(), p.p50, p.p95, p.p99, p.max};
+	}
+	
+	// Per-frame timings in ms, in the order they are written
+	enum Phase {
+		UPDATE,
+		CULL,
+		SORT,
+		DRAW,
+		CPU,
+		GPU_WAIT,
+		PHASE_COUNT
+	};
+	const char* PHASE_NAMES[PHASE_COUNT] = {"update", "cull", "sort", "draw", "cpu", "gpu_wait"};
+	
+	struct Result {
+		Scenario scenario;
+		size_t objects = 0;
+		double shaders_ms = 0;
+		double textures_ms = 0;
+		double meshes_ms = 0;
+		// Building the StaticBVH, or filling the grid of a moving scene
+		double tree_ms = 0;
+		std::vector<double> phases[PHASE_COUNT];
+		double visible = 0;
+		double draw_calls = 0;
+		double triangles = 0;
+		// Peak bytes while the scenario was loaded, including the shared render targets
+		size_t cpu_peak = 0;
+		size_t gpu_peak = 0;
+	};
+	
+	struct Scene {
+		engine::scene::SceneGraph graph;
+		engine::ecs::Registry registry;
+		// Scenes that don't move are culled through a tree built once
+		engine::scene::StaticBVH tree;
+		// Moving ones through a grid, with the grid handle of every packed render index
+		engine::scene::HashGrid grid = engine::scene::HashGrid(2 * SPACING);
+		std::vector<int> handles;
+		// Scene graph nodes moved every frame, and the centres of their circles
+		std::vector<int> movers;
+		std::vector<engine::math::Vec3> orbits;
+		// Packed render indices rasterized into the occlusion depth buffer
+		std::vector<uint32_t> occluders;
+		engine::render::Mesh mesh;
+		std::vector<engine::render::Material> materials;
+		engine::render::Material default_material;
+		engine::math::Vec3 camera_position;
+		engine::math::Vec3 camera_rotation;
+	};
+	
+	// Adds a cube and returns its node; its faces become occluders if it is next to the camera
+	int add_cube(Scene& scene, const engine::math::Vec3& position, const engine::render::Material* material) {
+		size_t first = scene.registry.render_count();
+		int node = engine::ecs::Prefabs::add_cube(scene.registry, scene.graph, scene.mesh, position, material);
+		if ((position - scene.camera_position).magnitude() < SPACING) {
+			for (size_t i = first; i < scene.registry.render_count(); i++) {
+				scene.occluders.push_back(static_cast<uint32_t>(i));
+			}
+		}
+		return node;
+	}
+	
+	// Position of the i-th of count cells of a cube-shaped grid centred on the origin
+	engine::math::Vec3 grid_position(int i, int count) {
+		int side = std::max(1, (int) std::ceil(std::cbrt((double) count)));
+		float offset = (side - 1) * SPACING / 2;
+		return engine::math::Vec3(i % side * SPACING - offset, i / side % side * SPACING - offset,
+			i / (side * side) * SPACING - offset);
+	}
+	
+	engine::render::Mesh square_mesh(engine::render::GeometryArena& arena) {
+		std::vector<engine::render::Vertex> vertices = {
+			{engine::math::Vec3(-1, -1, 0), engine::math::Vec2(0, 0)},
+			{engine::math::Vec3(1, -1, 0),  engine::math::Vec2(1, 0)},
+			{engine::math::Vec3(1, 1, 0),   engine::math::Vec2(1, 1)},
+			{engine::math::Vec3(-1, 1, 0),  engine::math::Vec2(0, 1)}
+		};
+		std::vector<unsigned int> indices = {0, 1, 3, 1, 2, 3};
+		return engine::render::Mesh(vertices, indices, arena);
+	}
+	
+	// Decodes the textures in parallel, then uploads one material per texture
+	std::vector<engine::render::Material> load_materials(std::vector<engine::graphics::Texture>& textures) {
+		std::vector<engine::graphics::Texture*> pointers;
+		for (auto& texture : textures) {
+			pointers.push_back(&texture);
+		}
+		engine::graphics::Texture::loadAll(pointers);
+		std::vector<engine::render::Material> materials;
+		for (auto& texture : textures) {
+			materials.emplace_back(texture);
+		}
+		return materials;
+	}
+	
+	// Builds the scene and records the load times in the result. The heightmap is always loaded, the
+	// default material is made from it. Meshes are sub-allocated in the arena, as main.cpp does.
+	bool build(const Scenario& scenario, Scene& scene, engine::render::GeometryArena& arena, Result& result) {
+		std::vector<engine::graphics::Texture> textures = {engine::graphics::Texture(HEIGHTMAP_PATH)};
+		if (scenario.name == "textures") {
+			for (int i = 0; i < scenario.size * 2; i++) {
+				textures.emplace_back(ASSETS[i % std::size(ASSETS)]);
+			}
+		}
+		Clock::time_point start = Clock::now();
+		std::vector<engine::render::Material> loaded = load_materials(textures);
+		result.textures_ms = milliseconds(Clock::now() - start);
+		scene.default_material = loaded[0];
+		if (scenario.name == "textures") {
+			// Cycling the mix mode gives several shader permutations to compile
+			for (int i = 0; i < scenario.size; i++) {
+				engine::render::Material material = loaded[1 + i * 2];
+				auto mode = static_cast<engine::graphics::TextureMixingMode>(i % 8);
+				material.add_layer(loaded[2 + i * 2], mode);
+				scene.materials.push_back(material);
+			}
+		}
+		
+		start = Clock::now();
+		if (scenario.name == "terrain") {
+			scene.mesh = engine::render::Mesh::fromHeightmap(textures[0], 0.1f, scenario.size, scenario.size, &arena);
+		}
+		else {
+			scene.mesh = square_mesh(arena);
+		}
+		result.meshes_ms = milliseconds(Clock::now() - start);
+		
+		// Render components keep pointers to the mesh and the materials, so neither may move from here on
+		engine::math::Vec4 white(1, 1, 1, 1);
+		if (scenario.name == "cubes") {
+			for (int i = 0; i < scenario.size; i++) {
+				add_cube(scene, grid_position(i, scenario.size), nullptr);
+			}
+		}
+		else if (scenario.name == "transparent") {
+			for (int i = 0; i < scenario.size; i++) {
+				engine::ecs::Entity quad = scene.registry.create();
+				scene.registry.add_transform(quad, grid_position(i, scenario.size), engine::math::Vec3(0, i * 0.7f, 0));
+				scene.registry.add_render(quad, scene.mesh, nullptr, engine::math::Vec4(1, 1, 1, 0.5f));
+			}
+		}
+		else if (scenario.name == "terrain") {
+			// Laid flat with one world unit per vertex, seen from above its centre
+			engine::ecs::Entity terrain = scene.registry.create();
+			scene.registry.add_transform(terrain, engine::math::Vec3::ZERO, engine::math::Vec3(-M_PI / 2, 0, 0),
+				engine::math::Vec3(scenario.size / 2.0f, scenario.size / 2.0f, 10));
+			scene.registry.add_render(terrain, scene.mesh, nullptr, white);
+			scene.camera_position = engine::math::Vec3(0, 20, 0);
+			scene.camera_rotation = engine::math::Vec3(0.5f, 0, 0);
+		}
+		else if (scenario.name == "textures") {
+			for (int i = 0; i < scenario.size; i++) {
+				add_cube(scene, grid_position(i, scenario.size), &scene.materials[i]);
+			}
+		}
+		else if (scenario.name == "moving") {
+			for (int i = 0; i < scenario.size; i++) {
+				engine::math::Vec3 orbit = grid_position(i, scenario.size);
+				scene.movers.push_back(add_cube(scene, orbit, nullptr));
+				scene.orbits.push_back(orbit);
+			}
+		}
+		else {
+			std::cerr << "Unknown scenario: " << scenario.name << std::endl;
+			return false;
+		}
+		scene.graph.update();
+		scene.registry.update_transforms();
+		result.objects = scene.registry.render_count();
+		
+		start = Clock::now();
+		if (scene.movers.empty()) {
+			scene.tree = engine::scene::StaticBVH::build(engine::ecs::RenderSystem::bounds(scene.registry));
+		}
+		else {
+			engine::ecs::RenderSystem::place(scene.registry, scene.grid, scene.handles);
+		}
+		result.tree_ms = milliseconds(Clock::now() - start);
+		return true;
+	}
+	
+	// Moves every mover a step along its circle, starting each one at a different angle
+	void move_cubes(Scene& scene, int frame) {
+		for (size_t i = 0; i < scene.movers.size(); i++) {
+			float angle = i + frame * ORBIT_SPEED;
+			scene.graph.position(scene.movers[i]) = scene.orbits[i] +
+				engine::math::Vec3(std::cos(angle), 0, std::sin(angle)) * ORBIT;
+		}
+	}
+	
+	// Compiles every tex_mix permutation the scene draws with, up front instead of on first use
+	void compile_shaders(Scene& scene, engine::render::ShaderVariants& variants, Result& result) {
+		Clock::time_point start = Clock::now();
+		std::vector<const engine::render::Material*> materials = {&scene.default_material};
+		for (const auto& material : scene.materials) {
+			materials.push_back(&material);
+		}
+		for (const auto* material : materials) {
+			material->shader(variants);
+			material->shader(variants, {engine::render::InstanceRenderer::DEFINE});
+		}
+		glFinish();
+		result.shaders_ms = milliseconds(Clock::now() - start);
+	}
+	
+	void run(const Scenario& scenario, int frames, const engine::render::Framebuffer& framebuffer,
+		engine::render::CameraUniforms& camera_uniforms, engine::render::InstanceRenderer& instance_renderer,
+		engine::render::GeometryArena& arena, engine::render::IndirectRenderer& indirect_renderer, Result& result) {
+		result.scenario = scenario;
+		engine::profile::MemoryTracker::reset_peaks();
+		Scene scene;
+		if (!build(scenario, scene, arena, result)) {
+			return;
+		}
+		engine::render::ShaderVariants variants(VERTEX_PATH, FRAGMENT_PATH);
+		compile_shaders(scene, variants, result);
+		
+		engine::Camera camera(90, (float) framebuffer.width() / framebuffer.height(), 0.1f, 1000.0f);
+		engine::ecs::RenderSystem system;
+		engine::render::OcclusionCuller occlusion_culler;
+		bool indirect = engine::render::IndirectRenderer::supported();
+		const std::vector<uint32_t>& transforms = scene.registry.render_transforms();
+		const std::vector<const engine::render::Mesh*>& meshes = scene.registry.meshes();
+		const std::vector<engine::math::Vec4>& albedos = scene.registry.albedos();
+		const std::vector<engine::math::Mat4>& world = scene.registry.world_matrices();
+		std::vector<engine::render::FrameSnapshot::Draw> opaque;
+		std::vector<uint32_t> blended;
+		engine::render::RenderStats::reset();
+		framebuffer.bind();
+		
+		for (int frame = -WARMUP_FRAMES; frame < frames; frame++) {
+			// One full turn over the measured frames
+			float yaw = 2 * M_PI * std::max(frame, 0) / frames;
+			camera.set_position(scene.camera_position);
+			camera.set_rotation(scene.camera_rotation + engine::math::Vec3(0, yaw, 0));
+			
+			Clock::time_point start = Clock::now();
+			move_cubes(scene, frame);
+			scene.graph.update();
+			if (scene.graph.updated() > 0) {
+				scene.registry.update_transforms();
+				engine::ecs::RenderSystem::place(scene.registry, scene.grid, scene.handles);
+			}
+			// The steps of build_snapshot() in main.cpp
+			Clock::time_point cull_start = Clock::now();
+			if (scene.movers.empty()) {
+				system.cull(scene.registry, scene.tree, camera.frustum());
+			}
+			else {
+				system.cull(scene.registry, scene.grid, camera.frustum());
+			}
+			system.occlude(scene.registry, occlusion_culler, camera.projection_matrix() * camera.view_matrix(),
+				scene.occluders);
+			opaque.clear();
+			blended.clear();
+			system.submit(scene.registry, opaque, blended);
+			Clock::time_point sort_start = Clock::now();
+			engine::ecs::RenderSystem::sort(scene.registry, camera, blended);
+			Clock::time_point draw_start = Clock::now();
+			
+			// And the passes of render_snapshot()
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			camera_uniforms.update(camera, frame / 60.0f);
+			instance_renderer.begin();
+			indirect_renderer.begin();
+			for (const auto& draw : opaque) {
+				if (!indirect || !indirect_renderer.add(*draw.mesh, draw.material, draw.instance)) {
+					instance_renderer.add(*draw.mesh, draw.material, draw.instance);
+				}
+			}
+			if (indirect) {
+				indirect_renderer.draw(variants, scene.default_material);
+			}
+			instance_renderer.draw(variants, scene.default_material);
+			if (!blended.empty()) {
+				const engine::Shader& shader = scene.default_material.shader(variants);
+				shader.use();
+				scene.default_material.bind(shader);
+				for (uint32_t index : blended) {
+					shader.set_mat4("model", world[transforms[index]]);
+					shader.set_vec4("albedo", albedos[index]);
+					meshes[index]->draw();
+				}
+			}
+			Clock::time_point draw_end = Clock::now();
+			glFinish();
+			Clock::time_point end = Clock::now();
+			engine::render::RenderStats::end_frame();
+			
+			if (frame < 0) {
+				continue;
+			}
+			result.phases[UPDATE].push_back(milliseconds(cull_start - start));
+			result.phases[CULL].push_back(milliseconds(sort_start - cull_start));
+			result.phases[SORT].push_back(milliseconds(draw_start - sort_start));
+			result.phases[DRAW].push_back(milliseconds(draw_end - draw_start));
+			result.phases[CPU].push_back(milliseconds(draw_end - start));
+			result.phases[GPU_WAIT].push_back(milliseconds(end - draw_end));
+			result.visible += system.visible().size();
+			result.draw_calls += engine::render::RenderStats::last(engine::render::RenderStats::DRAW_CALLS);
+			result.triangles += engine::render::RenderStats::last(engine::render::RenderStats::TRIANGLES);
+		}
+		engine::render::Framebuffer::unbind();
+		result.visible /= frames;
+		result.draw_calls /= frames;
+		result.triangles /= frames;
+		result.cpu_peak = engine::profile::MemoryTracker::cpu_total().peak;
+		result.gpu_peak = engine::profile::MemoryTracker::gpu_total().peak;
+		
+		engine::Shader::destroyAll();
+		engine::render::Mesh::destroyAll();
+		engine::render::Material::destroyAll();
+		engine::graphics::Texture::destroyAll();
+	}
+	
+	void print(const Result& result) {
+		std::cout << result.scenario.name << "=" << result.scenario.size << ": " << result.objects << " objects, "
+			<< std::fixed << std::setprecision(1) << result.visible << " visible, " << result.draw_calls
+			<< " draw calls, " << std::setprecision(0) << result.triangles << " triangles per frame" << std::endl;
+		std::cout << std::setprecision(3) << "  load ms: shaders " << result.shaders_ms << ", textures "
+			<< result.textures_ms << ", meshes " << result.meshes_ms << ", tree " << result.tree_ms << std::endl;
+		std::cout << "  peak memory: cpu " << result.cpu_peak / 1024 << " KB, gpu " << result.gpu_peak / 1024 << " KB"
+			<< std::endl;
+		for (int i = 0; i < PHASE_COUNT; i++) {
+			Summary s = summarize(result.phases[i]);
+			std::cout << "  " << std::left << std::setw(9) << PHASE_NAMES[i] << std::right << " mean " << std::setw(8)
+				<< s.mean << "  p50 " << std::setw(8) << s.p50 << "  p95 " << std::setw(8) << s.p95 << "  p99 "
+				<< std::setw(8) << s.p99 << "  max " << std::setw(8) << s.max << std::endl;
+		}
+	}
+	
+	std::string escape(const std::string& text) {
+		std::string escaped;
+		for (char c : text) {
+			if (c == '"' || c == '\\') {
+				escaped += '\\';
+			}
+			escaped += c;
+		}
+		return escaped;
+	}
+	
+	bool write_json(const std::string& path, const std::vector<Result>& results, int frames, int width, int height) {
+		std::ofstream file(path);
+		if (!file) {
+			std::cerr << "Failed to write " << path << std::endl;
+			return false;
+		}
+		const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+		file << std::fixed << std::setprecision(4);
+		file << "{\n";
+		file << "  \"renderer\": \"" << escape(renderer ? renderer : "") << "\",\n";
+		file << "  \"frames\": " << frames << ",\n";
+		file << "  \"width\": " << width << ",\n";
+		file << "  \"height\": " << height << ",\n";
+		file << "  \"scenarios\": [\n";
+		for (size_t r = 0; r < results.size(); r++) {
+			const Result& result = results[r];
+			file << "    {\n";
+			file << "      \"name\": \"" << escape(result.scenario.name) << "\",\n";
+			file << "      \"size\": " << result.scenario.size << ",\n";
+			file << "      \"objects\": " << result.objects << ",\n";
+			file << "      \"load_ms\": {\"shaders\": " << result.shaders_ms << ", \"textures\": " << result.textures_ms
+				<< ", \"meshes\": " << result.meshes_ms << ", \"tree\": " << result.tree_ms << "},\n";
+			file << "      \"per_frame\": {\"visible\": " << result.visible << ", \"draw_calls\": " << result.draw_calls
+				<< ", \"triangles\": " << result.triangles << "},\n";
+			file << "      \"peak_bytes\": {\"cpu\": " << result.cpu_peak << ", \"gpu\": " << result.gpu_peak << "},\n";
+			file << "      \"frame_ms\": {\n";
+			for (int i = 0; i < PHASE_COUNT; i++) {
+				Summary s = summarize(result.phases[i]);
+				file << "        \"" << PHASE_NAMES[i] << "\": {\"mean\": " << s.mean << ", \"p50\": " << s.p50
+					<< ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99 << ", \"max\": " << s.max << "}"
+					<< (i + 1 < PHASE_COUNT ? "," : "") << "\n";
+			}
+			file << "      }\n";
+			file << "    }" << (r + 1 < results.size() ? "," : "") << "\n";
+		}
+		file << "  ]\n";
+		file << "}\n";
+		return (bool) file;
+	}
+}
+
+int main(int argc, char** argv) {
+	std::vector<Scenario> scenarios;
+	int frames = 300;
+	int width = 1280;
+	int height = 720;
+	std::string json_path;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+		if (arg == "--frames" && has_value) {
+			frames = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--size" && has_value) {
+			if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+				std::cerr << "Expected --size WIDTHxHEIGHT" << std::endl;
+				return 1;
+			}
+		}
+		else if (arg == "--json" && has_value) {
+			json_path = argv[++i];
+		}
+		else if (arg.rfind("--", 0) != 0) {
+			size_t separator = arg.find('=');
+			Scenario scenario = {arg.substr(0, separator), 0};
+			const Scenario* known = std::find_if(std::begin(DEFAULT_SCENARIOS), std::end(DEFAULT_SCENARIOS),
+				[&](const Scenario& candidate) {
+					return candidate.name == scenario.name;
+				});
+			if (known == std::end(DEFAULT_SCENARIOS)) {
+				std::cerr << "Unknown scenario: " << scenario.name << std::endl;
+				return 1;
+			}
+			scenario.size = known->size;
+			if (separator != std::string::npos) {
+				scenario.size = std::atoi(arg.c_str() + separator + 1);
+			}
+			if (scenario.size <= 0) {
+				std::cerr << "Bad size: " << arg << std::endl;
+				return 1;
+			}
+			scenarios.push_back(scenario);
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " [cubes|transparent|terrain|textures|moving[=size]]... [--frames N]"
+				<< " [--size WxH] [--json path]" << std::endl;
+			return 1;
+		}
+	}
+	if (scenarios.empty()) {
+		scenarios.assign(std::begin(DEFAULT_SCENARIOS), std::end(DEFAULT_SCENARIOS));
+	}
+	
+	if (!glfwInit()) {
+		std::cerr << "Failed to initialize GLFW" << std::endl;
+		return 1;
+	}
+	// The window only provides the context, frames go to an offscreen framebuffer
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow* window = glfwCreateWindow(64, 64, "EngineBench", nullptr, nullptr);
+	if (!window) {
+		std::cerr << "Failed to create a GL context" << std::endl;
+		glfwTerminate();
+		return 1;
+	}
+	glfwMakeContextCurrent(window);
+	GLenum status = glewInit();
+	if (status != GLEW_OK) {
+		std::cerr << "Failed to initialize GLEW: " << glewGetErrorString(status) << std::endl;
+		glfwTerminate();
+		return 1;
+	}
+	
+	engine::render::GLBackend& backend = engine::render::GLBackend::current();
+	backend.enable(GL_DEPTH_TEST);
+	backend.depth_func(GL_LESS);
+	backend.enable(GL_BLEND);
+	backend.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	
+	engine::render::Framebuffer framebuffer = engine::render::Framebuffer::create(width, height);
+	if (!framebuffer.complete()) {
+		glfwTerminate();
+		return 1;
+	}
+	engine::render::CameraUniforms camera_uniforms = engine::render::CameraUniforms::create();
+	engine::render::InstanceRenderer instance_renderer = engine::render::InstanceRenderer::create();
+	// Sized like main.cpp's, it grows for larger scenes
+	engine::render::GeometryArena arena = engine::render::GeometryArena::create(1 << 16, 1 << 18);
+	engine::render::IndirectRenderer indirect_renderer = engine::render::IndirectRenderer::create(arena);
+	
+	std::vector<Result> results(scenarios.size());
+	for (size_t i = 0; i < scenarios.size(); i++) {
+		run(scenarios[i], frames, framebuffer, camera_uniforms, instance_renderer, arena, indirect_renderer,
+			results[i]);
+	}
+	
+	std::cout << std::endl << frames << " frames at " << width << "x" << height << ", times in ms" << std::endl;
+	for (const Result& result : results) {
+		print(result);
+	}
+	bool written = json_path.empty() || write_json(json_path, results, frames, width, height);
+	
+	indirect_renderer.destroy();
+	arena.destroy();
+	instance_renderer.destroy();
+	camera_uniforms.destroy();
+	framebuffer.destroy();
+	glfwTerminate();
+	return written ? 0 : 1;
+}
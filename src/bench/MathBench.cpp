@@ -0,0 +1,320 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <sstream>
+
+#include "../engine/math/Mat4.hpp"
+#include "../engine/math/Vec3.hpp"
+#include "../engine/math/Vec4.hpp"
+#include "../engine/math/Quaternion.hpp"
+#include "../engine/math/AxisAngle.hpp"
+
+// Micro-benchmarks of engine::math in the style of Google Benchmark. Every operation runs over arrays
+// of random inputs at several batch sizes, from one element to working sets larger than the L2 cache,
+// so both latency-bound and memory-bound behaviour of a change to the math types show up.
+// Each case is repeated with doubling iteration counts until it ran for at least the minimum time.
+// Usage: MathBench [--filter substring] [--min-time seconds] [--json path]
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+	
+	const size_t BATCH_SIZES[] = {1, 16, 256, 4096, 65536};
+	constexpr size_t MAX_BATCH = 65536;
+	
+	// Keeps the compiler from dropping stores whose results are never read
+	void clobber(const void* data) {
+#if defined(__GNUC__)
+		asm volatile("" : : "g"(data) : "memory");
+#else
+		static const void* volatile sink;
+		sink = data;
+#endif
+	}
+	
+	struct Inputs {
+		std::vector<engine::math::Mat4> a, b, matrices;
+		std::vector<engine::math::Vec3> v3a, v3b, v3out;
+		std::vector<engine::math::Vec4> v4a, v4b, v4out;
+		std::vector<engine::math::Quaternion> qa, qb, qout;
+		std::vector<engine::math::AxisAngle> axis_angles;
+		std::vector<float> floats;
+		// Object transforms: position, euler rotation and scale
+		std::vector<engine::math::Vec3> positions, rotations, scales;
+	};
+	
+	struct Benchmark {
+		std::string name;
+		// Bytes read and written per operation, for the throughput column
+		size_t bytes;
+		// Runs the operation over the first n elements
+		std::function<void(Inputs&, size_t)> run;
+	};
+	
+	struct Result {
+		std::string name;
+		size_t batch;
+		uint64_t iterations;
+		double ns_per_op;
+		double items_per_second;
+		double bytes_per_second;
+	};
+	
+	void fill(Inputs& in) {
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> value(-10, 10);
+		std::uniform_real_distribution<float> angle(0, 2 * M_PI);
+		std::uniform_real_distribution<float> scale(0.5f, 2);
+		auto vec3 = [&]() {
+			return engine::math::Vec3(value(rng), value(rng), value(rng));
+		};
+		auto mat4 = [&]() {
+			return engine::math::Mat4(value(rng), value(rng), value(rng), value(rng), value(rng), value(rng), value(rng),
+				value(rng), value(rng), value(rng), value(rng), value(rng), value(rng), value(rng), value(rng),
+				value(rng));
+		};
+		for (size_t i = 0; i < MAX_BATCH; i++) {
+			in.a.push_back(mat4());
+			in.b.push_back(mat4());
+			in.v3a.push_back(vec3());
+			in.v3b.push_back(vec3());
+			in.v4a.push_back(engine::math::Vec4(value(rng), value(rng), value(rng), value(rng)));
+			in.v4b.push_back(engine::math::Vec4(value(rng), value(rng), value(rng), value(rng)));
+			in.qa.push_back(engine::math::Quaternion(value(rng), value(rng), value(rng), value(rng)));
+			in.qb.push_back(engine::math::Quaternion(value(rng), value(rng), value(rng), value(rng)));
+			in.axis_angles.push_back(engine::math::AxisAngle(vec3().normalize(), angle(rng)));
+			
+			in.positions.push_back(vec3());
+			in.rotations.push_back(engine::math::Vec3(angle(rng), angle(rng), angle(rng)));
+			in.scales.push_back(engine::math::Vec3(scale(rng), scale(rng), scale(rng)));
+		}
+		in.matrices.resize(MAX_BATCH);
+		in.v3out.resize(MAX_BATCH);
+		in.v4out.resize(MAX_BATCH);
+		in.qout.resize(MAX_BATCH);
+		in.floats.resize(MAX_BATCH);
+	}
+	
+	std::vector<Benchmark> benchmarks() {
+		using engine::math::Mat4;
+		using engine::math::Vec3;
+		using engine::math::Vec4;
+		using engine::math::Quaternion;
+		using engine::math::AxisAngle;
+		return {
+			{"Mat4Multiply", 3 * sizeof(Mat4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.matrices[i] = in.a[i] * in.b[i];
+				}
+			}},
+			{"Mat4Inverse", 2 * sizeof(Mat4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.matrices[i] = in.a[i].inverse();
+				}
+			}},
+			{"Mat4Determinant", sizeof(Mat4) + sizeof(float), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.floats[i] = in.a[i].determinant();
+				}
+			}},
+			{"Mat4MultiplyVec4", sizeof(Mat4) + 2 * sizeof(Vec4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.v4out[i] = in.a[i] * in.v4a[i];
+				}
+			}},
+			{"Mat4Perspective", sizeof(Vec3) + sizeof(Mat4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					const Vec3& p = in.v3a[i];
+					in.matrices[i] = Mat4::perspective(1 + std::abs(p.x()) * 0.1f, 1 + std::abs(p.y()), 0.1f,
+						100 + std::abs(p.z()));
+				}
+			}},
+			{"Mat4LookAt", 2 * sizeof(Vec3) + sizeof(Mat4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.matrices[i] = Mat4::lookAt(in.v3a[i], in.v3b[i], Vec3::UNIT_Y);
+				}
+			}},
+			{"Vec3Add", 3 * sizeof(Vec3), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.v3out[i] = in.v3a[i] + in.v3b[i];
+				}
+			}},
+			{"Vec3Dot", 2 * sizeof(Vec3) + sizeof(float), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.floats[i] = in.v3a[i].dot(in.v3b[i]);
+				}
+			}},
+			{"Vec3Cross", 3 * sizeof(Vec3), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.v3out[i] = in.v3a[i].cross(in.v3b[i]);
+				}
+			}},
+			{"Vec3Normalize", 2 * sizeof(Vec3), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.v3out[i] = in.v3a[i].normalize();
+				}
+			}},
+			{"Vec4Add", 3 * sizeof(Vec4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.v4out[i] = in.v4a[i] + in.v4b[i];
+				}
+			}},
+			{"Vec4Dot", 2 * sizeof(Vec4) + sizeof(float), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.floats[i] = in.v4a[i].dot(in.v4b[i]);
+				}
+			}},
+			{"Vec4Normalize", 2 * sizeof(Vec4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.v4out[i] = in.v4a[i].normalize();
+				}
+			}},
+			{"QuaternionMultiply", 3 * sizeof(Quaternion), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.qout[i] = in.qa[i] * in.qb[i];
+				}
+			}},
+			{"QuaternionToMatrix", sizeof(Quaternion) + sizeof(Mat4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.matrices[i] = in.qa[i].toMatrix();
+				}
+			}},
+			{"AxisAngleToMatrix", sizeof(AxisAngle) + sizeof(Mat4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.matrices[i] = in.axis_angles[i].toMatrix();
+				}
+			}},
+			// Three axis rotations, scale and translation multiplied together, the same products as
+			// Object::model() of an object without a scene graph node
+			{"ObjectModel", 3 * sizeof(Vec3) + sizeof(Mat4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					const Vec3& rotation = in.rotations[i];
+					Mat4 rot_x = Mat4::rotation(rotation.x(), Vec3::UNIT_X);
+					Mat4 rot_y = Mat4::rotation(rotation.y(), Vec3::UNIT_Y);
+					Mat4 rot_z = Mat4::rotation(rotation.z(), Vec3::UNIT_Z);
+					in.matrices[i] = Mat4::translation(in.positions[i]) * (rot_x * rot_y * rot_z) *
+						Mat4::scale(in.scales[i]);
+				}
+			}},
+			// The same matrix built in one step, for comparison with ObjectModel
+			{"Mat4Transform", 3 * sizeof(Vec3) + sizeof(Mat4), [](Inputs& in, size_t n) {
+				for (size_t i = 0; i < n; i++) {
+					in.matrices[i] = Mat4::transform(in.positions[i], in.rotations[i], in.scales[i]);
+				}
+			}}
+		};
+	}
+	
+	Result measure(const Benchmark& benchmark, Inputs& in, size_t batch, double min_time) {
+		// Once untimed, so the first timed pass doesn't pay for cold caches and page faults
+		benchmark.run(in, batch);
+		uint64_t iterations = 1;
+		double seconds = 0;
+		while (true) {
+			Clock::time_point start = Clock::now();
+			for (uint64_t i = 0; i < iterations; i++) {
+				benchmark.run(in, batch);
+				clobber(&in);
+			}
+			seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			if (seconds >= min_time || iterations >= (1ull << 40)) {
+				break;
+			}
+			// Aim straight for the minimum time once a run is long enough to extrapolate from
+			uint64_t next = seconds > min_time / 100 ? (uint64_t) (iterations * min_time * 1.4 / seconds) : iterations * 10;
+			iterations = std::max(iterations * 2, next);
+		}
+		double ops = (double) iterations * batch;
+		return {benchmark.name, batch, iterations, seconds * 1e9 / ops, ops / seconds, ops * benchmark.bytes / seconds};
+	}
+	
+	std::string human(double value, const char* unit) {
+		const char* prefixes[] = {"", "k", "M", "G", "T"};
+		int prefix = 0;
+		while (value >= 1000 && prefix < 4) {
+			value /= 1000;
+			prefix++;
+		}
+		std::ostringstream text;
+		text << std::fixed << std::setprecision(value < 10 ? 2 : value < 100 ? 1 : 0) << value << prefixes[prefix]
+			<< unit;
+		return text.str();
+	}
+	
+	bool write_json(const std::string& path, const std::vector<Result>& results) {
+		std::ofstream file(path);
+		if (!file) {
+			std::cerr << "Failed to write " << path << std::endl;
+			return false;
+		}
+		file << "{\n  \"benchmarks\": [\n";
+		for (size_t i = 0; i < results.size(); i++) {
+			const Result& r = results[i];
+			file << "    {\"name\": \"" << r.name << "/" << r.batch << "\", \"batch\": " << r.batch << ", \"iterations\": "
+				<< r.iterations << std::fixed << std::setprecision(4) << ", \"ns_per_op\": " << r.ns_per_op
+				<< std::setprecision(0) << ", \"items_per_second\": " << r.items_per_second
+				<< ", \"bytes_per_second\": " << r.bytes_per_second << "}" << (i + 1 < results.size() ? "," : "")
+				<< "\n";
+		}
+		file << "  ]\n}\n";
+		return (bool) file;
+	}
+}
+
+int main(int argc, char** argv) {
+	std::string filter;
+	double min_time = 0.2;
+	std::string json_path;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--filter" && i + 1 < argc) {
+			filter = argv[++i];
+		}
+		else if (arg == "--min-time" && i + 1 < argc) {
+			min_time = std::atof(argv[++i]);
+		}
+		else if (arg == "--json" && i + 1 < argc) {
+			json_path = argv[++i];
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " [--filter substring] [--min-time seconds] [--json path]" << std::endl;
+			return 1;
+		}
+	}
+	
+	Inputs in;
+	fill(in);
+	
+	std::string line(78, '-');
+	std::cout << line << std::endl << std::left << std::setw(28) << "Benchmark" << std::right << std::setw(12)
+		<< "ns/op" << std::setw(14) << "Iterations" << std::setw(12) << "items/s" << std::setw(12) << "bytes/s"
+		<< std::endl << line << std::endl;
+	std::vector<Result> results;
+	for (const Benchmark& benchmark : benchmarks()) {
+		for (size_t batch : BATCH_SIZES) {
+			std::string name = benchmark.name + "/" + std::to_string(batch);
+			if (name.find(filter) == std::string::npos) {
+				continue;
+			}
+			Result result = measure(benchmark, in, batch, min_time);
+			std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+				<< std::setw(12) << result.ns_per_op << std::setw(14) << result.iterations << std::setw(12)
+				<< human(result.items_per_second, "/s") << std::setw(12) << human(result.bytes_per_second, "B/s")
+				<< std::endl;
+			results.push_back(result);
+		}
+	}
+	
+	if (!json_path.empty() && !write_json(json_path, results)) {
+		return 1;
+	}
+	return 0;
+}
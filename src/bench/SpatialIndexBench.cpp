@@ -0,0 +1,264 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+#include "../engine/math/Mat4.hpp"
+#include "../engine/math/Frustum.hpp"
+#include "../engine/math/Sphere.hpp"
+#include "../engine/object/Object.hpp"
+#include "../engine/scene/HashGrid.hpp"
+#include "../engine/scene/DynamicBVH.hpp"
+#include "../engine/scene/StaticBVH.hpp"
+
+// Compares the hashed grid and the dynamic BVH with testing every object, for a scene where everything
+// moves each frame, then the static BVH with testing every object once the objects have stopped.
+// Usage: SpatialIndexBench [object count] [frames] [cell size], e.g. SpatialIndexBench 1000000 for 1M objects
+
+namespace {
+	constexpr float WORLD_SIZE = 1000;
+	constexpr float NEIGHBOUR_RADIUS = 10;
+	constexpr int NEIGHBOUR_QUERIES = 100;
+	
+	using Clock = std::chrono::steady_clock;
+	
+	double milliseconds(Clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+	
+	// The bench objects have no mesh, a unit sphere scaled by the largest axis stands in for it
+	engine::math::Sphere bounds(const engine::object::Object& obj) {
+		const engine::math::Vec3& scale = obj.scale();
+		return engine::math::Sphere(obj.position(), std::max({scale.x(), scale.y(), scale.z()}));
+	}
+	engine::math::AABB box(const engine::object::Object& obj) {
+		engine::math::Sphere sphere = bounds(obj);
+		engine::math::Vec3 extent(sphere.radius());
+		return engine::math::AABB(sphere.center() - extent, sphere.center() + extent);
+	}
+	
+	// The trees return candidates by box, the exact test against the sphere is part of the query
+	template<typename Volume>
+	size_t count_exact(const Volume& volume, const std::vector<engine::object::Object>& objects,
+		const std::vector<uint32_t>& candidates) {
+		size_t found = 0;
+		for (uint32_t index : candidates) {
+			found += volume.intersects(bounds(objects[index]));
+		}
+		return found;
+	}
+	
+	struct Timings {
+		double update = 0;
+		double frustum = 0;
+		double neighbours = 0;
+		size_t visible = 0;
+		size_t found = 0;
+	};
+	
+	void print(const std::string& name, const Timings& timings, int frames) {
+		std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(12) << timings.update / frames
+			<< std::setw(12) << timings.frustum / frames
+			<< std::setw(16) << timings.neighbours / frames
+			<< std::setw(12) << timings.visible / frames
+			<< std::setw(12) << timings.found / frames << std::endl;
+	}
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::stoul(argv[1]) : 100000;
+	int frames = argc > 2 ? std::stoi(argv[2]) : 60;
+	float cellSize = argc > 3 ? std::stof(argv[3]) : 32;
+	
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> position(-WORLD_SIZE / 2, WORLD_SIZE / 2);
+	std::uniform_real_distribution<float> scale(0.5f, 2);
+	std::uniform_real_distribution<float> step(-1, 1);
+	
+	std::vector<engine::object::Object> objects(count);
+	for (auto& obj : objects) {
+		obj.position() = engine::math::Vec3(position(rng), position(rng) * 0.1f, position(rng));
+		obj.scale() = engine::math::Vec3(scale(rng));
+	}
+	std::vector<engine::math::Vec3> velocities(count);
+	for (auto& velocity : velocities) {
+		velocity = engine::math::Vec3(step(rng), 0, step(rng));
+	}
+	std::vector<engine::math::Vec3> probes(NEIGHBOUR_QUERIES);
+	for (auto& probe : probes) {
+		probe = engine::math::Vec3(position(rng), 0, position(rng));
+	}
+	
+	engine::scene::HashGrid grid(cellSize);
+	std::vector<int> handles(count);
+	Clock::time_point start = Clock::now();
+	for (size_t i = 0; i < count; i++) {
+		handles[i] = grid.insert(bounds(objects[i]), static_cast<uint32_t>(i));
+	}
+	double build = milliseconds(Clock::now() - start);
+	
+	engine::scene::DynamicBVH tree;
+	std::vector<int> proxies(count);
+	start = Clock::now();
+	for (size_t i = 0; i < count; i++) {
+		proxies[i] = tree.insert(box(objects[i]), static_cast<uint32_t>(i));
+	}
+	double treeBuild = milliseconds(Clock::now() - start);
+	float buildCost = tree.cost();
+	
+	engine::math::Mat4 projection = engine::math::Mat4::perspective(1.2f, 16.0f / 9, 0.1f, 300);
+	Timings brute;
+	Timings hashed;
+	Timings dynamic;
+	std::vector<uint32_t> values;
+	values.reserve(count);
+	for (int frame = 0; frame < frames; frame++) {
+		float angle = frame * 0.05f;
+		engine::math::Mat4 view = engine::math::Mat4::lookAt(engine::math::Vec3(0, 5, 0),
+			engine::math::Vec3(std::cos(angle), 5, std::sin(angle)), engine::math::Vec3(0, 1, 0));
+		engine::math::Frustum frustum(projection * view);
+		
+		// Moving the objects is shared, only the grid has to be told about it
+		for (size_t i = 0; i < count; i++) {
+			objects[i].position() += velocities[i];
+		}
+		start = Clock::now();
+		for (size_t i = 0; i < count; i++) {
+			grid.move(handles[i], bounds(objects[i]));
+		}
+		hashed.update += milliseconds(Clock::now() - start);
+		start = Clock::now();
+		for (size_t i = 0; i < count; i++) {
+			tree.move(proxies[i], box(objects[i]), velocities[i]);
+		}
+		tree.rebalance();
+		dynamic.update += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		for (const auto& obj : objects) {
+			brute.visible += frustum.intersects(bounds(obj));
+		}
+		brute.frustum += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		values.clear();
+		grid.query(frustum, values);
+		hashed.visible += values.size();
+		hashed.frustum += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		values.clear();
+		tree.query(frustum, values);
+		dynamic.visible += count_exact(frustum, objects, values);
+		dynamic.frustum += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		for (const auto& probe : probes) {
+			engine::math::Sphere sphere(probe, NEIGHBOUR_RADIUS);
+			for (const auto& obj : objects) {
+				brute.found += sphere.intersects(bounds(obj));
+			}
+		}
+		brute.neighbours += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		for (const auto& probe : probes) {
+			values.clear();
+			grid.query(engine::math::Sphere(probe, NEIGHBOUR_RADIUS), values);
+			hashed.found += values.size();
+		}
+		hashed.neighbours += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		for (const auto& probe : probes) {
+			engine::math::Sphere sphere(probe, NEIGHBOUR_RADIUS);
+			values.clear();
+			tree.query(sphere, values);
+			dynamic.found += count_exact(sphere, objects, values);
+		}
+		dynamic.neighbours += milliseconds(Clock::now() - start);
+	}
+	
+	// The same queries once nothing moves any more, against a tree built for the final positions
+	std::vector<engine::scene::StaticBVH::Item> items(count);
+	for (size_t i = 0; i < count; i++) {
+		items[i] = {box(objects[i]), static_cast<uint32_t>(i)};
+	}
+	start = Clock::now();
+	engine::scene::StaticBVH staticTree = engine::scene::StaticBVH::build(std::move(items));
+	double staticBuild = milliseconds(Clock::now() - start);
+	Timings staticBrute;
+	Timings fixed;
+	for (int frame = 0; frame < frames; frame++) {
+		float angle = frame * 0.05f;
+		engine::math::Mat4 view = engine::math::Mat4::lookAt(engine::math::Vec3(0, 5, 0),
+			engine::math::Vec3(std::cos(angle), 5, std::sin(angle)), engine::math::Vec3(0, 1, 0));
+		engine::math::Frustum frustum(projection * view);
+		
+		start = Clock::now();
+		for (const auto& obj : objects) {
+			staticBrute.visible += frustum.intersects(bounds(obj));
+		}
+		staticBrute.frustum += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		values.clear();
+		staticTree.query(frustum, values);
+		fixed.visible += count_exact(frustum, objects, values);
+		fixed.frustum += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		for (const auto& probe : probes) {
+			engine::math::Sphere sphere(probe, NEIGHBOUR_RADIUS);
+			for (const auto& obj : objects) {
+				staticBrute.found += sphere.intersects(bounds(obj));
+			}
+		}
+		staticBrute.neighbours += milliseconds(Clock::now() - start);
+		
+		start = Clock::now();
+		for (const auto& probe : probes) {
+			engine::math::Sphere sphere(probe, NEIGHBOUR_RADIUS);
+			values.clear();
+			staticTree.query(sphere, values);
+			fixed.found += count_exact(sphere, objects, values);
+		}
+		fixed.neighbours += milliseconds(Clock::now() - start);
+	}
+	
+	std::cout << count << " objects, " << frames << " frames, " << grid.cell_count() << " occupied cells, built in "
+		<< std::fixed << std::setprecision(3) << build << " ms, dynamic BVH built in " << treeBuild
+		<< " ms, static BVH built in " << staticBuild << " ms" << std::endl;
+	std::cout << "Average per frame in ms, " << NEIGHBOUR_QUERIES << " neighbour queries of radius "
+		<< NEIGHBOUR_RADIUS << std::endl;
+	std::cout << std::left << std::setw(12) << "" << std::right << std::setw(12) << "update" << std::setw(12)
+		<< "frustum" << std::setw(16) << "neighbours" << std::setw(12) << "visible" << std::setw(12) << "found"
+		<< std::endl;
+	print("brute force", brute, frames);
+	print("hash grid", hashed, frames);
+	print("dynamic bvh", dynamic, frames);
+	std::cout << "Dynamic BVH cost " << buildCost << " after the build, " << tree.cost() << " after moving, height "
+		<< tree.height() << std::endl;
+	std::cout << "After the objects stopped moving" << std::endl;
+	print("brute force", staticBrute, frames);
+	print("static bvh", fixed, frames);
+	
+	if (brute.visible != hashed.visible || brute.found != hashed.found) {
+		std::cerr << "Results differ between brute force and the hash grid" << std::endl;
+		return 1;
+	}
+	if (brute.visible != dynamic.visible || brute.found != dynamic.found) {
+		std::cerr << "Results differ between brute force and the dynamic BVH" << std::endl;
+		return 1;
+	}
+	if (staticBrute.visible != fixed.visible || staticBrute.found != fixed.found) {
+		std::cerr << "Results differ between brute force and the static BVH" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -4,6 +4,8 @@
 #include <GLFW/glfw3.h>
 #include <cmath>
 
+#include "profile/Profiler.hpp"
+
 static const float DEFAULT_FOV = 60.0f;
 static const float DEFAULT_ASPECT_RATIO = 1.0f;
 static const float DEFAULT_NEAR_CLIP = 0.1f;
@@ -65,19 +67,30 @@ namespace engine {
 		m_last_mouse_pos = math::Vec2(x, y);
 	}
 	
-	void Camera::update(std::chrono::milliseconds delta_time) {
-		math::Vec2 mp;
+	void Camera::update(std::chrono::nanoseconds delta_time) {
+		update(poll_input(), delta_time);
+	}
+	void Camera::update(const Input& input, std::chrono::nanoseconds delta_time) {
+		PROFILE_SCOPE("Camera::update");
+		math::Vec2 md = input.mouse - m_last_mouse_pos;
+		m_last_mouse_pos = input.mouse;
+		
+		rotate(math::Vec3(md.y(), md.x(), 0) * 0.01f);
+		
+		math::Mat4 rotation_y = rot_y_matrix();
+		math::Vec3 movement = input.movement * rotation_y;
+		float seconds = std::chrono::duration<float>(delta_time).count();
+		move(movement * (MOVE_SPEED * seconds));
+	}
+	
+	Camera::Input Camera::poll_input() {
+		Input input;
 		{
 			double x, y;
 			glfwGetCursorPos(glfwGetCurrentContext(), &x, &y);
-			mp = math::Vec2(x, y);
+			input.mouse = math::Vec2(x, y);
 		}
 		
-		math::Vec2 md = mp - m_last_mouse_pos;
-		m_last_mouse_pos = mp;
-		
-		rotate(math::Vec3(md.y(), md.x(), 0) * 0.01f);
-		
 		math::Vec3 movement;
 		if (glfwGetKey(glfwGetCurrentContext(), GLFW_KEY_W) == GLFW_PRESS)
 			movement -= math::Vec3::UNIT_Z;
@@ -91,10 +104,14 @@ namespace engine {
 			movement += math::Vec3::UNIT_Y;
 		if (glfwGetKey(glfwGetCurrentContext(), GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
 			movement -= math::Vec3::UNIT_Y;
-		
-		math::Mat4 rotation_y = rot_y_matrix();
-		movement = movement * rotation_y;
-		move(movement * 0.1f);
+		input.movement = movement;
+		return input;
+	}
+	Camera Camera::interpolate(const Camera& previous, const Camera& current, float alpha) {
+		Camera camera = current;
+		camera.m_position = previous.m_position.lerp(current.m_position, alpha);
+		camera.m_rotation = previous.m_rotation.lerp(current.m_rotation, alpha);
+		return camera;
 	}
 	
 	float Camera::fov() const {
@@ -148,6 +165,10 @@ namespace engine {
 		return rotation_matrix * translation_matrix;
 	}
 	
+	math::Frustum Camera::frustum() const {
+		return math::Frustum(projection_matrix() * view_matrix());
+	}
+	
 	math::Mat4 Camera::trans_matrix() const {
 		return math::Mat4::translation(-m_position);
 	}
@@ -3,6 +3,7 @@
 #include "math/Vec3.hpp"
 #include "math/Mat4.hpp"
 #include "math/Vec2.hpp"
+#include "math/Frustum.hpp"
 #include <ostream>
 #include <string>
 #include <chrono>
@@ -10,6 +11,19 @@
 namespace engine {
 	
 	class Camera {
+	public:
+		// Units per second
+		static constexpr float MOVE_SPEED = 6.0f;
+		
+		/**
+		 * Input for one update, sampled on the thread that owns the window.
+		 */
+		struct Input {
+			math::Vec2 mouse;
+			// Requested direction in camera space, each axis -1, 0 or 1
+			math::Vec3 movement;
+		};
+	
 	private:
 		// Static Camera properties
 		float m_fov;
@@ -45,7 +59,21 @@ namespace engine {
 		math::Vec3& rotation();
 		
 		void reset_mouse_pos();
-		void update(std::chrono::milliseconds delta_time);
+		void update(std::chrono::nanoseconds delta_time);
+		/**
+		 * Turns by the mouse movement since the last update and moves at MOVE_SPEED for delta_time.
+		 * Doesn't touch GLFW, so it can run on another thread than the window.
+		 */
+		void update(const Input& input, std::chrono::nanoseconds delta_time);
+		
+		/**
+		 * Reads the cursor and movement keys of the current context. GLFW allows this only on the main thread.
+		 */
+		static Input poll_input();
+		/**
+		 * Position and rotation blended from previous (alpha 0) to current (alpha 1), the rest from current.
+		 */
+		static Camera interpolate(const Camera& previous, const Camera& current, float alpha);
 		
 		float fov() const;
 		float aspect_ratio() const;
@@ -63,6 +91,10 @@ namespace engine {
 		
 		math::Mat4 projection_matrix() const;
 		math::Mat4 view_matrix() const;
+		/**
+		 * Planes of projection_matrix() * view_matrix(), in world space.
+		 */
+		math::Frustum frustum() const;
 	private:
 		math::Mat4 trans_matrix() const;
 		math::Mat4 rot_x_matrix() const;
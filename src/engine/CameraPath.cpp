@@ -0,0 +1,72 @@
+#include "CameraPath.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+namespace engine {
+	CameraPath::CameraPath(const std::vector<Keyframe>& keyframes) : m_keyframes(keyframes) {
+		std::stable_sort(m_keyframes.begin(), m_keyframes.end(), [](const Keyframe& a, const Keyframe& b) {
+			return a.time < b.time;
+		});
+	}
+	
+	CameraPath CameraPath::load(const std::string& path) {
+		std::ifstream file(path);
+		if (!file) {
+			std::cerr << "Failed to open camera path: " << path << std::endl;
+			return CameraPath();
+		}
+		
+		std::vector<Keyframe> keyframes;
+		std::string line;
+		int number = 0;
+		while (std::getline(file, line)) {
+			number++;
+			size_t start = line.find_first_not_of(" \t\r");
+			if (start == std::string::npos || line[start] == '#') {
+				continue;
+			}
+			std::istringstream stream(line);
+			float time, x, y, z, pitch, yaw, roll;
+			if (!(stream >> time >> x >> y >> z >> pitch >> yaw >> roll)) {
+				std::cerr << path << ":" << number << ": expected time, position and rotation" << std::endl;
+				continue;
+			}
+			keyframes.push_back({time, math::Vec3(x, y, z), math::Vec3(pitch, yaw, roll)});
+		}
+		return CameraPath(keyframes);
+	}
+	
+	void CameraPath::apply(Camera& camera, float time) const {
+		if (m_keyframes.empty()) {
+			return;
+		}
+		// First keyframe after the time
+		auto next = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), time, [](float t, const Keyframe& keyframe) {
+			return t < keyframe.time;
+		});
+		if (next == m_keyframes.begin() || next == m_keyframes.end()) {
+			const Keyframe& keyframe = next == m_keyframes.begin() ? m_keyframes.front() : m_keyframes.back();
+			camera.set_position(keyframe.position);
+			camera.set_rotation(keyframe.rotation);
+			return;
+		}
+		const Keyframe& a = *(next - 1);
+		const Keyframe& b = *next;
+		float t = (time - a.time) / (b.time - a.time);
+		camera.set_position(a.position.lerp(b.position, t));
+		camera.set_rotation(a.rotation.lerp(b.rotation, t));
+	}
+	
+	float CameraPath::duration() const {
+		return m_keyframes.empty() ? 0 : m_keyframes.back().time;
+	}
+	bool CameraPath::empty() const {
+		return m_keyframes.empty();
+	}
+	const std::vector<CameraPath::Keyframe>& CameraPath::keyframes() const {
+		return m_keyframes;
+	}
+} // engine
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Camera.hpp"
+#include "math/Vec3.hpp"
+
+namespace engine {
+	
+	/**
+	 * Keyframed camera position and rotation over time, for replaying the same camera motion in
+	 * every run. Between keyframes both are interpolated linearly; before the first and after the
+	 * last the path holds still.
+	 *
+	 * The file format is one keyframe per line, sorted by time; empty lines and lines starting with
+	 * '#' are skipped:
+	 *
+	 *     # seconds  x y z  pitch yaw roll (radians)
+	 *     0          0 0 5  0 0 0
+	 *     2.5        3 1 5  0 0.8 0
+	 */
+	class CameraPath {
+	public:
+		struct Keyframe {
+			float time;
+			math::Vec3 position;
+			math::Vec3 rotation;
+		};
+	
+	private:
+		std::vector<Keyframe> m_keyframes;
+	
+	public:
+		CameraPath() = default;
+		explicit CameraPath(const std::vector<Keyframe>& keyframes);
+		
+		CameraPath(const CameraPath& other) = default;
+		CameraPath(CameraPath&& other) noexcept = default;
+		CameraPath& operator=(const CameraPath& other) = default;
+		CameraPath& operator=(CameraPath&& other) noexcept = default;
+		~CameraPath() = default;
+		
+		/**
+		 * Reads a path file. Reports malformed lines and returns an empty path if the file can't be read.
+		 */
+		static CameraPath load(const std::string& path);
+		
+		/**
+		 * Moves the camera to where the path is at the given time in seconds.
+		 */
+		void apply(Camera& camera, float time) const;
+		
+		/**
+		 * Time of the last keyframe.
+		 */
+		float duration() const;
+		bool empty() const;
+		const std::vector<Keyframe>& keyframes() const;
+	};
+	
+} // engine
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace engine::ecs {
+	
+	/**
+	 * Handle to an entity in a Registry. The generation tells a destroyed entity apart from a
+	 * newer one that reused its index.
+	 */
+	struct Entity {
+		uint32_t index;
+		uint32_t generation;
+		
+		bool operator==(const Entity& other) const = default;
+	};
+	
+	constexpr Entity NULL_ENTITY = {0xFFFFFFFF, 0};
+	
+} // engine::ecs
@@ -0,0 +1,30 @@
+#include "Prefabs.hpp"
+
+#include <cmath>
+
+namespace engine::ecs {
+	int Prefabs::add_cube(Registry& registry, scene::SceneGraph& graph, const render::Mesh& mesh,
+		const math::Vec3& position, const render::Material* material, float alpha) {
+		struct Face {
+			math::Vec3 position;
+			math::Vec3 rotation;
+			math::Vec3 color;
+		};
+		static const Face FACES[] = {
+			{math::Vec3(0, 0, 1),  math::Vec3(0, 0, 0),          math::Vec3(1, 0, 0)},
+			{math::Vec3(0, 0, -1), math::Vec3(0, M_PI, 0),       math::Vec3(1, 0, 0)},
+			{math::Vec3(-1, 0, 0), math::Vec3(0, -M_PI / 2, 0),  math::Vec3(0, 1, 0)},
+			{math::Vec3(1, 0, 0),  math::Vec3(0, M_PI / 2, 0),   math::Vec3(0, 1, 0)},
+			{math::Vec3(0, 1, 0),  math::Vec3(-M_PI / 2, 0, 0),  math::Vec3(0, 0, 1)},
+			{math::Vec3(0, -1, 0), math::Vec3(M_PI / 2, 0, 0),   math::Vec3(0, 0, 1)}
+		};
+		int cube = graph.create(scene::SceneGraph::NONE, position);
+		for (const Face& face : FACES) {
+			Entity entity = registry.create();
+			registry.add_transform(entity, face.position, face.rotation);
+			registry.node(entity, graph, cube);
+			registry.add_render(entity, mesh, material, math::Vec4(face.color, alpha));
+		}
+		return cube;
+	}
+} // engine::ecs
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Registry.hpp"
+#include "../math/Vec3.hpp"
+#include "../object/Mesh.hpp"
+#include "../scene/SceneGraph.hpp"
+
+namespace engine::ecs {
+	
+	/**
+	 * Builds common groups of entities.
+	 */
+	class Prefabs {
+	public:
+		/**
+		 * Six copies of a square mesh spanning [-1, 1] in x and y, as the faces of a cube around a new
+		 * scene graph node at the position; colored red, green and blue per axis. The faces are placed
+		 * relative to the node, so the whole cube moves with it.
+		 * @return the cube's node
+		 */
+		static int add_cube(Registry& registry, scene::SceneGraph& graph, const render::Mesh& mesh,
+			const math::Vec3& position, const render::Material* material = nullptr, float alpha = 1);
+	};
+	
+} // engine::ecs
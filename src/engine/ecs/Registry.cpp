@@ -0,0 +1,248 @@
+#include "Registry.hpp"
+
+#include <iostream>
+
+#include "../jobs/JobSystem.hpp"
+
+namespace engine::ecs {
+	Registry::Registry()
+		: m_generations(), m_free_indices(), m_alive(0), m_transform_set(), m_positions(), m_rotations(), m_scales(),
+		m_world(), m_nodes(), m_graph(nullptr), m_render_set(), m_render_transforms(), m_meshes(), m_materials(),
+		m_albedos(), m_memory(profile::MemoryTracker::OBJECTS, 0) {
+	}
+	
+	Entity Registry::create() {
+		uint32_t index;
+		if (m_free_indices.empty()) {
+			index = static_cast<uint32_t>(m_generations.size());
+			m_generations.push_back(0);
+		}
+		else {
+			index = m_free_indices.back();
+			m_free_indices.pop_back();
+		}
+		m_alive++;
+		track();
+		return {index, m_generations[index]};
+	}
+	void Registry::destroy(Entity entity) {
+		if (!alive(entity)) {
+			return;
+		}
+		if (has_transform(entity)) {
+			remove_transform(entity);
+		}
+		m_generations[entity.index]++;
+		m_free_indices.push_back(entity.index);
+		m_alive--;
+		track();
+	}
+	bool Registry::alive(Entity entity) const {
+		return entity.index < m_generations.size() && m_generations[entity.index] == entity.generation;
+	}
+	size_t Registry::size() const {
+		return m_alive;
+	}
+	void Registry::clear() {
+		*this = Registry();
+	}
+	
+	void Registry::add_transform(Entity entity, const math::Vec3& position, const math::Vec3& rotation,
+		const math::Vec3& scale) {
+		if (has_transform(entity)) {
+			uint32_t index = transform_index(entity);
+			m_positions[index] = position;
+			m_rotations[index] = rotation;
+			m_scales[index] = scale;
+			m_world[index] = compute_world(index);
+			return;
+		}
+		m_transform_set.insert(entity.index);
+		m_positions.push_back(position);
+		m_rotations.push_back(rotation);
+		m_scales.push_back(scale);
+		m_world.push_back(math::Mat4::transform(position, rotation, scale));
+		m_nodes.push_back(scene::SceneGraph::NONE);
+		track();
+	}
+	void Registry::remove_transform(Entity entity) {
+		if (has_render(entity)) {
+			remove_render(entity);
+		}
+		uint32_t slot = m_transform_set.erase(entity.index);
+		// Mirror the swap done by the sparse set
+		m_positions[slot] = m_positions.back();
+		m_rotations[slot] = m_rotations.back();
+		m_scales[slot] = m_scales.back();
+		m_world[slot] = m_world.back();
+		m_nodes[slot] = m_nodes.back();
+		m_positions.pop_back();
+		m_rotations.pop_back();
+		m_scales.pop_back();
+		m_world.pop_back();
+		m_nodes.pop_back();
+		
+		// The entity moved into the slot may have a render component pointing at its old index
+		if (slot < m_transform_set.size()) {
+			uint32_t moved = m_transform_set.entities()[slot];
+			uint32_t render = m_render_set.index(moved);
+			if (render != SparseSet::NONE) {
+				m_render_transforms[render] = slot;
+			}
+		}
+	}
+	bool Registry::has_transform(Entity entity) const {
+		return alive(entity) && m_transform_set.contains(entity.index);
+	}
+	
+	const math::Vec3& Registry::position(Entity entity) const {
+		return m_positions[transform_index(entity)];
+	}
+	const math::Vec3& Registry::rotation(Entity entity) const {
+		return m_rotations[transform_index(entity)];
+	}
+	const math::Vec3& Registry::scale(Entity entity) const {
+		return m_scales[transform_index(entity)];
+	}
+	const math::Mat4& Registry::world(Entity entity) const {
+		return m_world[transform_index(entity)];
+	}
+	math::Vec3& Registry::position(Entity entity) {
+		return m_positions[transform_index(entity)];
+	}
+	math::Vec3& Registry::rotation(Entity entity) {
+		return m_rotations[transform_index(entity)];
+	}
+	math::Vec3& Registry::scale(Entity entity) {
+		return m_scales[transform_index(entity)];
+	}
+	void Registry::node(Entity entity, const scene::SceneGraph& graph, int node) {
+		if (m_graph != nullptr && m_graph != &graph) {
+			std::cerr << "Registry is attached to another scene graph (entity " << entity.index << ")" << std::endl;
+			return;
+		}
+		m_graph = &graph;
+		uint32_t index = transform_index(entity);
+		m_nodes[index] = node;
+		m_world[index] = compute_world(index);
+	}
+	int Registry::node(Entity entity) const {
+		return m_nodes[transform_index(entity)];
+	}
+	
+	void Registry::add_render(Entity entity, const render::Mesh& mesh, const render::Material* material,
+		const math::Vec4& albedo) {
+		if (!has_transform(entity)) {
+			std::cerr << "Render component needs a transform (entity " << entity.index << ")" << std::endl;
+			return;
+		}
+		if (has_render(entity)) {
+			uint32_t index = render_index(entity);
+			m_meshes[index] = &mesh;
+			m_materials[index] = material;
+			m_albedos[index] = albedo;
+			return;
+		}
+		m_render_set.insert(entity.index);
+		m_render_transforms.push_back(transform_index(entity));
+		m_meshes.push_back(&mesh);
+		m_materials.push_back(material);
+		m_albedos.push_back(albedo);
+		track();
+	}
+	void Registry::remove_render(Entity entity) {
+		uint32_t slot = m_render_set.erase(entity.index);
+		m_render_transforms[slot] = m_render_transforms.back();
+		m_meshes[slot] = m_meshes.back();
+		m_materials[slot] = m_materials.back();
+		m_albedos[slot] = m_albedos.back();
+		m_render_transforms.pop_back();
+		m_meshes.pop_back();
+		m_materials.pop_back();
+		m_albedos.pop_back();
+	}
+	bool Registry::has_render(Entity entity) const {
+		return alive(entity) && m_render_set.contains(entity.index);
+	}
+	
+	const render::Material* Registry::material(Entity entity) const {
+		return m_materials[render_index(entity)];
+	}
+	const math::Vec4& Registry::albedo(Entity entity) const {
+		return m_albedos[render_index(entity)];
+	}
+	void Registry::material(Entity entity, const render::Material* material) {
+		m_materials[render_index(entity)] = material;
+	}
+	math::Vec4& Registry::albedo(Entity entity) {
+		return m_albedos[render_index(entity)];
+	}
+	
+	void Registry::update_transforms() {
+		jobs::JobSystem::shared().parallel_for(0, m_positions.size(), 4096, [this](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				m_world[i] = compute_world(i);
+			}
+		});
+	}
+	
+	size_t Registry::transform_count() const {
+		return m_transform_set.size();
+	}
+	const std::vector<uint32_t>& Registry::transform_entities() const {
+		return m_transform_set.entities();
+	}
+	std::vector<math::Vec3>& Registry::positions() {
+		return m_positions;
+	}
+	std::vector<math::Vec3>& Registry::rotations() {
+		return m_rotations;
+	}
+	std::vector<math::Vec3>& Registry::scales() {
+		return m_scales;
+	}
+	const std::vector<math::Mat4>& Registry::world_matrices() const {
+		return m_world;
+	}
+	
+	size_t Registry::render_count() const {
+		return m_render_set.size();
+	}
+	const std::vector<uint32_t>& Registry::render_entities() const {
+		return m_render_set.entities();
+	}
+	const std::vector<uint32_t>& Registry::render_transforms() const {
+		return m_render_transforms;
+	}
+	const std::vector<const render::Mesh*>& Registry::meshes() const {
+		return m_meshes;
+	}
+	const std::vector<const render::Material*>& Registry::materials() const {
+		return m_materials;
+	}
+	const std::vector<math::Vec4>& Registry::albedos() const {
+		return m_albedos;
+	}
+	
+	void Registry::track() {
+		m_memory.resize(m_generations.capacity() * sizeof(uint32_t) + m_free_indices.capacity() * sizeof(uint32_t) +
+			m_transform_set.bytes() + m_positions.capacity() * sizeof(math::Vec3) +
+			m_rotations.capacity() * sizeof(math::Vec3) + m_scales.capacity() * sizeof(math::Vec3) +
+			m_world.capacity() * sizeof(math::Mat4) + m_nodes.capacity() * sizeof(int) + m_render_set.bytes() +
+			m_render_transforms.capacity() * sizeof(uint32_t) + m_meshes.capacity() * sizeof(const render::Mesh*) +
+			m_materials.capacity() * sizeof(const render::Material*) + m_albedos.capacity() * sizeof(math::Vec4));
+	}
+	math::Mat4 Registry::compute_world(size_t index) const {
+		math::Mat4 local = math::Mat4::transform(m_positions[index], m_rotations[index], m_scales[index]);
+		if (m_nodes[index] != scene::SceneGraph::NONE) {
+			return m_graph->world(m_nodes[index]) * local;
+		}
+		return local;
+	}
+	uint32_t Registry::transform_index(Entity entity) const {
+		return m_transform_set.index(entity.index);
+	}
+	uint32_t Registry::render_index(Entity entity) const {
+		return m_render_set.index(entity.index);
+	}
+} // engine::ecs
\ No newline at end of file
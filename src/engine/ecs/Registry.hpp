@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "Entity.hpp"
+#include "SparseSet.hpp"
+#include "../math/Vec3.hpp"
+#include "../math/Vec4.hpp"
+#include "../math/Mat4.hpp"
+#include "../object/Mesh.hpp"
+#include "../scene/SceneGraph.hpp"
+#include "../profile/MemoryTracker.hpp"
+
+namespace engine::render {
+	class Material;
+}
+
+namespace engine::ecs {
+	
+	/**
+	 * Data-oriented alternative to object::Object. Entities are plain handles; their components
+	 * live in one packed array per field, so systems run as linear scans over contiguous memory
+	 * instead of virtual calls on scattered objects.
+	 *
+	 * Transform: position, rotation (Euler angles, applied like Object::model()), scale and the
+	 * world matrix computed from them by update_transforms(). A transform attached to a scene graph
+	 * node is relative to it, like an Object attached with Object::node().
+	 * Render: mesh, material and albedo. Requires a transform; each render entry stores the packed
+	 * index of its entity's transform, so render systems read world matrices without a lookup.
+	 *
+	 * Packed indices change when components are removed; keep Entity handles, not indices.
+	 */
+	class Registry {
+	private:
+		std::vector<uint32_t> m_generations;
+		std::vector<uint32_t> m_free_indices;
+		size_t m_alive;
+		
+		SparseSet m_transform_set;
+		std::vector<math::Vec3> m_positions;
+		std::vector<math::Vec3> m_rotations;
+		std::vector<math::Vec3> m_scales;
+		std::vector<math::Mat4> m_world;
+		std::vector<int> m_nodes;
+		const scene::SceneGraph* m_graph;
+		
+		SparseSet m_render_set;
+		std::vector<uint32_t> m_render_transforms;
+		std::vector<const render::Mesh*> m_meshes;
+		std::vector<const render::Material*> m_materials;
+		std::vector<math::Vec4> m_albedos;
+		
+		// Capacity of all arrays, counted as objects like the Object instances they replace
+		profile::MemoryTracker::Allocation m_memory;
+	
+	public:
+		Registry();
+		
+		Registry(const Registry& other) = default;
+		Registry(Registry&& other) noexcept = default;
+		Registry& operator=(const Registry& other) = default;
+		Registry& operator=(Registry&& other) noexcept = default;
+		~Registry() = default;
+		
+		Entity create();
+		/**
+		 * Removes the entity and all of its components.
+		 */
+		void destroy(Entity entity);
+		bool alive(Entity entity) const;
+		size_t size() const;
+		void clear();
+		
+		void add_transform(Entity entity, const math::Vec3& position, const math::Vec3& rotation = math::Vec3::ZERO,
+			const math::Vec3& scale = math::Vec3::ONE);
+		/**
+		 * Also removes the render component, which needs the transform.
+		 */
+		void remove_transform(Entity entity);
+		bool has_transform(Entity entity) const;
+		
+		const math::Vec3& position(Entity entity) const;
+		const math::Vec3& rotation(Entity entity) const;
+		const math::Vec3& scale(Entity entity) const;
+		/**
+		 * As of the last update_transforms().
+		 */
+		const math::Mat4& world(Entity entity) const;
+		math::Vec3& position(Entity entity);
+		math::Vec3& rotation(Entity entity);
+		math::Vec3& scale(Entity entity);
+		/**
+		 * Attaches the transform to a scene graph node; position, rotation and scale become relative to
+		 * it. All attached transforms share one graph, which must outlive the registry.
+		 */
+		void node(Entity entity, const scene::SceneGraph& graph, int node);
+		int node(Entity entity) const;
+		
+		/**
+		 * The mesh must outlive the component.
+		 */
+		void add_render(Entity entity, const render::Mesh& mesh, const render::Material* material = nullptr,
+			const math::Vec4& albedo = math::Vec4(1, 1, 1, 1));
+		void remove_render(Entity entity);
+		bool has_render(Entity entity) const;
+		
+		const render::Material* material(Entity entity) const;
+		const math::Vec4& albedo(Entity entity) const;
+		void material(Entity entity, const render::Material* material);
+		math::Vec4& albedo(Entity entity);
+		
+		/**
+		 * Recomputes the world matrix of every transform, from the scene graph's last update() for the
+		 * attached ones.
+		 */
+		void update_transforms();
+		
+		// Packed component arrays, for systems
+		
+		size_t transform_count() const;
+		const std::vector<uint32_t>& transform_entities() const;
+		std::vector<math::Vec3>& positions();
+		std::vector<math::Vec3>& rotations();
+		std::vector<math::Vec3>& scales();
+		const std::vector<math::Mat4>& world_matrices() const;
+		
+		size_t render_count() const;
+		const std::vector<uint32_t>& render_entities() const;
+		const std::vector<uint32_t>& render_transforms() const;
+		const std::vector<const render::Mesh*>& meshes() const;
+		const std::vector<const render::Material*>& materials() const;
+		const std::vector<math::Vec4>& albedos() const;
+	
+	private:
+		void track();
+		math::Mat4 compute_world(size_t index) const;
+		uint32_t transform_index(Entity entity) const;
+		uint32_t render_index(Entity entity) const;
+	};
+	
+} // engine::ecs
@@ -0,0 +1,161 @@
+#include "RenderSystem.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "../jobs/JobSystem.hpp"
+
+namespace engine::ecs {
+	RenderSystem::RenderSystem()
+		: m_x(), m_y(), m_z(), m_radius(), m_visible_flags(), m_visible(), m_tested(0) {
+	}
+	
+	void RenderSystem::cull(const Registry& registry, const math::Frustum& frustum) {
+		size_t count = registry.render_count();
+		const std::vector<uint32_t>& transforms = registry.render_transforms();
+		const std::vector<const render::Mesh*>& meshes = registry.meshes();
+		const std::vector<math::Mat4>& world = registry.world_matrices();
+		
+		m_x.resize(count);
+		m_y.resize(count);
+		m_z.resize(count);
+		m_radius.resize(count);
+		m_visible_flags.resize(count);
+		// Every chunk gathers and tests its own slice of the arrays
+		jobs::JobSystem::shared().parallel_for(0, count, 4096, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				math::Sphere sphere = meshes[i]->bounding_sphere().transform(world[transforms[i]]);
+				m_x[i] = sphere.center().x();
+				m_y[i] = sphere.center().y();
+				m_z[i] = sphere.center().z();
+				m_radius[i] = sphere.radius();
+			}
+			frustum.test_spheres(&m_x[begin], &m_y[begin], &m_z[begin], &m_radius[begin], end - begin,
+				&m_visible_flags[begin]);
+		});
+		
+		m_visible.clear();
+		for (size_t i = 0; i < count; i++) {
+			if (m_visible_flags[i]) {
+				m_visible.push_back(static_cast<uint32_t>(i));
+			}
+		}
+		m_tested = count;
+	}
+	void RenderSystem::cull(const Registry& registry, const scene::StaticBVH& tree, const math::Frustum& frustum) {
+		m_visible.clear();
+		tree.query(frustum, m_visible);
+		m_tested = registry.render_count();
+	}
+	void RenderSystem::cull(const Registry& registry, const scene::HashGrid& grid, const math::Frustum& frustum) {
+		m_visible.clear();
+		grid.query(frustum, m_visible);
+		m_tested = registry.render_count();
+	}
+	void RenderSystem::occlude(const Registry& registry, render::OcclusionCuller& culler,
+		const math::Mat4& viewProjection, const std::vector<uint32_t>& occluders) {
+		const std::vector<uint32_t>& transforms = registry.render_transforms();
+		const std::vector<const render::Mesh*>& meshes = registry.meshes();
+		const std::vector<math::Mat4>& world = registry.world_matrices();
+		
+		culler.begin(viewProjection);
+		for (uint32_t i : occluders) {
+			culler.add_occluder(*meshes[i], world[transforms[i]]);
+		}
+		culler.finish();
+		
+		// An occluder would be tested against its own depth
+		size_t kept = 0;
+		for (uint32_t i : m_visible) {
+			bool occluder = std::find(occluders.begin(), occluders.end(), i) != occluders.end();
+			if (occluder || culler.visible(meshes[i]->bounds().transform(world[transforms[i]]))) {
+				m_visible[kept++] = i;
+			}
+		}
+		m_visible.resize(kept);
+	}
+	void RenderSystem::submit(const Registry& registry, render::InstanceRenderer& renderer,
+		std::vector<uint32_t>& blended) const {
+		const std::vector<uint32_t>& transforms = registry.render_transforms();
+		const std::vector<const render::Mesh*>& meshes = registry.meshes();
+		const std::vector<const render::Material*>& materials = registry.materials();
+		const std::vector<math::Vec4>& albedos = registry.albedos();
+		const std::vector<math::Mat4>& world = registry.world_matrices();
+		for (uint32_t i : m_visible) {
+			if (albedos[i].w() < 1) {
+				blended.push_back(i);
+				continue;
+			}
+			renderer.add(*meshes[i], materials[i], render::InstanceRenderer::instance(world[transforms[i]], albedos[i]));
+		}
+	}
+	void RenderSystem::submit(const Registry& registry, std::vector<render::FrameSnapshot::Draw>& opaque,
+		std::vector<uint32_t>& blended) const {
+		const std::vector<uint32_t>& transforms = registry.render_transforms();
+		const std::vector<const render::Mesh*>& meshes = registry.meshes();
+		const std::vector<const render::Material*>& materials = registry.materials();
+		const std::vector<math::Vec4>& albedos = registry.albedos();
+		const std::vector<math::Mat4>& world = registry.world_matrices();
+		for (uint32_t i : m_visible) {
+			if (albedos[i].w() < 1) {
+				blended.push_back(i);
+				continue;
+			}
+			opaque.push_back({meshes[i], materials[i],
+				render::InstanceRenderer::instance(world[transforms[i]], albedos[i])});
+		}
+	}
+	
+	std::vector<scene::StaticBVH::Item> RenderSystem::bounds(const Registry& registry) {
+		const std::vector<uint32_t>& transforms = registry.render_transforms();
+		const std::vector<const render::Mesh*>& meshes = registry.meshes();
+		const std::vector<math::Mat4>& world = registry.world_matrices();
+		std::vector<scene::StaticBVH::Item> items(registry.render_count());
+		for (size_t i = 0; i < items.size(); i++) {
+			items[i] = {meshes[i]->bounds().transform(world[transforms[i]]), static_cast<uint32_t>(i)};
+		}
+		return items;
+	}
+	void RenderSystem::place(const Registry& registry, scene::HashGrid& grid, std::vector<int>& handles) {
+		const std::vector<uint32_t>& transforms = registry.render_transforms();
+		const std::vector<const render::Mesh*>& meshes = registry.meshes();
+		const std::vector<math::Mat4>& world = registry.world_matrices();
+		size_t placed = handles.size();
+		handles.resize(registry.render_count());
+		for (size_t i = 0; i < handles.size(); i++) {
+			math::Sphere sphere = meshes[i]->bounding_sphere().transform(world[transforms[i]]);
+			if (i < placed) {
+				grid.move(handles[i], sphere);
+			}
+			else {
+				handles[i] = grid.insert(sphere, static_cast<uint32_t>(i));
+			}
+		}
+	}
+	void RenderSystem::sort(const Registry& registry, const Camera& camera, std::vector<uint32_t>& indices) {
+		const std::vector<uint32_t>& transforms = registry.render_transforms();
+		const std::vector<math::Mat4>& world = registry.world_matrices();
+		math::Mat4 view = camera.view_matrix();
+		std::vector<std::pair<float, uint32_t>> keyed(indices.size());
+		for (size_t i = 0; i < indices.size(); i++) {
+			math::Vec4 position = view * world[transforms[indices[i]]] * math::Vec4(0, 0, 0, 1);
+			keyed[i] = {position.z() / position.w(), indices[i]};
+		}
+		std::stable_sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) {
+			return a.first < b.first;
+		});
+		for (size_t i = 0; i < indices.size(); i++) {
+			indices[i] = keyed[i].second;
+		}
+	}
+	
+	const std::vector<uint32_t>& RenderSystem::visible() const {
+		return m_visible;
+	}
+	size_t RenderSystem::tested() const {
+		return m_tested;
+	}
+	size_t RenderSystem::culled() const {
+		return m_tested - m_visible.size();
+	}
+} // engine::ecs
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Registry.hpp"
+#include "../Camera.hpp"
+#include "../math/Frustum.hpp"
+#include "../render/InstanceRenderer.hpp"
+#include "../render/OcclusionCuller.hpp"
+#include "../render/FrameSnapshot.hpp"
+#include "../scene/StaticBVH.hpp"
+#include "../scene/HashGrid.hpp"
+
+namespace engine::ecs {
+	
+	/**
+	 * Culls and submits the render components of a Registry.
+	 * cull() gathers the world bounding spheres into structure-of-arrays buffers and tests them in one
+	 * batch; submit() then hands the survivors to an InstanceRenderer straight from the packed arrays.
+	 * Scenes that don't move cull through a scene::StaticBVH built from bounds() instead, moving ones
+	 * through a scene::HashGrid kept up to date by place().
+	 * The buffers are kept between frames.
+	 */
+	class RenderSystem {
+	private:
+		std::vector<float> m_x, m_y, m_z, m_radius;
+		std::vector<uint8_t> m_visible_flags;
+		std::vector<uint32_t> m_visible;
+		size_t m_tested;
+	
+	public:
+		RenderSystem();
+		
+		RenderSystem(const RenderSystem& other) = default;
+		RenderSystem(RenderSystem&& other) noexcept = default;
+		RenderSystem& operator=(const RenderSystem& other) = default;
+		RenderSystem& operator=(RenderSystem&& other) noexcept = default;
+		~RenderSystem() = default;
+		
+		/**
+		 * Uses the world matrices of the last Registry::update_transforms().
+		 */
+		void cull(const Registry& registry, const math::Frustum& frustum);
+		/**
+		 * Culls through a tree whose values are packed render indices. It has to be rebuilt when render
+		 * components are added, removed or moved.
+		 */
+		void cull(const Registry& registry, const scene::StaticBVH& tree, const math::Frustum& frustum);
+		/**
+		 * Culls through a grid filled by place().
+		 */
+		void cull(const Registry& registry, const scene::HashGrid& grid, const math::Frustum& frustum);
+		/**
+		 * Rasterizes the occluders, given as packed render indices, into the culler's depth buffer and
+		 * drops the visible renderables it hides. The occluders are kept untested.
+		 */
+		void occlude(const Registry& registry, render::OcclusionCuller& culler, const math::Mat4& viewProjection,
+			const std::vector<uint32_t>& occluders);
+		/**
+		 * Adds the visible opaque renderables to the renderer and appends the packed render indices
+		 * of the blended ones, which have to be sorted and drawn one by one.
+		 */
+		void submit(const Registry& registry, render::InstanceRenderer& renderer, std::vector<uint32_t>& blended) const;
+		/**
+		 * Same, but appends the opaque renderables to a frame snapshot's draw list.
+		 */
+		void submit(const Registry& registry, std::vector<render::FrameSnapshot::Draw>& opaque,
+			std::vector<uint32_t>& blended) const;
+		
+		/**
+		 * World bounds of every render component as of the last Registry::update_transforms(), with the
+		 * packed render indices as values, for building a scene::StaticBVH.
+		 */
+		static std::vector<scene::StaticBVH::Item> bounds(const Registry& registry);
+		/**
+		 * Files the world bounding sphere of every render component in the grid, with the packed render
+		 * index as value, after a Registry::update_transforms(). handles holds the grid handle of every
+		 * packed render index: render components added since the last call are inserted, the others moved.
+		 * Removing render components reorders the packed arrays, so grid and handles start over then.
+		 */
+		static void place(const Registry& registry, scene::HashGrid& grid, std::vector<int>& handles);
+		/**
+		 * Sorts packed render indices back to front, like RenderHelper::sortObjects().
+		 */
+		static void sort(const Registry& registry, const Camera& camera, std::vector<uint32_t>& indices);
+		
+		/**
+		 * Packed render indices that passed the last cull() and occlude().
+		 */
+		const std::vector<uint32_t>& visible() const;
+		size_t tested() const;
+		size_t culled() const;
+	};
+	
+} // engine::ecs
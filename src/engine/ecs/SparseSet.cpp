@@ -0,0 +1,48 @@
+#include "SparseSet.hpp"
+
+namespace engine::ecs {
+	SparseSet::SparseSet()
+		: m_sparse(), m_dense() {
+	}
+	
+	uint32_t SparseSet::insert(uint32_t entity) {
+		if (entity >= m_sparse.size()) {
+			m_sparse.resize(entity + 1, NONE);
+		}
+		if (m_sparse[entity] != NONE) {
+			return m_sparse[entity];
+		}
+		m_sparse[entity] = static_cast<uint32_t>(m_dense.size());
+		m_dense.push_back(entity);
+		return m_sparse[entity];
+	}
+	uint32_t SparseSet::erase(uint32_t entity) {
+		uint32_t slot = m_sparse[entity];
+		uint32_t last = m_dense.back();
+		m_dense[slot] = last;
+		m_sparse[last] = slot;
+		m_dense.pop_back();
+		m_sparse[entity] = NONE;
+		return slot;
+	}
+	void SparseSet::clear() {
+		m_sparse.clear();
+		m_dense.clear();
+	}
+	
+	bool SparseSet::contains(uint32_t entity) const {
+		return entity < m_sparse.size() && m_sparse[entity] != NONE;
+	}
+	uint32_t SparseSet::index(uint32_t entity) const {
+		return entity < m_sparse.size() ? m_sparse[entity] : NONE;
+	}
+	size_t SparseSet::size() const {
+		return m_dense.size();
+	}
+	const std::vector<uint32_t>& SparseSet::entities() const {
+		return m_dense;
+	}
+	size_t SparseSet::bytes() const {
+		return (m_sparse.capacity() + m_dense.capacity()) * sizeof(uint32_t);
+	}
+} // engine::ecs
\ No newline at end of file
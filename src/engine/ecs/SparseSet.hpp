@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace engine::ecs {
+	
+	/**
+	 * Maps entity indices to a packed range [0, size()). The owner keeps its component arrays in
+	 * the same packed order and mirrors every swap done by erase(), so iterating a component is a
+	 * linear scan without holes.
+	 */
+	class SparseSet {
+	public:
+		static constexpr uint32_t NONE = 0xFFFFFFFF;
+	
+	private:
+		std::vector<uint32_t> m_sparse;
+		std::vector<uint32_t> m_dense;
+	
+	public:
+		SparseSet();
+		
+		SparseSet(const SparseSet& other) = default;
+		SparseSet(SparseSet&& other) noexcept = default;
+		SparseSet& operator=(const SparseSet& other) = default;
+		SparseSet& operator=(SparseSet&& other) noexcept = default;
+		~SparseSet() = default;
+		
+		/**
+		 * @return the packed index of the entity, always size() - 1 for a new one
+		 */
+		uint32_t insert(uint32_t entity);
+		/**
+		 * Moves the last entity into the erased slot.
+		 * @return the packed index that was freed; the owner moves its last component there
+		 */
+		uint32_t erase(uint32_t entity);
+		void clear();
+		
+		bool contains(uint32_t entity) const;
+		/**
+		 * @return the packed index of the entity, or NONE
+		 */
+		uint32_t index(uint32_t entity) const;
+		size_t size() const;
+		/**
+		 * Entity indices in packed order.
+		 */
+		const std::vector<uint32_t>& entities() const;
+		/**
+		 * Capacity of both arrays.
+		 */
+		size_t bytes() const;
+	};
+	
+} // engine::ecs
@@ -6,9 +6,13 @@
 #include <algorithm>
 
 #include "../../vendor/stb/stb_image.h"
+#include "../jobs/JobSystem.hpp"
+#include "../profile/Profiler.hpp"
+#include "../profile/MemoryTracker.hpp"
 
 namespace engine::graphics {
 	std::vector<Texture> Texture::s_textures;
+	std::mutex Texture::s_mutex;
 	
 	Texture::Texture()
 		: m_path(""), m_width(0), m_height(0), m_channels(0), m_data(nullptr) {
@@ -17,10 +21,16 @@ namespace engine::graphics {
 		: m_path(path), m_width(0), m_height(0), m_channels(0), m_data(nullptr) {
 	}
 	Texture& Texture::load(int channels) {
-		stbi_set_flip_vertically_on_load(true);
+		PROFILE_SCOPE("Texture::load");
+		// The flag is per thread, so loaders on different workers don't race on it
+		stbi_set_flip_vertically_on_load_thread(true);
 		m_data = stbi_load(m_path.c_str(), &m_width, &m_height, nullptr, channels);
 		m_channels = channels;
+		
+		std::lock_guard<std::mutex> lock(s_mutex);
 		if (m_data) {
+			// Copies share the pixels, so they are counted once here and released in destroy()
+			profile::MemoryTracker::allocate(profile::MemoryTracker::TEXTURES, data_bytes());
 			std::cout << "Loaded texture [" << m_width << "x" << m_height << ", " << m_channels << " channels]: " << m_path
 				<< std::endl;
 		}
@@ -32,9 +42,19 @@ namespace engine::graphics {
 		
 		return *this;
 	}
+	void Texture::loadAll(const std::vector<Texture*>& textures, int channels) {
+		jobs::JobSystem::shared().parallel_for(0, textures.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				textures[i]->load(channels);
+			}
+		});
+	}
 	void Texture::destroy() {
 		std::cout << "Destroying texture: " << m_path << std::endl;
 		
+		if (m_data) {
+			profile::MemoryTracker::release(profile::MemoryTracker::TEXTURES, data_bytes());
+		}
 		stbi_image_free(m_data);
 		
 		erase_if(s_textures, [this](const Texture& texture) {
@@ -61,6 +81,9 @@ namespace engine::graphics {
 	const unsigned char* Texture::data() const {
 		return m_data;
 	}
+	size_t Texture::data_bytes() const {
+		return m_data ? static_cast<size_t>(m_width) * m_height * m_channels : 0;
+	}
 	void Texture::destroyAll() {
 		while (s_textures.size() > 0) {
 			Texture texture = s_textures.back();
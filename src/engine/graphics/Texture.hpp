@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
 #include "../math/Vec4.hpp"
 #include "../math/Vec2.hpp"
 
@@ -25,6 +26,9 @@ namespace engine::graphics {
 		Texture& operator=(Texture&& other) noexcept = default;
 		~Texture() = default;
 		
+		/**
+		 * Safe to call from several threads at once.
+		 */
 		Texture& load(int channels = 4);
 		void destroy();
 		
@@ -35,6 +39,10 @@ namespace engine::graphics {
 		const int height() const;
 		const int channels() const;
 		const unsigned char* data() const;
+		/**
+		 * Size of the decoded pixels on the CPU.
+		 */
+		size_t data_bytes() const;
 		
 		const math::Vec4 getPixel(int x, int y) const;
 		const math::Vec4 sample(float u, float v) const;
@@ -43,8 +51,13 @@ namespace engine::graphics {
 		
 	private:
 		static std::vector<Texture> s_textures;
+		static std::mutex s_mutex;
 		
 	public:
+		/**
+		 * Decodes the textures in parallel on the shared job system.
+		 */
+		static void loadAll(const std::vector<Texture*>& textures, int channels = 4);
 		static void destroyAll();
 	};
 	
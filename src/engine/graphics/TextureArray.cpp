@@ -0,0 +1,99 @@
+#include "TextureArray.hpp"
+
+#include <iostream>
+#include <algorithm>
+
+#include "GL/glew.h"
+
+#include "../render/GLBackend.hpp"
+#include "../profile/MemoryTracker.hpp"
+
+namespace engine::graphics {
+	std::vector<TextureArray> TextureArray::s_arrays;
+	
+	TextureArray::TextureArray()
+		: m_id(0), m_width(0), m_height(0), m_layers() {
+	}
+	TextureArray::TextureArray(int width, int height)
+		: m_id(0), m_width(width), m_height(height), m_layers() {
+	}
+	
+	int TextureArray::add(const Texture& texture) {
+		if (!texture.loaded()) {
+			std::cerr << "Texture is not loaded: " << texture.path() << std::endl;
+			return -1;
+		}
+		if (texture.width() != m_width || texture.height() != m_height) {
+			std::cerr << "Texture size [" << texture.width() << "x" << texture.height() << "] does not match array ["
+				<< m_width << "x" << m_height << "]: " << texture.path() << std::endl;
+			return -1;
+		}
+		m_layers.push_back(texture);
+		return static_cast<int>(m_layers.size() - 1);
+	}
+	TextureArray& TextureArray::build() {
+		glGenTextures(1, &m_id);
+		render::GLBackend::current().bind_texture(GL_TEXTURE_2D_ARRAY, m_id);
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, m_width, m_height, static_cast<GLsizei>(m_layers.size()), 0,
+			GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for (size_t layer = 0; layer < m_layers.size(); layer++) {
+			const Texture& texture = m_layers[layer];
+			GLenum format = texture.channels() == 3 ? GL_RGB : GL_RGBA;
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(layer), m_width, m_height, 1, format,
+				GL_UNSIGNED_BYTE, texture.data());
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+		
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		
+		// Every layer has a full mip chain
+		size_t bytes = 0;
+		for (int w = m_width, h = m_height; ; w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+			bytes += static_cast<size_t>(w) * h * 4 * m_layers.size();
+			if (w == 1 && h == 1) {
+				break;
+			}
+		}
+		profile::MemoryTracker::track(profile::MemoryTracker::TEXTURE, m_id, bytes, "texture array");
+		
+		std::cout << "Built texture array [" << m_width << "x" << m_height << ", " << m_layers.size() << " layers]"
+			<< std::endl;
+		
+		s_arrays.push_back(*this);
+		return *this;
+	}
+	void TextureArray::destroy() const {
+		std::cout << "Destroying texture array " << m_id << std::endl;
+		render::GLBackend::current().delete_texture(m_id);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::TEXTURE, m_id);
+		
+		erase_if(s_arrays, [this](const TextureArray& array) {
+			return array.m_id == m_id;
+		});
+	}
+	
+	unsigned int TextureArray::id() const {
+		return m_id;
+	}
+	int TextureArray::width() const {
+		return m_width;
+	}
+	int TextureArray::height() const {
+		return m_height;
+	}
+	size_t TextureArray::layers() const {
+		return m_layers.size();
+	}
+	
+	void TextureArray::destroyAll() {
+		while (!s_arrays.empty()) {
+			s_arrays.back().destroy();
+		}
+	}
+} // engine::graphics
\ No newline at end of file
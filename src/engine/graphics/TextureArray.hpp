@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include "Texture.hpp"
+
+namespace engine::graphics {
+	
+	/**
+	 * A GL_TEXTURE_2D_ARRAY built from same-size textures.
+	 * Unlike an atlas, every layer keeps full mipmaps and repeat wrapping.
+	 */
+	class TextureArray {
+	private:
+		unsigned int m_id;
+		int m_width;
+		int m_height;
+		std::vector<Texture> m_layers;
+	
+	public:
+		TextureArray();
+		TextureArray(int width, int height);
+		
+		TextureArray(const TextureArray& other) = default;
+		TextureArray(TextureArray&& other) noexcept = default;
+		TextureArray& operator=(const TextureArray& other) = default;
+		TextureArray& operator=(TextureArray&& other) noexcept = default;
+		~TextureArray() = default;
+		
+		/**
+		 * @return the layer index, or -1 if the texture is not loaded or has a different size
+		 */
+		int add(const Texture& texture);
+		TextureArray& build();
+		void destroy() const;
+		
+		unsigned int id() const;
+		int width() const;
+		int height() const;
+		size_t layers() const;
+	
+	private:
+		static std::vector<TextureArray> s_arrays;
+	
+	public:
+		static void destroyAll();
+	};
+	
+} // engine::graphics
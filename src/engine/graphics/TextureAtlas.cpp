@@ -0,0 +1,224 @@
+#include "TextureAtlas.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "GL/glew.h"
+
+#include "../render/GLBackend.hpp"
+#include "../profile/MemoryTracker.hpp"
+
+namespace engine::graphics {
+	std::vector<TextureAtlas> TextureAtlas::s_atlases;
+	
+	TextureAtlas::TextureAtlas()
+		: m_id(0), m_width(0), m_height(0), m_padding(0), m_skyline(), m_regions(), m_pixels() {
+	}
+	TextureAtlas::TextureAtlas(int width, int height, int padding)
+		: m_id(0), m_width(width), m_height(height), m_padding(padding), m_skyline({{0, 0, width}}), m_regions(),
+		m_pixels(static_cast<size_t>(width) * height * 4, 0) {
+	}
+	
+	int TextureAtlas::add(const Texture& texture) {
+		if (!texture.loaded()) {
+			std::cerr << "Texture is not loaded: " << texture.path() << std::endl;
+			return -1;
+		}
+		if (m_id != 0) {
+			std::cerr << "Cannot add to an atlas that was already built: " << texture.path() << std::endl;
+			return -1;
+		}
+		int width = texture.width() + 2 * m_padding;
+		int height = texture.height() + 2 * m_padding;
+		
+		// Bottom-left heuristic: lowest top edge first, then the narrowest node
+		int best_node = -1;
+		int best_y = 0;
+		int best_bottom = INT_MAX;
+		int best_width = INT_MAX;
+		for (size_t i = 0; i < m_skyline.size(); i++) {
+			int y = fit(i, width, height);
+			if (y < 0) {
+				continue;
+			}
+			int bottom = y + height;
+			if (bottom < best_bottom || (bottom == best_bottom && m_skyline[i].width < best_width)) {
+				best_node = static_cast<int>(i);
+				best_y = y;
+				best_bottom = bottom;
+				best_width = m_skyline[i].width;
+			}
+		}
+		if (best_node < 0) {
+			std::cerr << "Texture does not fit into atlas [" << m_width << "x" << m_height << "]: " << texture.path()
+				<< std::endl;
+			return -1;
+		}
+		
+		int x = m_skyline[best_node].x;
+		insert_skyline(best_node, x, best_y, width, height);
+		blit(texture, x, best_y);
+		
+		AtlasRegion region{};
+		region.x = x + m_padding;
+		region.y = best_y + m_padding;
+		region.width = texture.width();
+		region.height = texture.height();
+		region.uv_rect = math::Vec4(
+			static_cast<float>(region.x) / m_width, static_cast<float>(region.y) / m_height,
+			static_cast<float>(region.width) / m_width, static_cast<float>(region.height) / m_height);
+		m_regions.push_back(region);
+		return static_cast<int>(m_regions.size() - 1);
+	}
+	TextureAtlas& TextureAtlas::build() {
+		glGenTextures(1, &m_id);
+		render::GLBackend::current().bind_texture(GL_TEXTURE_2D, m_id);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_pixels.data());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		
+		// Mips smaller than the padding would blend neighbouring regions together
+		int max_level = m_padding > 0 ? static_cast<int>(std::floor(std::log2(m_padding))) : 0;
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, max_level);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		
+		// Regions cannot repeat inside an atlas, so clamp at the atlas border
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, max_level > 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		
+		size_t bytes = 0;
+		for (int level = 0; level <= max_level; level++) {
+			bytes += static_cast<size_t>(std::max(1, m_width >> level)) * std::max(1, m_height >> level) * 4;
+		}
+		profile::MemoryTracker::track(profile::MemoryTracker::TEXTURE, m_id, bytes, "texture atlas");
+		
+		std::cout << "Built texture atlas [" << m_width << "x" << m_height << ", " << m_regions.size() << " regions, "
+			<< static_cast<int>(occupancy() * 100) << "% used]" << std::endl;
+		
+		// The pixels live on the GPU now
+		m_pixels.clear();
+		m_pixels.shrink_to_fit();
+		m_skyline.clear();
+		
+		s_atlases.push_back(*this);
+		return *this;
+	}
+	void TextureAtlas::destroy() const {
+		std::cout << "Destroying texture atlas " << m_id << std::endl;
+		render::GLBackend::current().delete_texture(m_id);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::TEXTURE, m_id);
+		
+		erase_if(s_atlases, [this](const TextureAtlas& atlas) {
+			return atlas.m_id == m_id;
+		});
+	}
+	
+	unsigned int TextureAtlas::id() const {
+		return m_id;
+	}
+	int TextureAtlas::width() const {
+		return m_width;
+	}
+	int TextureAtlas::height() const {
+		return m_height;
+	}
+	int TextureAtlas::padding() const {
+		return m_padding;
+	}
+	size_t TextureAtlas::size() const {
+		return m_regions.size();
+	}
+	const AtlasRegion& TextureAtlas::region(int index) const {
+		return m_regions.at(index);
+	}
+	float TextureAtlas::occupancy() const {
+		if (m_width == 0 || m_height == 0) {
+			return 0;
+		}
+		long long used = 0;
+		for (const AtlasRegion& region : m_regions) {
+			used += static_cast<long long>(region.width + 2 * m_padding) * (region.height + 2 * m_padding);
+		}
+		return static_cast<float>(used) / (static_cast<float>(m_width) * m_height);
+	}
+	
+	int TextureAtlas::fit(size_t node, int width, int height) const {
+		int x = m_skyline[node].x;
+		if (x + width > m_width) {
+			return -1;
+		}
+		int width_left = width;
+		int y = m_skyline[node].y;
+		for (size_t i = node; width_left > 0; i++) {
+			if (i >= m_skyline.size()) {
+				return -1;
+			}
+			y = std::max(y, m_skyline[i].y);
+			if (y + height > m_height) {
+				return -1;
+			}
+			width_left -= m_skyline[i].width;
+		}
+		return y;
+	}
+	void TextureAtlas::insert_skyline(size_t node, int x, int y, int width, int height) {
+		m_skyline.insert(m_skyline.begin() + node, SkylineNode{x, y + height, width});
+		
+		// Shrink or remove the nodes now covered by the new one
+		for (size_t i = node + 1; i < m_skyline.size();) {
+			const SkylineNode& previous = m_skyline[i - 1];
+			int previous_end = previous.x + previous.width;
+			if (m_skyline[i].x >= previous_end) {
+				break;
+			}
+			int shrink = previous_end - m_skyline[i].x;
+			m_skyline[i].x += shrink;
+			m_skyline[i].width -= shrink;
+			if (m_skyline[i].width > 0) {
+				break;
+			}
+			m_skyline.erase(m_skyline.begin() + i);
+		}
+		
+		// Merge neighbours at the same height
+		for (size_t i = 0; i + 1 < m_skyline.size();) {
+			if (m_skyline[i].y == m_skyline[i + 1].y) {
+				m_skyline[i].width += m_skyline[i + 1].width;
+				m_skyline.erase(m_skyline.begin() + i + 1);
+			}
+			else {
+				i++;
+			}
+		}
+	}
+	void TextureAtlas::blit(const Texture& texture, int x, int y) {
+		int width = texture.width() + 2 * m_padding;
+		int height = texture.height() + 2 * m_padding;
+		int channels = texture.channels();
+		const unsigned char* src = texture.data();
+		
+		// Padding pixels repeat the nearest edge pixel of the source (edge extrusion)
+		for (int dy = 0; dy < height; dy++) {
+			int sy = std::clamp(dy - m_padding, 0, texture.height() - 1);
+			for (int dx = 0; dx < width; dx++) {
+				int sx = std::clamp(dx - m_padding, 0, texture.width() - 1);
+				const unsigned char* s = src + (static_cast<size_t>(sy) * texture.width() + sx) * channels;
+				unsigned char* d = m_pixels.data() + (static_cast<size_t>(y + dy) * m_width + (x + dx)) * 4;
+				d[0] = s[0];
+				d[1] = channels > 1 ? s[1] : s[0];
+				d[2] = channels > 2 ? s[2] : s[0];
+				d[3] = channels > 3 ? s[3] : 255;
+			}
+		}
+	}
+	
+	void TextureAtlas::destroyAll() {
+		while (!s_atlases.empty()) {
+			s_atlases.back().destroy();
+		}
+	}
+} // engine::graphics
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include "Texture.hpp"
+#include "../math/Vec4.hpp"
+
+namespace engine::graphics {
+	
+	struct AtlasRegion {
+		int x, y;
+		int width, height;
+		// (u offset, v offset, u scale, v scale) of the region inside the atlas
+		math::Vec4 uv_rect;
+	};
+	
+	/**
+	 * Packs many small textures into one GL texture using a skyline (bottom-left) packer,
+	 * so materials referencing different images can share a single texture bind.
+	 * Every region is surrounded by `padding` pixels of extruded border to avoid bleeding when filtering.
+	 */
+	class TextureAtlas {
+	private:
+		struct SkylineNode {
+			int x, y, width;
+		};
+		
+		unsigned int m_id;
+		int m_width;
+		int m_height;
+		int m_padding;
+		std::vector<SkylineNode> m_skyline;
+		std::vector<AtlasRegion> m_regions;
+		std::vector<unsigned char> m_pixels;
+	
+	public:
+		TextureAtlas();
+		TextureAtlas(int width, int height, int padding = 4);
+		
+		TextureAtlas(const TextureAtlas& other) = default;
+		TextureAtlas(TextureAtlas&& other) noexcept = default;
+		TextureAtlas& operator=(const TextureAtlas& other) = default;
+		TextureAtlas& operator=(TextureAtlas&& other) noexcept = default;
+		~TextureAtlas() = default;
+		
+		/**
+		 * Copies the texture into the atlas.
+		 * @return the region index, or -1 if the texture is not loaded or does not fit
+		 */
+		int add(const Texture& texture);
+		/**
+		 * Uploads the packed pixels to OpenGL and releases the CPU copy.
+		 */
+		TextureAtlas& build();
+		void destroy() const;
+		
+		unsigned int id() const;
+		int width() const;
+		int height() const;
+		int padding() const;
+		size_t size() const;
+		const AtlasRegion& region(int index) const;
+		
+		/**
+		 * Fraction of the atlas area covered by regions (including padding).
+		 */
+		float occupancy() const;
+	
+	private:
+		int fit(size_t node, int width, int height) const;
+		void insert_skyline(size_t node, int x, int y, int width, int height);
+		void blit(const Texture& texture, int x, int y);
+		
+		static std::vector<TextureAtlas> s_atlases;
+	
+	public:
+		static void destroyAll();
+	};
+	
+} // engine::graphics
@@ -0,0 +1,266 @@
+#include "TextureResidency.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include "GL/glew.h"
+
+static std::vector<unsigned char> to_rgba(const engine::graphics::Texture& texture) {
+	size_t pixels = static_cast<size_t>(texture.width()) * texture.height();
+	int channels = texture.channels();
+	const unsigned char* src = texture.data();
+	std::vector<unsigned char> rgba(pixels * 4);
+	for (size_t i = 0; i < pixels; i++) {
+		const unsigned char* s = src + i * channels;
+		rgba[i * 4 + 0] = s[0];
+		rgba[i * 4 + 1] = channels > 1 ? s[1] : s[0];
+		rgba[i * 4 + 2] = channels > 2 ? s[2] : s[0];
+		rgba[i * 4 + 3] = channels > 3 ? s[3] : 255;
+	}
+	return rgba;
+}
+
+static std::vector<unsigned char> downsample(const std::vector<unsigned char>& src, int width, int height) {
+	int w = std::max(1, width / 2);
+	int h = std::max(1, height / 2);
+	std::vector<unsigned char> dst(static_cast<size_t>(w) * h * 4);
+	for (int y = 0; y < h; y++) {
+		int y0 = std::min(y * 2, height - 1);
+		int y1 = std::min(y * 2 + 1, height - 1);
+		for (int x = 0; x < w; x++) {
+			int x0 = std::min(x * 2, width - 1);
+			int x1 = std::min(x * 2 + 1, width - 1);
+			for (int c = 0; c < 4; c++) {
+				int sum = src[(static_cast<size_t>(y0) * width + x0) * 4 + c] +
+					src[(static_cast<size_t>(y0) * width + x1) * 4 + c] +
+					src[(static_cast<size_t>(y1) * width + x0) * 4 + c] +
+					src[(static_cast<size_t>(y1) * width + x1) * 4 + c];
+				dst[(static_cast<size_t>(y) * w + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+			}
+		}
+	}
+	return dst;
+}
+
+namespace engine::graphics {
+	TextureResidency::TextureResidency(size_t budget_bytes, size_t upload_bytes_per_frame, int tail_size,
+		render::GLBackend& backend)
+		: m_backend(&backend), m_entries(), m_free(), m_budget(budget_bytes), m_upload_budget(upload_bytes_per_frame),
+		m_resident_bytes(0), m_tail_size(tail_size), m_frame(0) {
+	}
+	TextureResidency::~TextureResidency() {
+		for (size_t i = 0; i < m_entries.size(); i++) {
+			if (m_entries[i].alive) {
+				remove(static_cast<Handle>(i));
+			}
+		}
+	}
+	
+	TextureResidency::Handle TextureResidency::add(const Texture& texture) {
+		if (!texture.loaded()) {
+			std::cerr << "Texture is not loaded: " << texture.path() << std::endl;
+			return -1;
+		}
+		Entry entry{};
+		entry.width = texture.width();
+		entry.height = texture.height();
+		entry.mips.push_back(to_rgba(texture));
+		int width = entry.width;
+		int height = entry.height;
+		while (width > 1 || height > 1) {
+			entry.mips.push_back(downsample(entry.mips.back(), width, height));
+			width = std::max(1, width / 2);
+			height = std::max(1, height / 2);
+		}
+		int levels = static_cast<int>(entry.mips.size());
+		size_t mip_bytes = 0;
+		for (const std::vector<unsigned char>& mip : entry.mips) {
+			mip_bytes += mip.size();
+		}
+		entry.memory = profile::MemoryTracker::Allocation(profile::MemoryTracker::TEXTURES, mip_bytes);
+		
+		entry.tail_level = levels - 1;
+		while (entry.tail_level > 0 &&
+			std::max(entry.width >> (entry.tail_level - 1), entry.height >> (entry.tail_level - 1)) <= m_tail_size) {
+			entry.tail_level--;
+		}
+		entry.resident_level = entry.tail_level;
+		entry.wanted_level = entry.tail_level;
+		entry.last_used = m_frame;
+		entry.alive = true;
+		
+		entry.id = m_backend->create_texture();
+		m_backend->bind_texture(GL_TEXTURE_2D, entry.id);
+		for (int level = entry.tail_level; level < levels; level++) {
+			m_backend->tex_image_2d(GL_TEXTURE_2D, level, std::max(1, entry.width >> level),
+				std::max(1, entry.height >> level), entry.mips[level].data());
+			m_resident_bytes += level_bytes(entry, level);
+		}
+		profile::MemoryTracker::track(profile::MemoryTracker::TEXTURE, entry.id, entry_bytes(entry), texture.path());
+		m_backend->tex_parameter(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, entry.tail_level);
+		m_backend->tex_parameter(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+		m_backend->tex_parameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		m_backend->tex_parameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		m_backend->tex_parameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		m_backend->tex_parameter(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		
+		Handle handle;
+		if (!m_free.empty()) {
+			handle = m_free.back();
+			m_free.pop_back();
+			m_entries[handle] = std::move(entry);
+		}
+		else {
+			handle = static_cast<Handle>(m_entries.size());
+			m_entries.push_back(std::move(entry));
+		}
+		return handle;
+	}
+	void TextureResidency::remove(Handle handle) {
+		Entry& entry = m_entries.at(handle);
+		if (!entry.alive) {
+			return;
+		}
+		m_resident_bytes -= texture_bytes(handle);
+		m_backend->delete_texture(entry.id);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::TEXTURE, entry.id);
+		entry = Entry{};
+		m_free.push_back(handle);
+	}
+	
+	void TextureResidency::request(Handle handle, float screen_size) {
+		Entry& entry = m_entries.at(handle);
+		entry.last_used = m_frame;
+		int largest = std::max(entry.width, entry.height);
+		int level = 0;
+		if (screen_size > 0 && screen_size < largest) {
+			level = static_cast<int>(std::floor(std::log2(largest / screen_size)));
+		}
+		else if (screen_size <= 0) {
+			level = entry.tail_level;
+		}
+		entry.wanted_level = std::min(entry.wanted_level, std::clamp(level, 0, entry.tail_level));
+	}
+	void TextureResidency::request(Handle handle, float distance, float world_size, float fov, int viewport_height) {
+		if (distance <= 0) {
+			request(handle, static_cast<float>(viewport_height));
+			return;
+		}
+		float screen_size = world_size / (2.0f * distance * std::tan(fov / 2.0f)) * viewport_height;
+		request(handle, screen_size);
+	}
+	
+	void TextureResidency::update() {
+		std::vector<Entry*> pending;
+		for (Entry& entry : m_entries) {
+			if (entry.alive && entry.wanted_level < entry.resident_level) {
+				pending.push_back(&entry);
+			}
+		}
+		// Textures missing the most detail first
+		std::sort(pending.begin(), pending.end(), [](const Entry* a, const Entry* b) {
+			return a->resident_level - a->wanted_level > b->resident_level - b->wanted_level;
+		});
+		
+		size_t uploaded = 0;
+		for (Entry* entry : pending) {
+			// One level per texture and frame so the bandwidth is shared
+			int level = entry->resident_level - 1;
+			size_t bytes = level_bytes(*entry, level);
+			if (uploaded > 0 && uploaded + bytes > m_upload_budget) {
+				break;
+			}
+			bool fits = true;
+			while (m_resident_bytes + bytes > m_budget) {
+				if (!evict_one()) {
+					fits = false;
+					break;
+				}
+			}
+			if (!fits) {
+				break;
+			}
+			upload(*entry, level);
+			uploaded += bytes;
+		}
+		
+		// The budget may have been lowered since the last update
+		while (m_resident_bytes > m_budget && evict_one()) {
+		}
+		
+		for (Entry& entry : m_entries) {
+			entry.wanted_level = entry.tail_level;
+		}
+		m_frame++;
+	}
+	
+	unsigned int TextureResidency::id(Handle handle) const {
+		return m_entries.at(handle).id;
+	}
+	int TextureResidency::resident_level(Handle handle) const {
+		return m_entries.at(handle).resident_level;
+	}
+	int TextureResidency::level_count(Handle handle) const {
+		return static_cast<int>(m_entries.at(handle).mips.size());
+	}
+	size_t TextureResidency::texture_bytes(Handle handle) const {
+		return entry_bytes(m_entries.at(handle));
+	}
+	size_t TextureResidency::resident_bytes() const {
+		return m_resident_bytes;
+	}
+	size_t TextureResidency::budget() const {
+		return m_budget;
+	}
+	void TextureResidency::budget(size_t budget_bytes) {
+		m_budget = budget_bytes;
+	}
+	
+	size_t TextureResidency::level_bytes(const Entry& entry, int level) const {
+		return static_cast<size_t>(std::max(1, entry.width >> level)) * std::max(1, entry.height >> level) * 4;
+	}
+	size_t TextureResidency::entry_bytes(const Entry& entry) const {
+		size_t bytes = 0;
+		for (int level = entry.resident_level; level < static_cast<int>(entry.mips.size()); level++) {
+			bytes += level_bytes(entry, level);
+		}
+		return bytes;
+	}
+	void TextureResidency::upload(Entry& entry, int level) {
+		m_backend->bind_texture(GL_TEXTURE_2D, entry.id);
+		m_backend->tex_image_2d(GL_TEXTURE_2D, level, std::max(1, entry.width >> level),
+			std::max(1, entry.height >> level), entry.mips[level].data());
+		m_backend->tex_parameter(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+		entry.resident_level = level;
+		m_resident_bytes += level_bytes(entry, level);
+		profile::MemoryTracker::resize(profile::MemoryTracker::TEXTURE, entry.id, entry_bytes(entry));
+	}
+	bool TextureResidency::evict_one() {
+		// Least recently used first; textures used this frame are never evicted
+		Entry* victim = nullptr;
+		for (Entry& entry : m_entries) {
+			if (!entry.alive || entry.resident_level >= entry.tail_level || entry.last_used >= m_frame) {
+				continue;
+			}
+			if (!victim || entry.last_used < victim->last_used ||
+				(entry.last_used == victim->last_used && entry.resident_level < victim->resident_level)) {
+				victim = &entry;
+			}
+		}
+		if (!victim) {
+			return false;
+		}
+		evict(*victim);
+		return true;
+	}
+	void TextureResidency::evict(Entry& entry) {
+		int level = entry.resident_level;
+		m_backend->bind_texture(GL_TEXTURE_2D, entry.id);
+		m_backend->tex_parameter(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+		m_backend->tex_image_2d(GL_TEXTURE_2D, level, 0, 0, nullptr);
+		entry.resident_level = level + 1;
+		m_resident_bytes -= level_bytes(entry, level);
+		profile::MemoryTracker::resize(profile::MemoryTracker::TEXTURE, entry.id, entry_bytes(entry));
+	}
+} // engine::graphics
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "Texture.hpp"
+#include "../render/GLBackend.hpp"
+#include "../profile/MemoryTracker.hpp"
+
+namespace engine::graphics {
+	
+	/**
+	 * Keeps textures resident on the GPU within a memory budget.
+	 * Only the coarse mip tail is uploaded when a texture is added; finer mips are streamed in when
+	 * something requests them (by screen-space size or distance) and the least recently used
+	 * fine mips are evicted when the budget is exceeded.
+	 */
+	class TextureResidency {
+	public:
+		using Handle = int;
+	
+	private:
+		struct Entry {
+			unsigned int id;
+			int width;
+			int height;
+			// CPU copies of every mip level, RGBA8
+			std::vector<std::vector<unsigned char>> mips;
+			// Levels from the tail on are always resident
+			int tail_level;
+			// Finest level currently on the GPU
+			int resident_level;
+			// Finest level requested since the last update
+			int wanted_level;
+			unsigned long long last_used;
+			bool alive;
+			profile::MemoryTracker::Allocation memory;
+		};
+		
+		render::GLBackend* m_backend;
+		std::vector<Entry> m_entries;
+		std::vector<Handle> m_free;
+		size_t m_budget;
+		size_t m_upload_budget;
+		size_t m_resident_bytes;
+		int m_tail_size;
+		unsigned long long m_frame;
+	
+	public:
+		/**
+		 * @param budget_bytes GPU memory the streamed textures may use
+		 * @param upload_bytes_per_frame maximum bytes streamed in per update
+		 * @param tail_size mips with both sides at most this size stay resident
+		 */
+		explicit TextureResidency(size_t budget_bytes, size_t upload_bytes_per_frame = 8 * 1024 * 1024,
+			int tail_size = 64, render::GLBackend& backend = render::GLBackend::current());
+		
+		TextureResidency(const TextureResidency&) = delete;
+		TextureResidency(TextureResidency&&) = default;
+		TextureResidency& operator=(const TextureResidency&) = delete;
+		TextureResidency& operator=(TextureResidency&&) = default;
+		~TextureResidency();
+		
+		Handle add(const Texture& texture);
+		void remove(Handle handle);
+		
+		/**
+		 * Marks the texture as used this frame and asks for the mip matching the size it covers on screen.
+		 */
+		void request(Handle handle, float screen_size);
+		/**
+		 * Same as request(handle, screen_size), estimating the screen size of an object of world_size at distance.
+		 */
+		void request(Handle handle, float distance, float world_size, float fov, int viewport_height);
+		
+		/**
+		 * Streams in requested mips and evicts unused ones, call once per frame.
+		 */
+		void update();
+		
+		unsigned int id(Handle handle) const;
+		int resident_level(Handle handle) const;
+		int level_count(Handle handle) const;
+		size_t texture_bytes(Handle handle) const;
+		
+		size_t resident_bytes() const;
+		size_t budget() const;
+		void budget(size_t budget_bytes);
+	
+	private:
+		size_t level_bytes(const Entry& entry, int level) const;
+		size_t entry_bytes(const Entry& entry) const;
+		void upload(Entry& entry, int level);
+		bool evict_one();
+		void evict(Entry& entry);
+	};
+	
+} // engine::graphics
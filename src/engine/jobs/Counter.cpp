@@ -0,0 +1,14 @@
+#include "Counter.hpp"
+
+namespace engine::jobs {
+	Counter::Counter()
+		: m_value(0), m_mutex(), m_continuations() {
+	}
+	
+	int Counter::value() const {
+		return m_value.load(std::memory_order_acquire);
+	}
+	bool Counter::done() const {
+		return value() == 0;
+	}
+} // engine::jobs
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <functional>
+
+namespace engine::jobs {
+	
+	class Counter;
+	
+	struct Job {
+		std::function<void()> function;
+		// Decremented when the job has run
+		Counter* counter;
+	};
+	
+	/**
+	 * Number of unfinished jobs in a group. JobSystem::run() increments it and every job decrements
+	 * it when done; JobSystem::wait() returns once it is back at zero. Jobs that depend on the group
+	 * are parked here and released when it reaches zero.
+	 * Must outlive the jobs counting on it; wait() on it before destroying it.
+	 */
+	class Counter {
+	private:
+		std::atomic<int> m_value;
+		std::mutex m_mutex;
+		std::vector<Job> m_continuations;
+	
+	public:
+		Counter();
+		
+		Counter(const Counter& other) = delete;
+		Counter(Counter&& other) noexcept = delete;
+		Counter& operator=(const Counter& other) = delete;
+		Counter& operator=(Counter&& other) noexcept = delete;
+		~Counter() = default;
+		
+		int value() const;
+		bool done() const;
+		
+		friend class JobSystem;
+	};
+	
+} // engine::jobs
@@ -0,0 +1,183 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "../profile/Profiler.hpp"
+
+namespace engine::jobs {
+	namespace {
+		// Which scheduler and queue the current thread works for
+		thread_local const JobSystem* t_system = nullptr;
+		thread_local size_t t_queue = 0;
+	}
+	
+	JobSystem::JobSystem(size_t workers)
+		: m_queues(), m_workers(), m_pending(0), m_stop(false), m_sleep_mutex(), m_wake() {
+		for (size_t i = 0; i <= workers; i++) {
+			m_queues.push_back(std::make_unique<Queue>());
+		}
+		for (size_t i = 0; i < workers; i++) {
+			m_workers.emplace_back(&JobSystem::work, this, i + 1);
+		}
+	}
+	JobSystem::~JobSystem() {
+		{
+			std::lock_guard<std::mutex> lock(m_sleep_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& worker : m_workers) {
+			worker.join();
+		}
+		// Whatever is left without workers to run it
+		while (run_one(0)) {
+		}
+	}
+	
+	void JobSystem::run(Function function, Counter* counter, Counter* dependency) {
+		if (counter != nullptr) {
+			counter->m_value.fetch_add(1, std::memory_order_relaxed);
+		}
+		Job job = {std::move(function), counter};
+		if (dependency != nullptr) {
+			std::lock_guard<std::mutex> lock(dependency->m_mutex);
+			// Checked under the lock, so the release in execute() can't slip in between
+			if (!dependency->done()) {
+				dependency->m_continuations.push_back(std::move(job));
+				return;
+			}
+		}
+		push(std::move(job));
+	}
+	void JobSystem::wait(Counter& counter) {
+		size_t queue = queue_index();
+		while (!counter.done()) {
+			if (!run_one(queue)) {
+				std::this_thread::yield();
+			}
+		}
+		// The last job may still be inside execute(); once it lets go the counter can be destroyed
+		std::lock_guard<std::mutex> lock(counter.m_mutex);
+	}
+	void JobSystem::parallel_for(size_t begin, size_t end, size_t grain, const RangeFunction& function) {
+		if (end <= begin) {
+			return;
+		}
+		size_t count = end - begin;
+		if (grain == 0) {
+			grain = std::max<size_t>(1, count / ((m_workers.size() + 1) * 4));
+		}
+		if (count <= grain || m_workers.empty()) {
+			function(begin, end);
+			return;
+		}
+		Counter counter;
+		for (size_t first = begin; first < end; first += grain) {
+			size_t last = std::min(end, first + grain);
+			run([&function, first, last]() {
+				function(first, last);
+			}, &counter);
+		}
+		wait(counter);
+	}
+	
+	size_t JobSystem::worker_count() const {
+		return m_workers.size();
+	}
+	
+	JobSystem& JobSystem::shared() {
+		static JobSystem s_shared(std::max(1u, std::thread::hardware_concurrency()) - 1);
+		return s_shared;
+	}
+	
+	size_t JobSystem::queue_index() const {
+		return t_system == this ? t_queue : 0;
+	}
+	void JobSystem::push(Job job) {
+		Queue& queue = *m_queues[queue_index()];
+		// Counted before it can be taken, so the count never drops below zero
+		m_pending.fetch_add(1, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(std::move(job));
+		}
+		{
+			// Pairs with the predicate check in work(), so a worker about to sleep can't miss the job
+			std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		}
+		m_wake.notify_one();
+	}
+	bool JobSystem::pop(size_t queue, Job& job) {
+		Queue& own = *m_queues[queue];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (own.jobs.empty()) {
+			return false;
+		}
+		// Newest first, its data is most likely still in cache
+		job = std::move(own.jobs.back());
+		own.jobs.pop_back();
+		return true;
+	}
+	bool JobSystem::steal(size_t thief, Job& job) {
+		size_t count = m_queues.size();
+		for (size_t i = 1; i < count; i++) {
+			Queue& victim = *m_queues[(thief + i) % count];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.jobs.empty()) {
+				// Oldest first, usually the biggest piece of work left
+				job = std::move(victim.jobs.front());
+				victim.jobs.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+	bool JobSystem::run_one(size_t queue) {
+		Job job;
+		if (!pop(queue, job) && !steal(queue, job)) {
+			return false;
+		}
+		m_pending.fetch_sub(1, std::memory_order_relaxed);
+		execute(job);
+		return true;
+	}
+	void JobSystem::execute(Job& job) {
+		{
+			PROFILE_SCOPE("job");
+			job.function();
+		}
+		Counter* counter = job.counter;
+		if (counter == nullptr) {
+			return;
+		}
+		std::vector<Job> continuations;
+		{
+			// Held until the counter is no longer touched, see wait()
+			std::lock_guard<std::mutex> lock(counter->m_mutex);
+			if (counter->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				continuations.swap(counter->m_continuations);
+			}
+		}
+		for (Job& continuation : continuations) {
+			push(std::move(continuation));
+		}
+	}
+	void JobSystem::work(size_t queue) {
+		t_system = this;
+		t_queue = queue;
+		PROFILE_THREAD("worker " + std::to_string(queue));
+		while (true) {
+			if (run_one(queue)) {
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(m_sleep_mutex);
+			m_wake.wait(lock, [this]() {
+				return m_stop || m_pending.load(std::memory_order_acquire) > 0;
+			});
+			if (m_stop && m_pending.load(std::memory_order_acquire) == 0) {
+				return;
+			}
+		}
+	}
+} // engine::jobs
\ No newline at end of file
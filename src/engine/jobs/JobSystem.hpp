@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+#include "Counter.hpp"
+
+namespace engine::jobs {
+	
+	/**
+	 * Work-stealing job scheduler. Every worker thread owns a deque: it pushes and pops its own jobs
+	 * at the back, and when it runs dry it steals the oldest job from the front of another deque.
+	 * Threads outside the pool (the main thread, loaders) share one extra deque.
+	 *
+	 * wait() doesn't block: the waiting thread runs queued jobs until its counter reaches zero, so
+	 * jobs may wait on jobs they started, and everything still works with no workers at all.
+	 * Jobs must not touch GL; only the thread owning the context may.
+	 */
+	class JobSystem {
+	public:
+		using Function = std::function<void()>;
+		/**
+		 * Called with a sub-range [begin, end).
+		 */
+		using RangeFunction = std::function<void(size_t begin, size_t end)>;
+	
+	private:
+		struct Queue {
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+		
+		// Queue 0 belongs to threads outside the pool, queue i + 1 to worker i
+		std::vector<std::unique_ptr<Queue>> m_queues;
+		std::vector<std::thread> m_workers;
+		std::atomic<size_t> m_pending;
+		std::atomic<bool> m_stop;
+		std::mutex m_sleep_mutex;
+		std::condition_variable m_wake;
+	
+	public:
+		explicit JobSystem(size_t workers);
+		
+		JobSystem(const JobSystem& other) = delete;
+		JobSystem(JobSystem&& other) noexcept = delete;
+		JobSystem& operator=(const JobSystem& other) = delete;
+		JobSystem& operator=(JobSystem&& other) noexcept = delete;
+		/**
+		 * Runs the remaining jobs, then joins the workers.
+		 */
+		~JobSystem();
+		
+		/**
+		 * Queues a job. The counter, if any, is incremented now and decremented when the job is done.
+		 * With a dependency the job is held back until that counter reaches zero.
+		 */
+		void run(Function function, Counter* counter = nullptr, Counter* dependency = nullptr);
+		/**
+		 * Runs queued jobs on the calling thread until the counter reaches zero.
+		 */
+		void wait(Counter& counter);
+		/**
+		 * Splits [begin, end) into chunks of at most grain items, runs them as jobs and waits for all
+		 * of them. Small ranges run inline. A grain of 0 picks about four chunks per thread.
+		 */
+		void parallel_for(size_t begin, size_t end, size_t grain, const RangeFunction& function);
+		
+		size_t worker_count() const;
+		
+		/**
+		 * Engine-wide scheduler with one worker per core besides the main thread, started on first use.
+		 */
+		static JobSystem& shared();
+	
+	private:
+		size_t queue_index() const;
+		void push(Job job);
+		bool pop(size_t queue, Job& job);
+		bool steal(size_t thief, Job& job);
+		bool run_one(size_t queue);
+		void execute(Job& job);
+		void work(size_t queue);
+	};
+	
+} // engine::jobs
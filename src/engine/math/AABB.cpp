@@ -0,0 +1,98 @@
+#include "AABB.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+using namespace std::string_literals;
+
+namespace engine::math {
+	const AABB AABB::EMPTY = AABB(
+		Vec3(std::numeric_limits<float>::max()),
+		Vec3(-std::numeric_limits<float>::max()));
+	
+	AABB::AABB() : m_min(), m_max() {}
+	AABB::AABB(const Vec3& min, const Vec3& max) : m_min(min), m_max(max) {}
+	
+	const Vec3& AABB::min() const {
+		return m_min;
+	}
+	const Vec3& AABB::max() const {
+		return m_max;
+	}
+	Vec3 AABB::center() const {
+		return (m_min + m_max) * 0.5f;
+	}
+	Vec3 AABB::extents() const {
+		return (m_max - m_min) * 0.5f;
+	}
+	bool AABB::empty() const {
+		return m_min.x() > m_max.x() || m_min.y() > m_max.y() || m_min.z() > m_max.z();
+	}
+	
+	AABB AABB::expand(const Vec3& point) const {
+		return AABB(
+			Vec3(std::min(m_min.x(), point.x()), std::min(m_min.y(), point.y()), std::min(m_min.z(), point.z())),
+			Vec3(std::max(m_max.x(), point.x()), std::max(m_max.y(), point.y()), std::max(m_max.z(), point.z())));
+	}
+	float AABB::surface_area() const {
+		Vec3 d = m_max - m_min;
+		return 2 * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+	}
+	
+	AABB AABB::merge(const AABB& other) const {
+		return AABB(
+			Vec3(std::min(m_min.x(), other.m_min.x()), std::min(m_min.y(), other.m_min.y()),
+				std::min(m_min.z(), other.m_min.z())),
+			Vec3(std::max(m_max.x(), other.m_max.x()), std::max(m_max.y(), other.m_max.y()),
+				std::max(m_max.z(), other.m_max.z())));
+	}
+	AABB AABB::grow(float margin) const {
+		return AABB(m_min - Vec3(margin), m_max + Vec3(margin));
+	}
+	bool AABB::contains(const Vec3& point) const {
+		return point.x() >= m_min.x() && point.x() <= m_max.x() &&
+			point.y() >= m_min.y() && point.y() <= m_max.y() &&
+			point.z() >= m_min.z() && point.z() <= m_max.z();
+	}
+	bool AABB::contains(const AABB& other) const {
+		return other.m_min.x() >= m_min.x() && other.m_max.x() <= m_max.x() &&
+			other.m_min.y() >= m_min.y() && other.m_max.y() <= m_max.y() &&
+			other.m_min.z() >= m_min.z() && other.m_max.z() <= m_max.z();
+	}
+	bool AABB::intersects(const AABB& other) const {
+		return m_min.x() <= other.m_max.x() && m_max.x() >= other.m_min.x() &&
+			m_min.y() <= other.m_max.y() && m_max.y() >= other.m_min.y() &&
+			m_min.z() <= other.m_max.z() && m_max.z() >= other.m_min.z();
+	}
+	
+	AABB AABB::transform(const Mat4& matrix) const {
+		// Arvo: the new extents are the old ones through the absolute rotation/scale part
+		const float* m = matrix.data();
+		Vec3 c = center();
+		Vec3 e = extents();
+		Vec3 center(
+			m[0] * c.x() + m[1] * c.y() + m[2] * c.z() + m[3],
+			m[4] * c.x() + m[5] * c.y() + m[6] * c.z() + m[7],
+			m[8] * c.x() + m[9] * c.y() + m[10] * c.z() + m[11]);
+		Vec3 extents(
+			std::abs(m[0]) * e.x() + std::abs(m[1]) * e.y() + std::abs(m[2]) * e.z(),
+			std::abs(m[4]) * e.x() + std::abs(m[5]) * e.y() + std::abs(m[6]) * e.z(),
+			std::abs(m[8]) * e.x() + std::abs(m[9]) * e.y() + std::abs(m[10]) * e.z());
+		return AABB(center - extents, center + extents);
+	}
+	
+	AABB AABB::fromPoints(const std::vector<Vec3>& points) {
+		AABB box = EMPTY;
+		for (const Vec3& point : points) {
+			box = box.expand(point);
+		}
+		return box;
+	}
+	
+	std::ostream& operator<<(std::ostream& os, const AABB& box) {
+		return os << box.to_string();
+	}
+	std::string AABB::to_string() const {
+		return "["s + m_min.to_string() + " - " + m_max.to_string() + "]";
+	}
+} // engine::math
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <ostream>
+#include <string>
+
+#include "Vec3.hpp"
+#include "Mat4.hpp"
+
+namespace engine::math {
+	
+	/**
+	 * Axis-aligned bounding box.
+	 */
+	class AABB {
+	private:
+		Vec3 m_min, m_max;
+	public:
+		AABB();
+		AABB(const Vec3& min, const Vec3& max);
+		
+		AABB(const AABB& other) = default;
+		AABB(AABB&& other) noexcept = default;
+		AABB& operator=(const AABB& other) = default;
+		AABB& operator=(AABB&& other) noexcept = default;
+		~AABB() = default;
+		
+		const Vec3& min() const;
+		const Vec3& max() const;
+		Vec3 center() const;
+		/**
+		 * Half size along each axis.
+		 */
+		Vec3 extents() const;
+		bool empty() const;
+		float surface_area() const;
+		
+		AABB expand(const Vec3& point) const;
+		AABB merge(const AABB& other) const;
+		/**
+		 * Box grown by the margin on every side.
+		 */
+		AABB grow(float margin) const;
+		bool contains(const Vec3& point) const;
+		bool contains(const AABB& other) const;
+		bool intersects(const AABB& other) const;
+		
+		/**
+		 * Box around this box transformed by an affine matrix.
+		 */
+		AABB transform(const Mat4& matrix) const;
+		
+		static AABB fromPoints(const std::vector<Vec3>& points);
+		
+		friend std::ostream& operator<<(std::ostream& os, const AABB& box);
+		std::string to_string() const;
+		
+		/**
+		 * Inverted box that any expand() or merge() replaces.
+		 */
+		static const AABB EMPTY;
+	};
+	
+} // engine::math
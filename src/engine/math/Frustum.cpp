@@ -0,0 +1,163 @@
+#include "Frustum.hpp"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FRUSTUM_SSE
+#endif
+
+namespace engine::math {
+	Frustum::Frustum() : m_planes() {}
+	Frustum::Frustum(const Mat4& viewProjection) {
+		const float* m = viewProjection.data();
+		// Rows of the row-major matrix
+		Vec4 r0(m[0], m[1], m[2], m[3]);
+		Vec4 r1(m[4], m[5], m[6], m[7]);
+		Vec4 r2(m[8], m[9], m[10], m[11]);
+		Vec4 r3(m[12], m[13], m[14], m[15]);
+		
+		m_planes[LEFT] = r3 + r0;
+		m_planes[RIGHT] = r3 - r0;
+		m_planes[BOTTOM] = r3 + r1;
+		m_planes[TOP] = r3 - r1;
+		m_planes[NEAR_CLIP] = r3 + r2;
+		m_planes[FAR_CLIP] = r3 - r2;
+		
+		// Normalize so plane distances are in world units, which the sphere test needs
+		for (Vec4& plane : m_planes) {
+			float length = std::sqrt(plane.x() * plane.x() + plane.y() * plane.y() + plane.z() * plane.z());
+			if (length > 0) {
+				plane /= length;
+			}
+		}
+	}
+	
+	const Vec4& Frustum::plane(Plane plane) const {
+		return m_planes[plane];
+	}
+	
+	bool Frustum::contains(const Vec3& point) const {
+		for (const Vec4& p : m_planes) {
+			if (p.x() * point.x() + p.y() * point.y() + p.z() * point.z() + p.w() < 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+	bool Frustum::intersects(const Sphere& sphere) const {
+		const Vec3& c = sphere.center();
+		for (const Vec4& p : m_planes) {
+			if (p.x() * c.x() + p.y() * c.y() + p.z() * c.z() + p.w() < -sphere.radius()) {
+				return false;
+			}
+		}
+		return true;
+	}
+	bool Frustum::intersects(const AABB& box) const {
+		Vec3 c = box.center();
+		Vec3 e = box.extents();
+		for (const Vec4& p : m_planes) {
+			float r = std::abs(p.x()) * e.x() + std::abs(p.y()) * e.y() + std::abs(p.z()) * e.z();
+			if (p.x() * c.x() + p.y() * c.y() + p.z() * c.z() + p.w() < -r) {
+				return false;
+			}
+		}
+		return true;
+	}
+	
+	Frustum::Containment Frustum::classify(const AABB& box) const {
+		Vec3 c = box.center();
+		Vec3 e = box.extents();
+		Containment result = INSIDE;
+		for (const Vec4& p : m_planes) {
+			float r = std::abs(p.x()) * e.x() + std::abs(p.y()) * e.y() + std::abs(p.z()) * e.z();
+			float d = p.x() * c.x() + p.y() * c.y() + p.z() * c.z() + p.w();
+			if (d < -r) {
+				return OUTSIDE;
+			}
+			if (d < r) {
+				result = INTERSECTING;
+			}
+		}
+		return result;
+	}
+	
+	void Frustum::test_spheres(const float* x, const float* y, const float* z, const float* radius, size_t count,
+		uint8_t* visible) const {
+		size_t i = 0;
+#ifdef FRUSTUM_SSE
+		__m128 px[6], py[6], pz[6], pw[6];
+		for (int p = 0; p < 6; p++) {
+			px[p] = _mm_set1_ps(m_planes[p].x());
+			py[p] = _mm_set1_ps(m_planes[p].y());
+			pz[p] = _mm_set1_ps(m_planes[p].z());
+			pw[p] = _mm_set1_ps(m_planes[p].w());
+		}
+		for (; i + 4 <= count; i += 4) {
+			__m128 cx = _mm_loadu_ps(x + i);
+			__m128 cy = _mm_loadu_ps(y + i);
+			__m128 cz = _mm_loadu_ps(z + i);
+			__m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int p = 0; p < 6; p++) {
+				__m128 d = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(px[p], cx), _mm_mul_ps(py[p], cy)),
+					_mm_add_ps(_mm_mul_ps(pz[p], cz), pw[p]));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+			}
+			int mask = _mm_movemask_ps(inside);
+			visible[i + 0] = (mask >> 0) & 1;
+			visible[i + 1] = (mask >> 1) & 1;
+			visible[i + 2] = (mask >> 2) & 1;
+			visible[i + 3] = (mask >> 3) & 1;
+		}
+#endif
+		for (; i < count; i++) {
+			visible[i] = intersects(Sphere(Vec3(x[i], y[i], z[i]), radius[i]));
+		}
+	}
+	void Frustum::test_boxes(const float* x, const float* y, const float* z, const float* ex, const float* ey,
+		const float* ez, size_t count, uint8_t* visible) const {
+		size_t i = 0;
+#ifdef FRUSTUM_SSE
+		__m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		__m128 px[6], py[6], pz[6], pw[6], ax[6], ay[6], az[6];
+		for (int p = 0; p < 6; p++) {
+			px[p] = _mm_set1_ps(m_planes[p].x());
+			py[p] = _mm_set1_ps(m_planes[p].y());
+			pz[p] = _mm_set1_ps(m_planes[p].z());
+			pw[p] = _mm_set1_ps(m_planes[p].w());
+			ax[p] = _mm_and_ps(px[p], signMask);
+			ay[p] = _mm_and_ps(py[p], signMask);
+			az[p] = _mm_and_ps(pz[p], signMask);
+		}
+		for (; i + 4 <= count; i += 4) {
+			__m128 cx = _mm_loadu_ps(x + i);
+			__m128 cy = _mm_loadu_ps(y + i);
+			__m128 cz = _mm_loadu_ps(z + i);
+			__m128 hx = _mm_loadu_ps(ex + i);
+			__m128 hy = _mm_loadu_ps(ey + i);
+			__m128 hz = _mm_loadu_ps(ez + i);
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int p = 0; p < 6; p++) {
+				// Distance of the center and projected radius of the box onto the plane normal
+				__m128 d = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(px[p], cx), _mm_mul_ps(py[p], cy)),
+					_mm_add_ps(_mm_mul_ps(pz[p], cz), pw[p]));
+				__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], hx), _mm_mul_ps(ay[p], hy)), _mm_mul_ps(az[p], hz));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+			}
+			int mask = _mm_movemask_ps(inside);
+			visible[i + 0] = (mask >> 0) & 1;
+			visible[i + 1] = (mask >> 1) & 1;
+			visible[i + 2] = (mask >> 2) & 1;
+			visible[i + 3] = (mask >> 3) & 1;
+		}
+#endif
+		for (; i < count; i++) {
+			Vec3 center(x[i], y[i], z[i]);
+			Vec3 extents(ex[i], ey[i], ez[i]);
+			visible[i] = intersects(AABB(center - extents, center + extents));
+		}
+	}
+} // engine::math
\ No newline at end of file
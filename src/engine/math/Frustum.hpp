@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Vec4.hpp"
+#include "Mat4.hpp"
+#include "AABB.hpp"
+#include "Sphere.hpp"
+
+namespace engine::math {
+	
+	/**
+	 * Six planes (a, b, c, d) with normals pointing inside, extracted from a view-projection matrix.
+	 * A point p is inside a plane if a*p.x + b*p.y + c*p.z + d >= 0.
+	 * The batch tests take structure-of-arrays input and check four objects at a time with SSE2.
+	 */
+	class Frustum {
+	public:
+		enum Plane {
+			LEFT, RIGHT, BOTTOM, TOP, NEAR_CLIP, FAR_CLIP
+		};
+		enum Containment {
+			OUTSIDE, INTERSECTING, INSIDE
+		};
+	
+	private:
+		Vec4 m_planes[6];
+	public:
+		Frustum();
+		/**
+		 * Gribb/Hartmann extraction for OpenGL clip space (-w <= z <= w).
+		 */
+		explicit Frustum(const Mat4& viewProjection);
+		
+		Frustum(const Frustum& other) = default;
+		Frustum(Frustum&& other) noexcept = default;
+		Frustum& operator=(const Frustum& other) = default;
+		Frustum& operator=(Frustum&& other) noexcept = default;
+		~Frustum() = default;
+		
+		const Vec4& plane(Plane plane) const;
+		
+		bool contains(const Vec3& point) const;
+		bool intersects(const Sphere& sphere) const;
+		bool intersects(const AABB& box) const;
+		/**
+		 * Like intersects(), but also tells whether the box is entirely inside, so hierarchies can
+		 * accept a whole subtree without testing it.
+		 */
+		Containment classify(const AABB& box) const;
+		
+		/**
+		 * Sets visible[i] to 1 if the sphere i touches the frustum, 0 otherwise.
+		 */
+		void test_spheres(const float* x, const float* y, const float* z, const float* radius, size_t count,
+			uint8_t* visible) const;
+		/**
+		 * Sets visible[i] to 1 if the box i (center and half extents) touches the frustum, 0 otherwise.
+		 */
+		void test_boxes(const float* x, const float* y, const float* z, const float* ex, const float* ey,
+			const float* ez, size_t count, uint8_t* visible) const;
+	};
+	
+} // engine::math
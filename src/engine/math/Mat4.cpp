@@ -321,6 +321,19 @@ namespace engine::math {
 	Mat4 Mat4::scale(const Vec3& scale) {
 		return Mat4::scale(scale.x(), scale.y(), scale.z());
 	}
+	Mat4 Mat4::transform(const Vec3& translation, const Vec3& rotation, const Vec3& scale) {
+		float cx = std::cos(rotation.x()), sx = std::sin(rotation.x());
+		float cy = std::cos(rotation.y()), sy = std::sin(rotation.y());
+		float cz = std::cos(rotation.z()), sz = std::sin(rotation.z());
+		float r00 = cy * cz, r01 = -cy * sz, r02 = sy;
+		float r10 = cx * sz + sx * sy * cz, r11 = cx * cz - sx * sy * sz, r12 = -sx * cy;
+		float r20 = sx * sz - cx * sy * cz, r21 = sx * cz + cx * sy * sz, r22 = cx * cy;
+		return Mat4(
+			r00 * scale.x(), r01 * scale.y(), r02 * scale.z(), translation.x(),
+			r10 * scale.x(), r11 * scale.y(), r12 * scale.z(), translation.y(),
+			r20 * scale.x(), r21 * scale.y(), r22 * scale.z(), translation.z(),
+			0, 0, 0, 1);
+	}
 	Mat4 Mat4::perspective(float fov, float aspect, float near, float far) {
 		float focalLength = 1.0f / std::tan(fov / 2.0f);
 		return Mat4(
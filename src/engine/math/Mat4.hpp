@@ -83,6 +83,10 @@ namespace engine::math {
 		static Mat4 rotation(float angle, const Vec3& axis);
 		static Mat4 scale(float x, float y, float z);
 		static Mat4 scale(const Vec3& scale);
+		/**
+		 * translation * rotation(x) * rotation(y) * rotation(z) * scale, without the matrix products.
+		 */
+		static Mat4 transform(const Vec3& translation, const Vec3& rotation, const Vec3& scale);
 		static Mat4 perspective(float fov, float aspect, float near, float far);
 		static Mat4 orthographic(float left, float right, float bottom, float top, float near, float far);
 		static Mat4 lookAt(const Vec3& eye, const Vec3& center, const Vec3& up);
@@ -0,0 +1,70 @@
+#include "Ray.hpp"
+#include <cmath>
+#include <algorithm>
+
+using namespace std::string_literals;
+
+namespace engine::math {
+	Ray::Ray() : m_origin(), m_direction(0, 0, -1), m_inverse_direction(1 / 0.0f, 1 / 0.0f, -1) {}
+	Ray::Ray(const Vec3& origin, const Vec3& direction)
+		: m_origin(origin), m_direction(direction),
+		m_inverse_direction(1 / direction.x(), 1 / direction.y(), 1 / direction.z()) {}
+	
+	const Vec3& Ray::origin() const {
+		return m_origin;
+	}
+	const Vec3& Ray::direction() const {
+		return m_direction;
+	}
+	Vec3 Ray::at(float distance) const {
+		return m_origin + m_direction * distance;
+	}
+	
+	bool Ray::intersects(const AABB& box, float maxDistance, float& distance) const {
+		// Slab test; infinite reciprocals of axis-parallel rays sort themselves out in min/max
+		float tx1 = (box.min().x() - m_origin.x()) * m_inverse_direction.x();
+		float tx2 = (box.max().x() - m_origin.x()) * m_inverse_direction.x();
+		float ty1 = (box.min().y() - m_origin.y()) * m_inverse_direction.y();
+		float ty2 = (box.max().y() - m_origin.y()) * m_inverse_direction.y();
+		float tz1 = (box.min().z() - m_origin.z()) * m_inverse_direction.z();
+		float tz2 = (box.max().z() - m_origin.z()) * m_inverse_direction.z();
+		float enter = std::max({std::min(tx1, tx2), std::min(ty1, ty2), std::min(tz1, tz2), 0.0f});
+		float leave = std::min({std::max(tx1, tx2), std::max(ty1, ty2), std::max(tz1, tz2), maxDistance});
+		if (enter > leave) {
+			return false;
+		}
+		distance = enter;
+		return true;
+	}
+	bool Ray::intersects(const Sphere& sphere, float maxDistance, float& distance) const {
+		Vec3 oc = m_origin - sphere.center();
+		float a = m_direction.dot(m_direction);
+		float b = oc.dot(m_direction);
+		float c = oc.dot(oc) - sphere.radius() * sphere.radius();
+		float discriminant = b * b - a * c;
+		if (discriminant < 0) {
+			return false;
+		}
+		float root = std::sqrt(discriminant);
+		float t = (-b - root) / a;
+		if (t < 0) {
+			// Inside the sphere, or the sphere is behind the origin
+			if ((-b + root) / a < 0) {
+				return false;
+			}
+			t = 0;
+		}
+		if (t > maxDistance) {
+			return false;
+		}
+		distance = t;
+		return true;
+	}
+	
+	std::ostream& operator<<(std::ostream& os, const Ray& ray) {
+		return os << ray.to_string();
+	}
+	std::string Ray::to_string() const {
+		return "("s + m_origin.to_string() + " -> " + m_direction.to_string() + ")";
+	}
+} // engine::math
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "Vec3.hpp"
+#include "AABB.hpp"
+#include "Sphere.hpp"
+
+namespace engine::math {
+	
+	/**
+	 * Half line from an origin along a direction. The reciprocal direction is kept for the slab test.
+	 */
+	class Ray {
+	private:
+		Vec3 m_origin;
+		Vec3 m_direction;
+		Vec3 m_inverse_direction;
+	public:
+		Ray();
+		Ray(const Vec3& origin, const Vec3& direction);
+		
+		Ray(const Ray& other) = default;
+		Ray(Ray&& other) noexcept = default;
+		Ray& operator=(const Ray& other) = default;
+		Ray& operator=(Ray&& other) noexcept = default;
+		~Ray() = default;
+		
+		const Vec3& origin() const;
+		const Vec3& direction() const;
+		Vec3 at(float distance) const;
+		
+		/**
+		 * @param distance set to where the ray enters the box, 0 if it starts inside
+		 * @return true if the box is hit before maxDistance
+		 */
+		bool intersects(const AABB& box, float maxDistance, float& distance) const;
+		bool intersects(const Sphere& sphere, float maxDistance, float& distance) const;
+		
+		friend std::ostream& operator<<(std::ostream& os, const Ray& ray);
+		std::string to_string() const;
+	};
+	
+} // engine::math
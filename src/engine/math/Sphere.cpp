@@ -0,0 +1,71 @@
+#include "Sphere.hpp"
+#include <cmath>
+#include <algorithm>
+
+#include "AABB.hpp"
+
+using namespace std::string_literals;
+
+namespace engine::math {
+	Sphere::Sphere() : m_center(), m_radius(0) {}
+	Sphere::Sphere(const Vec3& center, float radius) : m_center(center), m_radius(radius) {}
+	
+	const Vec3& Sphere::center() const {
+		return m_center;
+	}
+	float Sphere::radius() const {
+		return m_radius;
+	}
+	
+	bool Sphere::contains(const Vec3& point) const {
+		Vec3 d = point - m_center;
+		return d.dot(d) <= m_radius * m_radius;
+	}
+	bool Sphere::intersects(const Sphere& other) const {
+		Vec3 d = other.m_center - m_center;
+		float r = m_radius + other.m_radius;
+		return d.dot(d) <= r * r;
+	}
+	
+	bool Sphere::intersects(const AABB& box) const {
+		// Distance from the center to the closest point of the box
+		Vec3 closest(
+			std::clamp(m_center.x(), box.min().x(), box.max().x()),
+			std::clamp(m_center.y(), box.min().y(), box.max().y()),
+			std::clamp(m_center.z(), box.min().z(), box.max().z()));
+		Vec3 d = closest - m_center;
+		return d.dot(d) <= m_radius * m_radius;
+	}
+	
+	Sphere Sphere::transform(const Mat4& matrix) const {
+		const float* m = matrix.data();
+		Vec3 center(
+			m[0] * m_center.x() + m[1] * m_center.y() + m[2] * m_center.z() + m[3],
+			m[4] * m_center.x() + m[5] * m_center.y() + m[6] * m_center.z() + m[7],
+			m[8] * m_center.x() + m[9] * m_center.y() + m[10] * m_center.z() + m[11]);
+		float sx = m[0] * m[0] + m[4] * m[4] + m[8] * m[8];
+		float sy = m[1] * m[1] + m[5] * m[5] + m[9] * m[9];
+		float sz = m[2] * m[2] + m[6] * m[6] + m[10] * m[10];
+		return Sphere(center, m_radius * std::sqrt(std::max({sx, sy, sz})));
+	}
+	
+	Sphere Sphere::fromPoints(const std::vector<Vec3>& points) {
+		if (points.empty()) {
+			return Sphere();
+		}
+		Vec3 center = AABB::fromPoints(points).center();
+		float radius2 = 0;
+		for (const Vec3& point : points) {
+			Vec3 d = point - center;
+			radius2 = std::max(radius2, d.dot(d));
+		}
+		return Sphere(center, std::sqrt(radius2));
+	}
+	
+	std::ostream& operator<<(std::ostream& os, const Sphere& sphere) {
+		return os << sphere.to_string();
+	}
+	std::string Sphere::to_string() const {
+		return "("s + m_center.to_string() + ", r=" + std::to_string(m_radius) + ")";
+	}
+} // engine::math
\ No newline at end of file
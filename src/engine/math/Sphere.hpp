@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <ostream>
+#include <string>
+
+#include "Vec3.hpp"
+#include "Mat4.hpp"
+
+namespace engine::math {
+	class AABB;
+	
+	class Sphere {
+	private:
+		Vec3 m_center;
+		float m_radius;
+	public:
+		Sphere();
+		Sphere(const Vec3& center, float radius);
+		
+		Sphere(const Sphere& other) = default;
+		Sphere(Sphere&& other) noexcept = default;
+		Sphere& operator=(const Sphere& other) = default;
+		Sphere& operator=(Sphere&& other) noexcept = default;
+		~Sphere() = default;
+		
+		const Vec3& center() const;
+		float radius() const;
+		
+		bool contains(const Vec3& point) const;
+		bool intersects(const Sphere& other) const;
+		bool intersects(const AABB& box) const;
+		
+		/**
+		 * Sphere around this sphere transformed by an affine matrix; the radius grows with the largest scale.
+		 */
+		Sphere transform(const Mat4& matrix) const;
+		
+		/**
+		 * Sphere centered on the bounding box of the points, not minimal but tight enough for culling.
+		 */
+		static Sphere fromPoints(const std::vector<Vec3>& points);
+		
+		friend std::ostream& operator<<(std::ostream& os, const Sphere& sphere);
+		std::string to_string() const;
+	};
+	
+} // engine::math
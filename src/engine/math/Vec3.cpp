@@ -107,6 +107,9 @@ namespace engine::math {
 			(t * n.m_x * n.m_z - s * n.m_y) * x + (t * n.m_y * n.m_z + s * n.m_x) * y + (t * n.m_z * n.m_z + c) * z
 		);
 	}
+	Vec3 Vec3::lerp(const Vec3& other, float t) const {
+		return Vec3(m_x + (other.m_x - m_x) * t, m_y + (other.m_y - m_y) * t, m_z + (other.m_z - m_z) * t);
+	}
 	
 	std::ostream& operator<<(std::ostream& os, const Vec3& vec) {
 		return os << vec.to_string();
@@ -50,6 +50,7 @@ namespace engine::math {
 		float magnitude() const;
 		Vec3 normalize() const;
 		Vec3 rotate(float angle, const Vec3& axis) const;
+		Vec3 lerp(const Vec3& other, float t) const;
 		
 		friend std::ostream& operator<<(std::ostream& os, const Vec3& vec);
 		std::string to_string() const;
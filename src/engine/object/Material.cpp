@@ -1,23 +1,31 @@
 #include "Material.hpp"
 
 #include <iostream>
+#include <algorithm>
+#include <set>
 
 #include "GL/glew.h"
 
+#include "../render/GLBackend.hpp"
+
 #include "../../vendor/stb/stb_image.h"
 
 namespace engine::render {
 	std::vector<Material> Material::s_materials;
 	
 	Material::Material()
-		: m_id(0), m_texture() {
+		: m_id(0), m_target(GL_TEXTURE_2D), m_texture(), m_uv_rect(0, 0, 1, 1), m_layer(0), m_owns_texture(false),
+		m_byte_size(0), m_layers(), m_mix_modes(),
+		m_memory(profile::MemoryTracker::MATERIALS, 0) {
 	}
 	Material::Material(graphics::Texture& texture)
-		: m_id(0), m_texture(texture) {
+		: m_id(0), m_target(GL_TEXTURE_2D), m_texture(texture), m_uv_rect(0, 0, 1, 1), m_layer(0),
+		m_owns_texture(true), m_byte_size(0), m_layers(), m_mix_modes(),
+		m_memory(profile::MemoryTracker::MATERIALS, 0) {
 		
 		if (texture.loaded()) {
 			glGenTextures(1, &m_id);
-			glBindTexture(GL_TEXTURE_2D, m_id);
+			GLBackend::current().bind_texture(GL_TEXTURE_2D, m_id);
 			GLint internalFormat = GL_RGBA;
 			GLenum format = texture.channels() == 3 ? GL_RGB : GL_RGBA;
 			GLenum type = GL_UNSIGNED_BYTE;
@@ -31,14 +39,59 @@ namespace engine::render {
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 			
+			// RGBA8 base level plus the mip chain
+			for (int w = texture.width(), h = texture.height(); ; w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+				m_byte_size += static_cast<size_t>(w) * h * 4;
+				if (w == 1 && h == 1) {
+					break;
+				}
+			}
+			profile::MemoryTracker::track(profile::MemoryTracker::TEXTURE, m_id, m_byte_size, texture.path());
+			
 			std::cout << "Loaded texture into OpenGL: " << texture.path() << std::endl;
+			
+			s_materials.push_back(*this);
 		}
 		else {
 			std::cerr << "Texture is not loaded: " << texture.path() << std::endl;
 		}
 	}
+	Material::Material(const graphics::TextureAtlas& atlas, int region)
+		: m_id(0), m_target(GL_TEXTURE_2D), m_texture(), m_uv_rect(0, 0, 1, 1), m_layer(0), m_owns_texture(false),
+		m_byte_size(0), m_layers(), m_mix_modes(),
+		m_memory(profile::MemoryTracker::MATERIALS, 0) {
+		
+		if (region < 0 || static_cast<size_t>(region) >= atlas.size()) {
+			std::cerr << "Atlas " << atlas.id() << " has no region " << region << std::endl;
+			return;
+		}
+		m_id = atlas.id();
+		m_uv_rect = atlas.region(region).uv_rect;
+	}
+	Material::Material(const graphics::TextureArray& array, int layer)
+		: m_id(0), m_target(GL_TEXTURE_2D_ARRAY), m_texture(), m_uv_rect(0, 0, 1, 1), m_layer(0),
+		m_owns_texture(false), m_byte_size(0), m_layers(), m_mix_modes(),
+		m_memory(profile::MemoryTracker::MATERIALS, 0) {
+		
+		if (layer < 0 || static_cast<size_t>(layer) >= array.layers()) {
+			std::cerr << "Texture array " << array.id() << " has no layer " << layer << std::endl;
+			return;
+		}
+		m_id = array.id();
+		m_layer = layer;
+	}
+	Material::Material(const graphics::TextureResidency& residency, graphics::TextureResidency::Handle handle)
+		: m_id(residency.id(handle)), m_target(GL_TEXTURE_2D), m_texture(), m_uv_rect(0, 0, 1, 1), m_layer(0),
+		m_owns_texture(false), m_byte_size(0), m_layers(), m_mix_modes(),
+		m_memory(profile::MemoryTracker::MATERIALS, 0) {
+	}
 	void Material::destroy() const {
-		glDeleteTextures(1, &m_id);
+		// Atlas, array and streamed textures are shared and destroyed by their owner
+		if (!m_owns_texture) {
+			return;
+		}
+		GLBackend::current().delete_texture(m_id);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::TEXTURE, m_id);
 		
 		erase_if(s_materials, [this](const Material& material) {
 			return m_id == material.m_id;
@@ -47,9 +100,109 @@ namespace engine::render {
 	unsigned int Material::id() const {
 		return m_id;
 	}
+	unsigned int Material::target() const {
+		return m_target;
+	}
 	graphics::Texture Material::texture() const {
 		return m_texture;
 	}
+	const math::Vec4& Material::uv_rect() const {
+		return m_uv_rect;
+	}
+	int Material::layer() const {
+		return m_layer;
+	}
+	size_t Material::byte_size() const {
+		return m_byte_size;
+	}
+	bool Material::shares_texture(const Material& other) const {
+		return m_id == other.m_id && m_target == other.m_target;
+	}
+	
+	Material& Material::add_layer(const Material& layer, graphics::TextureMixingMode mode) {
+		if (layer.m_id == 0) {
+			std::cerr << "Cannot add a layer without a texture" << std::endl;
+			return *this;
+		}
+		// One sampler array holds all textures, so they have to be of the same kind
+		if (layer.m_target != m_target) {
+			std::cerr << "Cannot mix texture array layers and 2D textures in one material" << std::endl;
+			return *this;
+		}
+		m_layers.push_back(layer);
+		m_mix_modes.push_back(mode);
+		m_memory.resize(m_layers.size() * sizeof(Material) + m_mix_modes.size() * sizeof(graphics::TextureMixingMode));
+		return *this;
+	}
+	size_t Material::texture_count() const {
+		return m_id == 0 ? 0 : 1 + m_layers.size();
+	}
+	const std::vector<graphics::TextureMixingMode>& Material::mix_modes() const {
+		return m_mix_modes;
+	}
+	std::vector<std::string> Material::variant_defines() const {
+		size_t count = texture_count();
+		std::vector<std::string> defines;
+		defines.push_back("TEX_COUNT " + std::to_string(count));
+		
+		std::string layers = "MIX_LAYERS";
+		std::set<int> modes;
+		for (size_t i = 1; i < count; i++) {
+			int mode = static_cast<int>(m_mix_modes[i - 1]);
+			layers += " MIX_LAYER(" + std::to_string(i) + ", " + std::to_string(mode) + ")";
+			modes.insert(mode);
+		}
+		defines.push_back(layers);
+		if (m_target == GL_TEXTURE_2D_ARRAY) {
+			defines.push_back("TEX_ARRAY");
+		}
+		// Only the used branches of mix() get compiled
+		for (int mode : modes) {
+			defines.push_back("USE_MIX_MODE_" + std::to_string(mode));
+		}
+		return defines;
+	}
+	const Shader& Material::shader(ShaderVariants& variants, const std::vector<std::string>& extraDefines) const {
+		if (extraDefines.empty()) {
+			return variants.get(variant_defines());
+		}
+		std::vector<std::string> defines = variant_defines();
+		defines.insert(defines.end(), extraDefines.begin(), extraDefines.end());
+		return variants.get(defines);
+	}
+	void Material::bind(const Shader& shader) const {
+		size_t count = texture_count();
+		if (count == 0) {
+			return;
+		}
+		GLBackend& backend = GLBackend::current();
+		std::vector<int> units(count);
+		std::vector<math::Vec4> uv_rects(count);
+		std::vector<int> layers(count);
+		for (size_t i = 0; i < count; i++) {
+			const Material& material = i == 0 ? *this : m_layers[i - 1];
+			backend.active_texture(i);
+			backend.bind_texture(material.m_target, material.m_id);
+			units[i] = static_cast<int>(i);
+			uv_rects[i] = material.m_uv_rect;
+			layers[i] = material.m_layer;
+		}
+		shader.set_int("textures", units);
+		shader.set_vec4("uvRects", uv_rects);
+		if (m_target == GL_TEXTURE_2D_ARRAY) {
+			shader.set_int("layers", layers);
+		}
+	}
+	void Material::set_mix_uniforms(const Shader& shader) const {
+		std::vector<int> modes(m_mix_modes.size());
+		for (size_t i = 0; i < m_mix_modes.size(); i++) {
+			modes[i] = static_cast<int>(m_mix_modes[i]);
+		}
+		shader.set_int("texCount", static_cast<int>(texture_count()));
+		if (!modes.empty()) {
+			shader.set_int("mixModes", modes);
+		}
+	}
 	void Material::destroyAll() {
 		while (!s_materials.empty()) {
 			s_materials.back().destroy();
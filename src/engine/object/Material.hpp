@@ -4,16 +4,40 @@
 #include <vector>
 
 #include "../graphics/Texture.hpp"
+#include "../graphics/TextureAtlas.hpp"
+#include "../graphics/TextureArray.hpp"
+#include "../graphics/TextureResidency.hpp"
+#include "../graphics/TextureMixingMode.hpp"
+#include "../render/Shader.hpp"
+#include "../render/ShaderVariants.hpp"
+#include "../profile/MemoryTracker.hpp"
+#include "../math/Vec4.hpp"
 
 namespace engine::render {
 	
 	class Material {
 	private:
 		unsigned int m_id;
+		unsigned int m_target;
 		graphics::Texture m_texture;
+		
+		// Sub-rectangle (atlas) or layer (texture array) of a shared texture
+		math::Vec4 m_uv_rect;
+		int m_layer;
+		bool m_owns_texture;
+		// GPU memory of the owned texture including mipmaps
+		size_t m_byte_size;
+		
+		// Textures blended over this one, in order
+		std::vector<Material> m_layers;
+		std::vector<graphics::TextureMixingMode> m_mix_modes;
+		profile::MemoryTracker::Allocation m_memory;
 	public:
 		Material();
 		Material(graphics::Texture& texture);
+		Material(const graphics::TextureAtlas& atlas, int region);
+		Material(const graphics::TextureArray& array, int layer);
+		Material(const graphics::TextureResidency& residency, graphics::TextureResidency::Handle handle);
 		
 		Material(const Material&) = default;
 		Material(Material&&) = default;
@@ -24,7 +48,39 @@ namespace engine::render {
 		void destroy() const;
 		
 		unsigned int id() const;
+		unsigned int target() const;
 		graphics::Texture texture() const;
+		const math::Vec4& uv_rect() const;
+		int layer() const;
+		size_t byte_size() const;
+		
+		/**
+		 * Whether both materials can be drawn with the same texture bind.
+		 */
+		bool shares_texture(const Material& other) const;
+		
+		Material& add_layer(const Material& layer, graphics::TextureMixingMode mode);
+		size_t texture_count() const;
+		const std::vector<graphics::TextureMixingMode>& mix_modes() const;
+		
+		/**
+		 * Defines of the tex_mix permutation with this material's texture count and mix modes baked in.
+		 */
+		std::vector<std::string> variant_defines() const;
+		/**
+		 * @param extraDefines appended to variant_defines(), e.g. "INSTANCED"
+		 */
+		const Shader& shader(ShaderVariants& variants, const std::vector<std::string>& extraDefines = {}) const;
+		/**
+		 * Binds the textures to the units 0..texture_count()-1 and sets the sampler, uv rect and, for
+		 * texture array materials, layer uniforms.
+		 */
+		void bind(const Shader& shader) const;
+		/**
+		 * Sets the texture count and mix mode uniforms read by the unspecialized tex_mix shader, which
+		 * only samples 2D textures.
+		 */
+		void set_mix_uniforms(const Shader& shader) const;
 	private:
 		static std::vector<Material> s_materials;
 	
@@ -3,52 +3,76 @@
 #include <iostream>
 #include "GL/glew.h"
 
+#include "../render/GLBackend.hpp"
+#include "../render/GeometryArena.hpp"
+#include "../render/RenderStats.hpp"
+#include "../jobs/JobSystem.hpp"
+#include "../profile/Profiler.hpp"
+
 namespace engine::render {
 	std::vector<Mesh> Mesh::s_meshes;
-	Mesh::Mesh() : m_vertices(), m_indices(), m_vao(0), m_vbo(0), m_ibo(0) {
+	Mesh::Mesh()
+		: m_vertices(), m_indices(), m_bounds(), m_bounding_sphere(), m_vao(0), m_vbo(0), m_ibo(0), m_arena(nullptr), m_base_vertex(0), m_first_index(0), m_memory() {
 	}
 	Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
-		: m_vertices(vertices), m_indices(indices) {
+		: m_vertices(vertices), m_indices(indices), m_arena(nullptr), m_base_vertex(0), m_first_index(0),
+		m_memory(profile::MemoryTracker::MESHES, data_bytes(vertices, indices)) {
+		PROFILE_SCOPE("Mesh::load");
+		compute_bounds();
+		
+		GLBackend& backend = GLBackend::current();
 		glGenVertexArrays(1, &m_vao);
-		glBindVertexArray(m_vao);
+		backend.bind_vertex_array(m_vao);
 		
 		glGenBuffers(1, &m_vbo);
-		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-		float data[vertices.size() * 5];
-		for (size_t i = 0; i < vertices.size(); i++) {
-			data[i * 5 + 0] = vertices[i].position.x();
-			data[i * 5 + 1] = vertices[i].position.y();
-			data[i * 5 + 2] = vertices[i].position.z();
-			data[i * 5 + 3] = vertices[i].texCoord.x();
-			data[i * 5 + 4] = vertices[i].texCoord.y();
-		}
-		glBufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
+		backend.bind_buffer(GL_ARRAY_BUFFER, m_vbo);
+		std::vector<float> data = interleave(vertices);
+		glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_STATIC_DRAW);
 		
 		glGenBuffers(1, &m_ibo);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+		backend.bind_buffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+		RenderStats::add(RenderStats::BUFFER_BYTES, data.size() * sizeof(float) + indices.size() * sizeof(unsigned int));
+		profile::MemoryTracker::track(profile::MemoryTracker::BUFFER, m_vbo, data.size() * sizeof(float), "mesh vertices");
+		profile::MemoryTracker::track(profile::MemoryTracker::BUFFER, m_ibo, indices.size() * sizeof(unsigned int),
+			"mesh indices");
 		
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) 0);
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) (3 * sizeof(float)));
 		glEnableVertexAttribArray(1);
 		
-		glBindVertexArray(0);
+		backend.bind_vertex_array(0);
+		backend.bind_buffer(GL_ARRAY_BUFFER, 0);
 		
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		s_meshes.push_back(*this);
+	}
+	Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, GeometryArena& arena)
+		: m_vertices(vertices), m_indices(indices), m_vao(0), m_vbo(0), m_ibo(0), m_arena(&arena),
+		m_memory(profile::MemoryTracker::MESHES, data_bytes(vertices, indices)) {
+		PROFILE_SCOPE("Mesh::load");
+		compute_bounds();
+		
+		ArenaRange range = arena.allocate(vertices, indices);
+		m_base_vertex = range.base_vertex;
+		m_first_index = range.first_index;
 		
 		s_meshes.push_back(*this);
 	}
 	
 	void Mesh::draw() const {
-		glBindVertexArray(m_vao);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-		
+		PROFILE_SCOPE("Mesh::draw");
+		RenderStats::add(RenderStats::DRAW_CALLS);
+		RenderStats::add(RenderStats::TRIANGLES, m_indices.size() / 3);
+		// The VAO holds the index buffer, and it stays bound so drawing the same mesh again costs no bind
+		if (m_arena) {
+			GLBackend::current().bind_vertex_array(m_arena->vao());
+			glDrawElementsBaseVertex(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT,
+				(void*) (m_first_index * sizeof(unsigned int)), m_base_vertex);
+			return;
+		}
+		GLBackend::current().bind_vertex_array(m_vao);
 		glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0);
-		
-		glBindVertexArray(0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
 	
 	const std::vector<Vertex>& Mesh::vertices() const {
@@ -57,54 +81,119 @@ namespace engine::render {
 	const std::vector<unsigned int>& Mesh::indices() const {
 		return m_indices;
 	}
+	const math::AABB& Mesh::bounds() const {
+		return m_bounds;
+	}
+	const math::Sphere& Mesh::bounding_sphere() const {
+		return m_bounding_sphere;
+	}
 	unsigned int Mesh::vao() const {
-		return m_vao;
+		return m_arena ? m_arena->vao() : m_vao;
 	}
 	unsigned int Mesh::vbo() const {
-		return m_vbo;
+		return m_arena ? m_arena->vbo() : m_vbo;
 	}
 	unsigned int Mesh::ibo() const {
-		return m_ibo;
+		return m_arena ? m_arena->ibo() : m_ibo;
+	}
+	GeometryArena* Mesh::arena() const {
+		return m_arena;
+	}
+	int Mesh::base_vertex() const {
+		return m_base_vertex;
+	}
+	unsigned int Mesh::first_index() const {
+		return m_first_index;
 	}
 	void Mesh::destroy() const {
+		if (m_arena) {
+			std::cout << "Destroying mesh (arena vao=" << m_arena->vao() << ", first index=" << m_first_index << ")"
+				<< std::endl;
+			m_arena->free({
+				m_base_vertex, static_cast<unsigned int>(m_vertices.size()),
+				m_first_index, static_cast<unsigned int>(m_indices.size())
+			});
+			erase_if(s_meshes, [this](const Mesh& mesh) {
+				return mesh.m_arena == m_arena && mesh.m_first_index == m_first_index;
+			});
+			return;
+		}
 		std::cout << "Destroying mesh (vao=" << m_vao << ", vbo=" << m_vbo << ", ibo=" << m_ibo << ")" << std::endl;
-		glDeleteVertexArrays(1, &m_vao);
-		glDeleteBuffers(1, &m_vbo);
-		glDeleteBuffers(1, &m_ibo);
+		GLBackend::current().delete_vertex_array(m_vao);
+		GLBackend::current().delete_buffer(m_vbo);
+		GLBackend::current().delete_buffer(m_ibo);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::BUFFER, m_vbo);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::BUFFER, m_ibo);
 		
 		erase_if(s_meshes, [this](const Mesh& mesh) {
-			return mesh.m_vao == m_vao;
+			return !mesh.m_arena && mesh.m_vao == m_vao;
 		});
 	}
 	
-	Mesh Mesh::fromHeightmap(graphics::Texture& heightmap, float height_scale, int width, int height) {
-		std::vector<Vertex> vertices;
-		std::vector<unsigned int> indices;
-		for (int y0 = 0; y0 < height; y0++) {
-			for (int x0 = 0; x0 < width; x0++) {
-				float u = (float) x0 / (width - 1);
-				float v = (float) y0 / (height - 1);
-				float x = u * 2.0f - 1.0f;
-				float y = v * 2.0f - 1.0f;
-				float z = 0.0f;
-				math::Vec4 s = heightmap.sample(u, v) * 2.0f - 1.0f;
-				float h = s.x() * height_scale;
-				vertices.push_back(Vertex(math::Vec3(x, y, z + h), math::Vec2(u, v)));
+	Mesh Mesh::fromHeightmap(graphics::Texture& heightmap, float height_scale, int width, int height,
+		GeometryArena* arena) {
+		PROFILE_SCOPE("Mesh::fromHeightmap");
+		std::vector<Vertex> vertices(static_cast<size_t>(width) * height);
+		std::vector<unsigned int> indices(static_cast<size_t>(width - 1) * (height - 1) * 6);
+		// Rows are independent, so vertices and indices are written in place from all workers
+		jobs::JobSystem::shared().parallel_for(0, height, 0, [&](size_t begin, size_t end) {
+			for (int y0 = static_cast<int>(begin); y0 < static_cast<int>(end); y0++) {
+				for (int x0 = 0; x0 < width; x0++) {
+					float u = (float) x0 / (width - 1);
+					float v = (float) y0 / (height - 1);
+					float x = u * 2.0f - 1.0f;
+					float y = v * 2.0f - 1.0f;
+					float z = 0.0f;
+					math::Vec4 s = heightmap.sample(u, v) * 2.0f - 1.0f;
+					float h = s.x() * height_scale;
+					vertices[y0 * width + x0] = Vertex(math::Vec3(x, y, z + h), math::Vec2(u, v));
+				}
 			}
-		}
-		for (int z = 0; z < height - 1; z++) {
-			for (int x = 0; x < width - 1; x++) {
-				indices.push_back(z * width + x);
-				indices.push_back(z * width + x + 1);
-				indices.push_back((z + 1) * width + x);
-				indices.push_back((z + 1) * width + x);
-				indices.push_back(z * width + x + 1);
-				indices.push_back((z + 1) * width + x + 1);
+		});
+		jobs::JobSystem::shared().parallel_for(0, height - 1, 0, [&](size_t begin, size_t end) {
+			for (int z = static_cast<int>(begin); z < static_cast<int>(end); z++) {
+				unsigned int* quad = &indices[static_cast<size_t>(z) * (width - 1) * 6];
+				for (int x = 0; x < width - 1; x++) {
+					*quad++ = z * width + x;
+					*quad++ = z * width + x + 1;
+					*quad++ = (z + 1) * width + x;
+					*quad++ = (z + 1) * width + x;
+					*quad++ = z * width + x + 1;
+					*quad++ = (z + 1) * width + x + 1;
+				}
 			}
+		});
+		if (arena != nullptr) {
+			return Mesh(vertices, indices, *arena);
 		}
 		return Mesh(vertices, indices);
 	}
 	
+	std::vector<float> Mesh::interleave(const std::vector<Vertex>& vertices) {
+		std::vector<float> data(vertices.size() * 5);
+		for (size_t i = 0; i < vertices.size(); i++) {
+			data[i * 5 + 0] = vertices[i].position.x();
+			data[i * 5 + 1] = vertices[i].position.y();
+			data[i * 5 + 2] = vertices[i].position.z();
+			data[i * 5 + 3] = vertices[i].texCoord.x();
+			data[i * 5 + 4] = vertices[i].texCoord.y();
+		}
+		return data;
+	}
+	
+	size_t Mesh::data_bytes(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
+		return vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int);
+	}
+	
+	void Mesh::compute_bounds() {
+		std::vector<math::Vec3> positions(m_vertices.size());
+		for (size_t i = 0; i < m_vertices.size(); i++) {
+			positions[i] = m_vertices[i].position;
+		}
+		m_bounds = math::AABB::fromPoints(positions);
+		m_bounding_sphere = math::Sphere::fromPoints(positions);
+	}
+	
 	void Mesh::destroyAll() {
 		while (!s_meshes.empty()) {
 			s_meshes.back().destroy();
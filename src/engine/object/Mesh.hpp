@@ -5,10 +5,15 @@
 #include "../math/Vec2.hpp"
 #include "../math/Vec3.hpp"
 #include "../math/Vec4.hpp"
+#include "../math/AABB.hpp"
+#include "../math/Sphere.hpp"
 #include "../graphics/Texture.hpp"
+#include "../profile/MemoryTracker.hpp"
 
 namespace engine::render {
 	
+	class GeometryArena;
+	
 	struct Vertex {
 		math::Vec3 position;
 		math::Vec2 texCoord;
@@ -20,12 +25,28 @@ namespace engine::render {
 		std::vector<Vertex> m_vertices;
 		std::vector<unsigned int> m_indices;
 		
+		// Object space bounds, computed once at construction
+		math::AABB m_bounds;
+		math::Sphere m_bounding_sphere;
+		
 		// OpenGL
 		unsigned int m_vao, m_vbo, m_ibo;
+		
+		// Set when the mesh lives in a shared arena instead of its own buffers
+		GeometryArena* m_arena;
+		int m_base_vertex;
+		unsigned int m_first_index;
+		
+		// Vertex and index data, counted again for every copy
+		profile::MemoryTracker::Allocation m_memory;
 	
 	public:
 		Mesh();
 		Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+		/**
+		 * Sub-allocates the mesh in the arena, which has to outlive it.
+		 */
+		Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, GeometryArena& arena);
 		
 		Mesh(const Mesh& other) = default;
 		Mesh(Mesh&& other) noexcept = default;
@@ -37,16 +58,34 @@ namespace engine::render {
 		
 		const std::vector<Vertex>& vertices() const;
 		const std::vector<unsigned int>& indices() const;
+		const math::AABB& bounds() const;
+		const math::Sphere& bounding_sphere() const;
 		
 		unsigned int vao() const;
 		unsigned int vbo() const;
 		unsigned int ibo() const;
 		
+		GeometryArena* arena() const;
+		int base_vertex() const;
+		unsigned int first_index() const;
+		
 		void destroy() const;
 		
-		static Mesh fromHeightmap(graphics::Texture& heightmap, float height_scale, int width, int height);
+		/**
+		 * Sub-allocated in the arena if one is given.
+		 */
+		static Mesh fromHeightmap(graphics::Texture& heightmap, float height_scale, int width, int height,
+			GeometryArena* arena = nullptr);
+		
+		/**
+		 * Vertex data in the buffer layout: position xyz, texture coordinate uv.
+		 */
+		static std::vector<float> interleave(const std::vector<Vertex>& vertices);
 	
 	private:
+		void compute_bounds();
+		static size_t data_bytes(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+		
 		static std::vector<Mesh> s_meshes;
 	public:
 		static void destroyAll();
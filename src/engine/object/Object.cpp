@@ -2,11 +2,13 @@
 
 namespace engine::object {
 	Object::Object()
-		: m_mesh(), m_position(), m_rotation(), m_scale(), m_albedo() {
+		: m_mesh(), m_position(), m_rotation(), m_scale(), m_albedo(), m_material(nullptr), m_graph(nullptr),
+		m_node(scene::SceneGraph::NONE), m_memory(profile::MemoryTracker::OBJECTS, sizeof(Object)) {
 	}
 	Object::Object(const render::Mesh& mesh)
 		: m_mesh(mesh), m_position(math::Vec3::ZERO), m_rotation(math::Vec3::ZERO),
-		m_scale(math::Vec3::ONE), m_albedo(math::Vec3::ONE) {
+		m_scale(math::Vec3::ONE), m_albedo(math::Vec3::ONE), m_material(nullptr), m_graph(nullptr), m_node(scene::SceneGraph::NONE),
+		m_memory(profile::MemoryTracker::OBJECTS, sizeof(Object)) {
 	}
 	const render::Mesh& Object::mesh() const {
 		return m_mesh;
@@ -23,6 +25,9 @@ namespace engine::object {
 	const math::Vec4& Object::albedo() const {
 		return m_albedo;
 	}
+	const render::Material* Object::material() const {
+		return m_material;
+	}
 	render::Mesh& Object::mesh() {
 		return m_mesh;
 	}
@@ -38,6 +43,18 @@ namespace engine::object {
 	math::Vec4& Object::albedo() {
 		return m_albedo;
 	}
+	Object& Object::material(const render::Material* material) {
+		m_material = material;
+		return *this;
+	}
+	Object& Object::node(const scene::SceneGraph* graph, int node) {
+		m_graph = graph;
+		m_node = node;
+		return *this;
+	}
+	int Object::node() const {
+		return m_node;
+	}
 	const math::Mat4 Object::model() const {
 		math::Mat4 rot_x = math::Mat4::rotation(m_rotation.x(), math::Vec3::UNIT_X);
 		math::Mat4 rot_y = math::Mat4::rotation(m_rotation.y(), math::Vec3::UNIT_Y);
@@ -46,6 +63,9 @@ namespace engine::object {
 		math::Mat4 translation = math::Mat4::translation(m_position);
 		math::Mat4 rotation = rot_x * rot_y * rot_z;
 		math::Mat4 model = translation * rotation * scale;
+		if (m_graph != nullptr) {
+			return m_graph->world(m_node) * model;
+		}
 		return model;
 	}
 } // engine::object
\ No newline at end of file
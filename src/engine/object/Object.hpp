@@ -5,6 +5,8 @@
 #include "../math/Vec4.hpp"
 #include "../math/Mat4.hpp"
 #include "Renderable.hpp"
+#include "../scene/SceneGraph.hpp"
+#include "../profile/MemoryTracker.hpp"
 
 namespace engine::object {
 	
@@ -15,6 +17,10 @@ namespace engine::object {
 		math::Vec3 m_rotation;
 		math::Vec3 m_scale;
 		math::Vec4 m_albedo;
+		const render::Material* m_material;
+		const scene::SceneGraph* m_graph;
+		int m_node;
+		profile::MemoryTracker::Allocation m_memory;
 	public:
 		Object();
 		Object(const render::Mesh& mesh);
@@ -30,16 +36,24 @@ namespace engine::object {
 		const math::Vec3& rotation() const;
 		const math::Vec3& scale() const;
 		const math::Vec4& albedo() const;
+		const render::Material* material() const;
 		
 		render::Mesh& mesh();
 		math::Vec3& position();
 		math::Vec3& rotation();
 		math::Vec3& scale();
 		math::Vec4& albedo();
+		Object& material(const render::Material* material);
+		/**
+		 * Attaches the object to a scene graph node; position, rotation and scale become relative to it.
+		 * The graph must outlive the object.
+		 */
+		Object& node(const scene::SceneGraph* graph, int node);
+		int node() const;
 		
 		const math::Mat4 model() const;
 		
-		const render::Mesh get_mesh() const override {
+		const render::Mesh& get_mesh() const override {
 			return m_mesh;
 		}
 		const math::Vec4 get_albedo() const override {
@@ -48,6 +62,9 @@ namespace engine::object {
 		const math::Mat4 get_model() const override {
 			return model();
 		}
+		const render::Material* get_material() const override {
+			return m_material;
+		}
 	};
 	
 } // engine::object
@@ -2,16 +2,27 @@
 
 #include "Mesh.hpp"
 
+namespace engine::render {
+	class Material;
+}
+
 namespace engine::object {
 	
 	class Renderable {
 	public:
-		virtual const render::Mesh get_mesh() const = 0;
+		// Returned by reference, the render loop asks for it once per object and frame
+		virtual const render::Mesh& get_mesh() const = 0;
 		virtual const math::Vec4 get_albedo() const {
 			static math::Vec4 albedo(1, 1, 1, 1);
 			return albedo;
 		}
 		virtual const math::Mat4 get_model() const = 0;
+		/**
+		 * nullptr draws with the pass' default material.
+		 */
+		virtual const render::Material* get_material() const {
+			return nullptr;
+		}
 	};
 	
 } // engine::object
@@ -0,0 +1,75 @@
+#include "GpuProfiler.hpp"
+
+#include <algorithm>
+
+#include "GL/glew.h"
+
+namespace engine::profile {
+	GpuProfiler::GpuProfiler()
+		: m_frames(), m_free_queries(), m_frame(0), m_open(false), m_gpu_time(0), m_track(nullptr) {
+	}
+	
+	void GpuProfiler::begin_frame() {
+		m_frame = (m_frame + 1) % FRAMES;
+		collect(m_frames[m_frame]);
+	}
+	
+	bool GpuProfiler::begin(const char* name) {
+		if (m_open || !supported()) {
+			return false;
+		}
+		if (m_free_queries.empty()) {
+			unsigned int query;
+			glGenQueries(1, &query);
+			m_free_queries.push_back(query);
+		}
+		unsigned int query = m_free_queries.back();
+		m_free_queries.pop_back();
+		
+		m_frames[m_frame].push_back({name, Profiler::now(), query});
+		glBeginQuery(GL_TIME_ELAPSED, query);
+		m_open = true;
+		return true;
+	}
+	void GpuProfiler::end() {
+		glEndQuery(GL_TIME_ELAPSED);
+		m_open = false;
+	}
+	
+	void GpuProfiler::destroy() {
+		for (std::vector<Range>& ranges : m_frames) {
+			for (const Range& range : ranges) {
+				m_free_queries.push_back(range.query);
+			}
+			ranges.clear();
+		}
+		if (!m_free_queries.empty()) {
+			glDeleteQueries((GLsizei) m_free_queries.size(), m_free_queries.data());
+		}
+		m_free_queries.clear();
+	}
+	
+	bool GpuProfiler::supported() {
+		return GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+	}
+	
+	void GpuProfiler::collect(std::vector<Range>& ranges) {
+		if (!ranges.empty() && m_track == nullptr) {
+			m_track = &Profiler::track("GPU");
+		}
+		for (const Range& range : ranges) {
+			// Four frames on, a result that still isn't there is dropped rather than waited for
+			GLuint available = 0;
+			glGetQueryObjectuiv(range.query, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available) {
+				GLuint64 elapsed = 0;
+				glGetQueryObjectui64v(range.query, GL_QUERY_RESULT, &elapsed);
+				int64_t start = std::max(range.submitted, m_gpu_time);
+				m_gpu_time = start + (int64_t) elapsed;
+				m_track->record(range.name, start, m_gpu_time);
+			}
+			m_free_queries.push_back(range.query);
+		}
+		ranges.clear();
+	}
+} // engine::profile
\ No newline at end of file
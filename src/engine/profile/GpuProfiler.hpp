@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Profiler.hpp"
+
+namespace engine::profile {
+	
+	/**
+	 * Times GPU work with GL_TIME_ELAPSED queries and records the ranges on the profiler's "GPU"
+	 * track. Results are read FRAMES frames later, once the GPU is done with them, so timing never
+	 * stalls the pipeline. Elapsed queries can't nest: a range begun inside another one is skipped.
+	 * The queries only measure durations, so each range is placed at the time its commands were
+	 * submitted, or right after the previous range if the GPU was still busy with that.
+	 * GL thread only; does nothing while the profiler is disabled.
+	 */
+	class GpuProfiler {
+	public:
+		static constexpr int FRAMES = 4;
+	
+	private:
+		struct Range {
+			const char* name;
+			int64_t submitted;
+			unsigned int query;
+		};
+		
+		std::vector<Range> m_frames[FRAMES];
+		std::vector<unsigned int> m_free_queries;
+		int m_frame;
+		bool m_open;
+		int64_t m_gpu_time;
+		Profiler::Track* m_track;
+	
+	public:
+		GpuProfiler();
+		
+		GpuProfiler(const GpuProfiler& other) = default;
+		GpuProfiler(GpuProfiler&& other) noexcept = default;
+		GpuProfiler& operator=(const GpuProfiler& other) = default;
+		GpuProfiler& operator=(GpuProfiler&& other) noexcept = default;
+		~GpuProfiler() = default;
+		
+		/**
+		 * Call once per frame, before any range. Records the results of the frame FRAMES ago.
+		 */
+		void begin_frame();
+		/**
+		 * @return whether the range was started; only then call end()
+		 */
+		bool begin(const char* name);
+		void end();
+		
+		void destroy();
+		
+		/**
+		 * Whether timer queries are available.
+		 */
+		static bool supported();
+	
+	private:
+		void collect(std::vector<Range>& ranges);
+	};
+	
+	/**
+	 * Times the GPU work submitted from construction to destruction. Use GPU_PROFILE_SCOPE.
+	 */
+	class GpuScope {
+	private:
+		GpuProfiler* m_profiler;
+	
+	public:
+		GpuScope(GpuProfiler& profiler, const char* name)
+			: m_profiler(Profiler::enabled() && profiler.begin(name) ? &profiler : nullptr) {
+		}
+		
+		GpuScope(const GpuScope& other) = delete;
+		GpuScope(GpuScope&& other) noexcept = delete;
+		GpuScope& operator=(const GpuScope& other) = delete;
+		GpuScope& operator=(GpuScope&& other) noexcept = delete;
+		~GpuScope() {
+			if (m_profiler != nullptr) {
+				m_profiler->end();
+			}
+		}
+	};
+	
+} // engine::profile
+
+#ifdef ENGINE_PROFILE
+#define GPU_PROFILE_SCOPE(profiler, name) ::engine::profile::GpuScope PROFILE_CONCAT(gpu_profile_scope_, __LINE__)(profiler, name)
+#else
+#define GPU_PROFILE_SCOPE(profiler, name) ((void) 0)
+#endif
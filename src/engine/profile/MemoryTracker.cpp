@@ -0,0 +1,250 @@
+#include "MemoryTracker.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace engine::profile {
+	MemoryTracker::Counter MemoryTracker::s_cpu[SUBSYSTEM_COUNT] = {};
+	MemoryTracker::Counter MemoryTracker::s_cpu_total = {};
+	MemoryTracker::Counter MemoryTracker::s_gpu[RESOURCE_COUNT] = {};
+	MemoryTracker::Counter MemoryTracker::s_gpu_total = {};
+	std::unordered_map<uint64_t, MemoryTracker::Entry> MemoryTracker::s_resources;
+	std::mutex MemoryTracker::s_mutex;
+	
+	static const char* SUBSYSTEM_NAMES[MemoryTracker::SUBSYSTEM_COUNT] = {
+		"textures",
+		"meshes",
+		"materials",
+		"objects",
+		"shaders"
+	};
+	static const char* RESOURCE_NAMES[MemoryTracker::RESOURCE_COUNT] = {
+		"buffers",
+		"textures",
+		"renderbuffers",
+		"programs"
+	};
+	
+	// GL names are only unique per object type
+	static uint64_t resource_key(MemoryTracker::Resource resource, unsigned int id) {
+		return (static_cast<uint64_t>(resource) << 32) | id;
+	}
+	
+	static std::string format_bytes(size_t bytes) {
+		char text[32];
+		if (bytes >= 1024 * 1024) {
+			std::snprintf(text, sizeof(text), "%.2f MB", bytes / (1024.0 * 1024.0));
+		}
+		else if (bytes >= 1024) {
+			std::snprintf(text, sizeof(text), "%.2f KB", bytes / 1024.0);
+		}
+		else {
+			std::snprintf(text, sizeof(text), "%zu B", bytes);
+		}
+		return text;
+	}
+	
+	MemoryTracker::Allocation::Allocation() : m_subsystem(OBJECTS), m_bytes(0) {
+	}
+	MemoryTracker::Allocation::Allocation(Subsystem subsystem, size_t bytes) : m_subsystem(subsystem), m_bytes(bytes) {
+		if (m_bytes > 0) {
+			allocate(m_subsystem, m_bytes);
+		}
+	}
+	MemoryTracker::Allocation::Allocation(const Allocation& other) : Allocation(other.m_subsystem, other.m_bytes) {
+	}
+	MemoryTracker::Allocation::Allocation(Allocation&& other) noexcept
+		: m_subsystem(other.m_subsystem), m_bytes(other.m_bytes) {
+		other.m_bytes = 0;
+	}
+	MemoryTracker::Allocation& MemoryTracker::Allocation::operator=(const Allocation& other) {
+		if (this != &other) {
+			if (m_bytes > 0) {
+				release(m_subsystem, m_bytes);
+			}
+			m_subsystem = other.m_subsystem;
+			m_bytes = other.m_bytes;
+			if (m_bytes > 0) {
+				allocate(m_subsystem, m_bytes);
+			}
+		}
+		return *this;
+	}
+	MemoryTracker::Allocation& MemoryTracker::Allocation::operator=(Allocation&& other) noexcept {
+		if (this != &other) {
+			if (m_bytes > 0) {
+				release(m_subsystem, m_bytes);
+			}
+			m_subsystem = other.m_subsystem;
+			m_bytes = other.m_bytes;
+			other.m_bytes = 0;
+		}
+		return *this;
+	}
+	MemoryTracker::Allocation::~Allocation() {
+		if (m_bytes > 0) {
+			release(m_subsystem, m_bytes);
+		}
+	}
+	void MemoryTracker::Allocation::resize(size_t bytes) {
+		if (m_bytes > 0) {
+			release(m_subsystem, m_bytes);
+		}
+		m_bytes = bytes;
+		if (m_bytes > 0) {
+			allocate(m_subsystem, m_bytes);
+		}
+	}
+	size_t MemoryTracker::Allocation::bytes() const {
+		return m_bytes;
+	}
+	
+	void MemoryTracker::allocate(Subsystem subsystem, size_t bytes) {
+		add(s_cpu[subsystem], bytes);
+		add(s_cpu_total, bytes);
+	}
+	void MemoryTracker::release(Subsystem subsystem, size_t bytes) {
+		remove(s_cpu[subsystem], bytes);
+		remove(s_cpu_total, bytes);
+	}
+	
+	void MemoryTracker::track(Resource resource, unsigned int id, size_t bytes, const std::string& label) {
+		if (id == 0) {
+			return;
+		}
+		std::lock_guard<std::mutex> lock(s_mutex);
+		auto [it, inserted] = s_resources.try_emplace(resource_key(resource, id), Entry{resource, 0, label});
+		if (!inserted) {
+			remove(s_gpu[resource], it->second.bytes);
+			remove(s_gpu_total, it->second.bytes);
+			it->second.label = label;
+		}
+		it->second.bytes = bytes;
+		add(s_gpu[resource], bytes);
+		add(s_gpu_total, bytes);
+	}
+	void MemoryTracker::resize(Resource resource, unsigned int id, size_t bytes) {
+		std::lock_guard<std::mutex> lock(s_mutex);
+		auto it = s_resources.find(resource_key(resource, id));
+		if (it == s_resources.end()) {
+			return;
+		}
+		remove(s_gpu[resource], it->second.bytes);
+		remove(s_gpu_total, it->second.bytes);
+		it->second.bytes = bytes;
+		add(s_gpu[resource], bytes);
+		add(s_gpu_total, bytes);
+	}
+	void MemoryTracker::untrack(Resource resource, unsigned int id) {
+		std::lock_guard<std::mutex> lock(s_mutex);
+		auto it = s_resources.find(resource_key(resource, id));
+		if (it == s_resources.end()) {
+			return;
+		}
+		remove(s_gpu[resource], it->second.bytes);
+		remove(s_gpu_total, it->second.bytes);
+		s_resources.erase(it);
+	}
+	
+	MemoryTracker::Usage MemoryTracker::cpu(Subsystem subsystem) {
+		return usage(s_cpu[subsystem]);
+	}
+	MemoryTracker::Usage MemoryTracker::cpu_total() {
+		return usage(s_cpu_total);
+	}
+	MemoryTracker::Usage MemoryTracker::gpu(Resource resource) {
+		return usage(s_gpu[resource]);
+	}
+	MemoryTracker::Usage MemoryTracker::gpu_total() {
+		return usage(s_gpu_total);
+	}
+	void MemoryTracker::reset_peaks() {
+		for (Counter& counter : s_cpu) {
+			counter.peak.store(counter.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		for (Counter& counter : s_gpu) {
+			counter.peak.store(counter.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		s_cpu_total.peak.store(s_cpu_total.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		s_gpu_total.peak.store(s_gpu_total.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+	
+	const char* MemoryTracker::name(Subsystem subsystem) {
+		return SUBSYSTEM_NAMES[subsystem];
+	}
+	const char* MemoryTracker::name(Resource resource) {
+		return RESOURCE_NAMES[resource];
+	}
+	
+	std::string MemoryTracker::report(size_t largest) {
+		std::string report;
+		char line[160];
+		auto row = [&](const char* name, const Usage& usage) {
+			std::snprintf(line, sizeof(line), "  %-14s %12s %12s %8zu\n", name, format_bytes(usage.current).c_str(),
+				format_bytes(usage.peak).c_str(), usage.count);
+			report += line;
+		};
+		
+		std::snprintf(line, sizeof(line), "CPU%-13s %12s %12s %8s\n", "", "current", "peak", "live");
+		report += line;
+		for (int i = 0; i < SUBSYSTEM_COUNT; i++) {
+			row(SUBSYSTEM_NAMES[i], cpu((Subsystem) i));
+		}
+		row("total", cpu_total());
+		
+		std::snprintf(line, sizeof(line), "GPU%-13s %12s %12s %8s\n", "", "current", "peak", "objects");
+		report += line;
+		for (int i = 0; i < RESOURCE_COUNT; i++) {
+			row(RESOURCE_NAMES[i], gpu((Resource) i));
+		}
+		row("total", gpu_total());
+		
+		std::vector<std::pair<uint64_t, Entry>> entries;
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			entries.assign(s_resources.begin(), s_resources.end());
+		}
+		size_t count = std::min(largest, entries.size());
+		std::partial_sort(entries.begin(), entries.begin() + count, entries.end(), [](const auto& a, const auto& b) {
+			return a.second.bytes > b.second.bytes;
+		});
+		if (count > 0) {
+			report += "Largest GPU objects\n";
+		}
+		for (size_t i = 0; i < count; i++) {
+			const Entry& entry = entries[i].second;
+			std::snprintf(line, sizeof(line), "  %-14s %6u %12s  %s\n", RESOURCE_NAMES[entry.resource],
+				static_cast<unsigned int>(entries[i].first), format_bytes(entry.bytes).c_str(), entry.label.c_str());
+			report += line;
+		}
+		return report;
+	}
+	bool MemoryTracker::write_report(const std::string& path) {
+		std::ofstream file(path);
+		if (!file) {
+			std::cerr << "Failed to write memory report to " << path << std::endl;
+			return false;
+		}
+		file << report(SIZE_MAX);
+		return (bool) file;
+	}
+	
+	void MemoryTracker::add(Counter& counter, size_t bytes) {
+		size_t current = counter.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		counter.count.fetch_add(1, std::memory_order_relaxed);
+		size_t peak = counter.peak.load(std::memory_order_relaxed);
+		while (current > peak && !counter.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+		}
+	}
+	void MemoryTracker::remove(Counter& counter, size_t bytes) {
+		counter.current.fetch_sub(bytes, std::memory_order_relaxed);
+		counter.count.fetch_sub(1, std::memory_order_relaxed);
+	}
+	MemoryTracker::Usage MemoryTracker::usage(const Counter& counter) {
+		return {counter.current.load(std::memory_order_relaxed), counter.peak.load(std::memory_order_relaxed),
+			counter.count.load(std::memory_order_relaxed)};
+	}
+} // engine::profile
\ No newline at end of file
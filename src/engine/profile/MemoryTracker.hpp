@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace engine::profile {
+	
+	/**
+	 * Current and peak memory per CPU subsystem and per kind of GL object, for finding what a large
+	 * scene spends its memory on.
+	 *
+	 * CPU bytes are attributed by the owning types, mostly through an Allocation member. Every copy of
+	 * an owner counts again, so the value copies held by the static registries and by objects show up
+	 * as live copies of the same data. GL objects are registered with their size and a label where they
+	 * are created and unregistered where they are deleted.
+	 *
+	 * The counters are atomic and may be updated from any thread; the GL object table takes a lock.
+	 */
+	class MemoryTracker {
+	public:
+		enum Subsystem {
+			TEXTURES,
+			MESHES,
+			MATERIALS,
+			OBJECTS,
+			SHADERS,
+			SUBSYSTEM_COUNT
+		};
+		enum Resource {
+			BUFFER,
+			TEXTURE,
+			RENDERBUFFER,
+			PROGRAM,
+			RESOURCE_COUNT
+		};
+		
+		struct Usage {
+			size_t current;
+			size_t peak;
+			// Live allocations or GL objects
+			size_t count;
+		};
+		
+		/**
+		 * Bytes owned by the object it is a member of, counted while that object is alive. Copies
+		 * count the bytes again, moves hand them over. Zero bytes are not counted as an allocation.
+		 */
+		class Allocation {
+		private:
+			Subsystem m_subsystem;
+			size_t m_bytes;
+		
+		public:
+			Allocation();
+			Allocation(Subsystem subsystem, size_t bytes);
+			
+			Allocation(const Allocation& other);
+			Allocation(Allocation&& other) noexcept;
+			Allocation& operator=(const Allocation& other);
+			Allocation& operator=(Allocation&& other) noexcept;
+			~Allocation();
+			
+			void resize(size_t bytes);
+			size_t bytes() const;
+		};
+	
+	private:
+		struct Counter {
+			std::atomic<size_t> current;
+			std::atomic<size_t> peak;
+			std::atomic<size_t> count;
+		};
+		struct Entry {
+			Resource resource;
+			size_t bytes;
+			std::string label;
+		};
+		
+		static Counter s_cpu[SUBSYSTEM_COUNT];
+		static Counter s_cpu_total;
+		static Counter s_gpu[RESOURCE_COUNT];
+		static Counter s_gpu_total;
+		static std::unordered_map<uint64_t, Entry> s_resources;
+		static std::mutex s_mutex;
+	
+	public:
+		static void allocate(Subsystem subsystem, size_t bytes);
+		static void release(Subsystem subsystem, size_t bytes);
+		
+		/**
+		 * Registers a GL object or updates its size, e.g. after a buffer was reallocated.
+		 */
+		static void track(Resource resource, unsigned int id, size_t bytes, const std::string& label);
+		/**
+		 * Updates the size of a registered GL object and keeps its label.
+		 */
+		static void resize(Resource resource, unsigned int id, size_t bytes);
+		static void untrack(Resource resource, unsigned int id);
+		
+		static Usage cpu(Subsystem subsystem);
+		static Usage cpu_total();
+		static Usage gpu(Resource resource);
+		static Usage gpu_total();
+		/**
+		 * Starts the peaks over from the current usage.
+		 */
+		static void reset_peaks();
+		
+		static const char* name(Subsystem subsystem);
+		static const char* name(Resource resource);
+		
+		/**
+		 * Usage per subsystem and GL object kind, followed by the largest GL objects.
+		 */
+		static std::string report(size_t largest = 10);
+		static bool write_report(const std::string& path);
+	
+	private:
+		static void add(Counter& counter, size_t bytes);
+		static void remove(Counter& counter, size_t bytes);
+		static Usage usage(const Counter& counter);
+	};
+	
+} // engine::profile
@@ -0,0 +1,143 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace engine::profile {
+	std::atomic<bool> Profiler::s_enabled(false);
+	std::atomic<int64_t> Profiler::s_cleared(0);
+	
+	// Every track ever created; they are never removed, so pointers to them stay valid
+	static std::mutex s_mutex;
+	static std::vector<std::unique_ptr<Profiler::Track>> s_tracks;
+	static thread_local Profiler::Track* t_track = nullptr;
+	
+	Profiler::Track::Track(const std::string& name, int id)
+		: m_name(name), m_id(id), m_events(new Slot[CAPACITY]), m_head(0) {
+	}
+	
+	void Profiler::Track::record(const char* name, int64_t start, int64_t end) {
+		uint64_t head = m_head.load(std::memory_order_relaxed);
+		Slot& slot = m_events[head % CAPACITY];
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.start.store(start, std::memory_order_relaxed);
+		slot.end.store(end, std::memory_order_relaxed);
+		m_head.store(head + 1, std::memory_order_release);
+	}
+	
+	const std::string& Profiler::Track::name() const {
+		return m_name;
+	}
+	int Profiler::Track::id() const {
+		return m_id;
+	}
+	
+	void Profiler::enable(bool enabled) {
+		epoch();
+		s_enabled.store(enabled, std::memory_order_relaxed);
+	}
+	
+	std::chrono::steady_clock::time_point Profiler::epoch() {
+		static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+		return epoch;
+	}
+	
+	void Profiler::record(const char* name, int64_t start, int64_t end) {
+		thread_track().record(name, start, end);
+	}
+	
+	void Profiler::set_thread_name(const std::string& name) {
+		Track& track = thread_track();
+		std::lock_guard<std::mutex> lock(s_mutex);
+		track.m_name = name;
+	}
+	
+	Profiler::Track& Profiler::track(const std::string& name) {
+		std::lock_guard<std::mutex> lock(s_mutex);
+		s_tracks.push_back(std::make_unique<Track>(name, (int) s_tracks.size() + 1));
+		return *s_tracks.back();
+	}
+	
+	Profiler::Track& Profiler::thread_track() {
+		if (t_track == nullptr) {
+			std::lock_guard<std::mutex> lock(s_mutex);
+			int id = (int) s_tracks.size() + 1;
+			s_tracks.push_back(std::make_unique<Track>("thread " + std::to_string(id), id));
+			t_track = s_tracks.back().get();
+		}
+		return *t_track;
+	}
+	
+	void Profiler::clear() {
+		s_cleared.store(now(), std::memory_order_relaxed);
+	}
+	
+	static void write_json_string(std::ofstream& file, const std::string& text) {
+		file << '"';
+		for (char c : text) {
+			if (c == '"' || c == '\\') {
+				file << '\\' << c;
+			}
+			else if ((unsigned char) c < 0x20) {
+				file << ' ';
+			}
+			else {
+				file << c;
+			}
+		}
+		file << '"';
+	}
+	
+	bool Profiler::write_chrome_trace(const std::string& path) {
+		std::ofstream file(path);
+		if (!file) {
+			std::cerr << "Failed to write profile to " << path << std::endl;
+			return false;
+		}
+		
+		int64_t cleared = s_cleared.load(std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lock(s_mutex);
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool first = true;
+		std::vector<Event> events;
+		for (const std::unique_ptr<Track>& track : s_tracks) {
+			file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track->m_id
+				<< ",\"args\":{\"name\":";
+			write_json_string(file, track->m_name);
+			file << "}}";
+			first = false;
+			
+			// Copy without stopping the writer, then drop the slots it may have reused meanwhile:
+			// it could be writing index head_after right now, which overwrites head_after - CAPACITY
+			uint64_t head = track->m_head.load(std::memory_order_acquire);
+			uint64_t begin = head > CAPACITY ? head - CAPACITY : 0;
+			events.clear();
+			for (uint64_t i = begin; i < head; i++) {
+				const Track::Slot& slot = track->m_events[i % CAPACITY];
+				events.push_back({slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+					slot.end.load(std::memory_order_relaxed)});
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			uint64_t head_after = track->m_head.load(std::memory_order_relaxed);
+			uint64_t valid = head_after + 1 > CAPACITY ? head_after + 1 - CAPACITY : 0;
+			
+			for (uint64_t i = std::max(begin, valid); i < head; i++) {
+				const Event& event = events[i - begin];
+				if (event.start < cleared) {
+					continue;
+				}
+				file << ",\n{\"name\":";
+				write_json_string(file, event.name);
+				// Timestamps are in microseconds
+				file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << track->m_id << ",\"ts\":" << event.start / 1000 << '.'
+					<< (event.start % 1000) / 100 << ",\"dur\":" << (event.end - event.start) / 1000 << '.'
+					<< ((event.end - event.start) % 1000) / 100 << "}";
+			}
+		}
+		file << "\n]}\n";
+		return (bool) file;
+	}
+} // engine::profile
\ No newline at end of file
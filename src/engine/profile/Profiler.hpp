@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace engine::profile {
+	
+	/**
+	 * Records named time ranges for the Chrome trace viewer / Perfetto. Every thread writes into its
+	 * own ring buffer, so recording takes no lock; the rings keep the latest CAPACITY ranges and
+	 * overwrite older ones. Ranges come from PROFILE_SCOPE or from other sources through tracks,
+	 * like GpuProfiler's GPU timings.
+	 *
+	 * Recording is off until enable(true). While off, a scope costs one relaxed atomic load; built
+	 * without ENGINE_PROFILE, PROFILE_SCOPE compiles to nothing.
+	 * Names are stored as pointers and must outlive the profiler, so pass string literals.
+	 */
+	class Profiler {
+	public:
+		// Ranges kept per thread or track
+		static constexpr size_t CAPACITY = 16384;
+		
+		struct Event {
+			const char* name;
+			// Nanoseconds since the profiler's epoch
+			int64_t start;
+			int64_t end;
+		};
+		
+		/**
+		 * Ring written by exactly one thread and read by write_chrome_trace() without locking: the
+		 * reader copies what it sees, then drops whatever the writer overwrote in the meantime.
+		 */
+		class Track {
+		private:
+			// Relaxed atomics so the racing reader is well-defined; they compile to plain moves
+			struct Slot {
+				std::atomic<const char*> name;
+				std::atomic<int64_t> start;
+				std::atomic<int64_t> end;
+			};
+			
+			std::string m_name;
+			int m_id;
+			std::unique_ptr<Slot[]> m_events;
+			std::atomic<uint64_t> m_head;
+		
+		public:
+			Track(const std::string& name, int id);
+			
+			Track(const Track& other) = delete;
+			Track(Track&& other) noexcept = delete;
+			Track& operator=(const Track& other) = delete;
+			Track& operator=(Track&& other) noexcept = delete;
+			~Track() = default;
+			
+			void record(const char* name, int64_t start, int64_t end);
+			
+			const std::string& name() const;
+			int id() const;
+			
+			friend class Profiler;
+		};
+	
+	private:
+		static std::atomic<bool> s_enabled;
+		// Ranges starting before this were cleared
+		static std::atomic<int64_t> s_cleared;
+	
+	public:
+		static void enable(bool enabled);
+		static bool enabled() {
+			return s_enabled.load(std::memory_order_relaxed);
+		}
+		
+		/**
+		 * Nanoseconds since the profiler's epoch, on steady_clock.
+		 */
+		static int64_t now() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch()).count();
+		}
+		static std::chrono::steady_clock::time_point epoch();
+		
+		/**
+		 * Records a range on the calling thread's track, creating the track on first use.
+		 */
+		static void record(const char* name, int64_t start, int64_t end);
+		/**
+		 * Names the calling thread's track in the trace.
+		 */
+		static void set_thread_name(const std::string& name);
+		/**
+		 * A track not bound to a thread, e.g. for GPU timings. Only one thread may record into it.
+		 * The profiler owns it; it lives until the program exits.
+		 */
+		static Track& track(const std::string& name);
+		
+		/**
+		 * Forgets every recorded range.
+		 */
+		static void clear();
+		/**
+		 * Writes all recorded ranges in the Chrome trace event format, viewable in chrome://tracing
+		 * or ui.perfetto.dev. Recording may go on meanwhile.
+		 * @return false if the file couldn't be written
+		 */
+		static bool write_chrome_trace(const std::string& path);
+	
+	private:
+		static Track& thread_track();
+	};
+	
+	/**
+	 * Records the time from construction to destruction on the calling thread. Use PROFILE_SCOPE.
+	 */
+	class Scope {
+	private:
+		const char* m_name;
+		int64_t m_start;
+	
+	public:
+		explicit Scope(const char* name) : m_name(name), m_start(Profiler::enabled() ? Profiler::now() : -1) {
+		}
+		
+		Scope(const Scope& other) = delete;
+		Scope(Scope&& other) noexcept = delete;
+		Scope& operator=(const Scope& other) = delete;
+		Scope& operator=(Scope&& other) noexcept = delete;
+		~Scope() {
+			if (m_start >= 0) {
+				Profiler::record(m_name, m_start, Profiler::now());
+			}
+		}
+	};
+	
+} // engine::profile
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENGINE_PROFILE
+// Times the rest of the enclosing block under the given string literal
+#define PROFILE_SCOPE(name) ::engine::profile::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+// Names the calling thread in the trace
+#define PROFILE_THREAD(name) ::engine::profile::Profiler::set_thread_name(name)
+#else
+#define PROFILE_SCOPE(name) ((void) 0)
+#define PROFILE_THREAD(name) ((void) 0)
+#endif
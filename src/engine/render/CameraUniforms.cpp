@@ -0,0 +1,65 @@
+#include "CameraUniforms.hpp"
+
+#include <iostream>
+#include <cstring>
+
+#include "GL/glew.h"
+
+#include "GLBackend.hpp"
+#include "RenderStats.hpp"
+#include "../profile/MemoryTracker.hpp"
+
+namespace engine::render {
+	CameraUniforms::CameraUniforms() : m_ubo(0) {
+	}
+	
+	CameraUniforms CameraUniforms::create() {
+		CameraUniforms uniforms;
+		glGenBuffers(1, &uniforms.m_ubo);
+		GLBackend::current().bind_buffer(GL_UNIFORM_BUFFER, uniforms.m_ubo);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+		GLBackend::current().bind_buffer(GL_UNIFORM_BUFFER, 0);
+		GLBackend::current().bind_buffer_base(GL_UNIFORM_BUFFER, BINDING, uniforms.m_ubo);
+		profile::MemoryTracker::track(profile::MemoryTracker::BUFFER, uniforms.m_ubo, sizeof(Block), "camera uniforms");
+		return uniforms;
+	}
+	
+	void CameraUniforms::update(const Camera& camera, float time) const {
+		math::Mat4 view = camera.view_matrix();
+		math::Mat4 projection = camera.projection_matrix();
+		math::Mat4 viewProjection = projection * view;
+		
+		Block block{};
+		std::memcpy(block.view, view.data(), sizeof(block.view));
+		std::memcpy(block.projection, projection.data(), sizeof(block.projection));
+		std::memcpy(block.view_projection, viewProjection.data(), sizeof(block.view_projection));
+		block.camera_position[0] = camera.position().x();
+		block.camera_position[1] = camera.position().y();
+		block.camera_position[2] = camera.position().z();
+		block.camera_position[3] = 1;
+		block.time = time;
+		
+		GLBackend::current().bind_buffer(GL_UNIFORM_BUFFER, m_ubo);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &block);
+		RenderStats::add(RenderStats::BUFFER_BYTES, sizeof(Block));
+		GLBackend::current().bind_buffer(GL_UNIFORM_BUFFER, 0);
+	}
+	
+	unsigned int CameraUniforms::ubo() const {
+		return m_ubo;
+	}
+	
+	void CameraUniforms::destroy() {
+		std::cout << "Destroying camera uniforms (ubo=" << m_ubo << ")" << std::endl;
+		GLBackend::current().delete_buffer(m_ubo);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::BUFFER, m_ubo);
+		m_ubo = 0;
+	}
+	
+	void CameraUniforms::bind_block(unsigned int program) {
+		unsigned int index = glGetUniformBlockIndex(program, BLOCK_NAME);
+		if (index != GL_INVALID_INDEX) {
+			glUniformBlockBinding(program, index, BINDING);
+		}
+	}
+} // engine::render
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../Camera.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * Per-frame camera data in a std140 uniform buffer, written once per frame and bound at BINDING.
+	 * Every engine::Shader with a "Camera" block is pointed at that binding when it is linked, so
+	 * switching programs doesn't upload the camera again.
+	 * The block is declared row_major, matching the layout of math::Mat4:
+	 *
+	 *     layout(std140, row_major) uniform Camera {
+	 *         mat4 view;
+	 *         mat4 projection;
+	 *         mat4 viewProjection;
+	 *         vec4 cameraPosition;
+	 *         float time;
+	 *     };
+	 */
+	class CameraUniforms {
+	public:
+		static constexpr unsigned int BINDING = 0;
+		static constexpr const char* BLOCK_NAME = "Camera";
+	
+	private:
+		struct Block {
+			float view[16];
+			float projection[16];
+			float view_projection[16];
+			float camera_position[4];
+			float time;
+			float padding[3];
+		};
+		static_assert(sizeof(Block) == 224, "Block has to match the std140 layout");
+		
+		unsigned int m_ubo;
+	
+	public:
+		CameraUniforms();
+		
+		CameraUniforms(const CameraUniforms& other) = default;
+		CameraUniforms(CameraUniforms&& other) noexcept = default;
+		CameraUniforms& operator=(const CameraUniforms& other) = default;
+		CameraUniforms& operator=(CameraUniforms&& other) noexcept = default;
+		~CameraUniforms() = default;
+		
+		/**
+		 * Creates the buffer and binds it to BINDING.
+		 */
+		static CameraUniforms create();
+		
+		/**
+		 * Uploads the camera matrices, position and time in seconds with a single buffer update.
+		 */
+		void update(const Camera& camera, float time) const;
+		
+		unsigned int ubo() const;
+		
+		void destroy();
+		
+		/**
+		 * Points the program's Camera block, if it has one, at BINDING.
+		 */
+		static void bind_block(unsigned int program);
+	};
+	
+} // engine::render
@@ -0,0 +1,202 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+namespace engine::render {
+	// Bounds for the time left to spinning; the upper one caps the CPU burnt on coarse timers
+	static const FramePacer::Clock::duration MIN_SPIN_MARGIN = std::chrono::microseconds(200);
+	static const FramePacer::Clock::duration MAX_SPIN_MARGIN = std::chrono::microseconds(3000);
+	// How long begin_frame() waits for the GPU before giving up on a fence
+	static const GLuint64 FENCE_TIMEOUT = 1000000000;
+	
+	FramePacer::FramePacer(const std::vector<int>& rates, bool vsync, int frames_in_flight)
+		: m_rates(rates), m_rate(0), m_vsync(vsync), m_frames_in_flight(frames_in_flight),
+		  m_spin_margin(std::chrono::microseconds(1000)), m_deadline(), m_last_present(),
+		  m_started(false), m_over_frames(0), m_under_frames(0), m_frame_times(WINDOW, 0.0f),
+		  m_work_times(WINDOW, 0.0f), m_sample(0), m_samples(0), m_fences() {
+		m_rates.erase(std::remove_if(m_rates.begin(), m_rates.end(), [](int rate) { return rate <= 0; }), m_rates.end());
+		std::sort(m_rates.begin(), m_rates.end(), std::greater<int>());
+		m_rates.erase(std::unique(m_rates.begin(), m_rates.end()), m_rates.end());
+		if (m_rates.empty()) {
+			m_rates.push_back(60);
+		}
+#ifdef _WIN32
+		// The default scheduler tick is 15.6 ms, far coarser than a 240 Hz frame
+		timeBeginPeriod(1);
+#endif
+	}
+	
+	FramePacer::~FramePacer() {
+#ifdef _WIN32
+		timeEndPeriod(1);
+#endif
+	}
+	
+	void FramePacer::begin_frame() {
+		if (m_frames_in_flight > 0) {
+			while ((int) m_fences.size() >= m_frames_in_flight) {
+				GLsync fence = m_fences.front();
+				m_fences.pop_front();
+				glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+				glDeleteSync(fence);
+			}
+		}
+		if (!m_started) {
+			m_deadline = Clock::now();
+			m_last_present = m_deadline;
+			m_started = true;
+		}
+	}
+	
+	void FramePacer::end_frame() {
+		if (m_frames_in_flight > 0 && fences_supported()) {
+			m_fences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+		}
+		
+		// Everything since the last present but the pacer's own wait, including waits on the GPU
+		Clock::time_point now = Clock::now();
+		Clock::duration work = now - m_last_present;
+		adapt(work);
+		
+		if (!m_vsync) {
+			m_deadline += target();
+			// After a long stall start over instead of rushing frames out to catch up
+			if (m_deadline < now) {
+				m_deadline = now;
+			}
+			wait_until(m_deadline);
+			now = Clock::now();
+		}
+		
+		record(now - m_last_present, work);
+		m_last_present = now;
+	}
+	
+	int FramePacer::target_rate() const {
+		return m_rates[m_rate];
+	}
+	FramePacer::Clock::duration FramePacer::target() const {
+		return std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(1000000000 / m_rates[m_rate]));
+	}
+	FramePacer::Clock::duration FramePacer::spin_margin() const {
+		return m_spin_margin;
+	}
+	
+	FramePacer::Stats FramePacer::stats() const {
+		Stats stats = {(double) target_rate(), 0, 0, 0, 0, 0, 0, m_samples};
+		if (m_samples == 0) {
+			return stats;
+		}
+		
+		std::vector<float> times(m_frame_times.begin(), m_frame_times.begin() + m_samples);
+		double sum = 0;
+		double work = 0;
+		for (size_t i = 0; i < m_samples; i++) {
+			sum += times[i];
+			work += m_work_times[i];
+		}
+		stats.mean = sum / m_samples;
+		double squares = 0;
+		for (float time : times) {
+			squares += (time - stats.mean) * (time - stats.mean);
+		}
+		stats.deviation = std::sqrt(squares / m_samples);
+		stats.load = sum > 0 ? work / sum : 0;
+		
+		std::sort(times.begin(), times.end());
+		stats.min = times.front();
+		stats.max = times.back();
+		stats.p99 = times[std::min(m_samples - 1, (size_t) std::ceil(0.99 * m_samples) - 1)];
+		return stats;
+	}
+	
+	std::string FramePacer::report() const {
+		Stats stats = this->stats();
+		char buffer[160];
+		std::snprintf(buffer, sizeof(buffer), "%d Hz, frame %.2f ms +- %.2f (p99 %.2f, max %.2f), load %d%%",
+			target_rate(), stats.mean, stats.deviation, stats.p99, stats.max, (int) std::round(stats.load * 100));
+		return buffer;
+	}
+	
+	void FramePacer::destroy() {
+		for (GLsync fence : m_fences) {
+			glDeleteSync(fence);
+		}
+		m_fences.clear();
+	}
+	
+	bool FramePacer::fences_supported() {
+		return GLEW_VERSION_3_2 || GLEW_ARB_sync;
+	}
+	
+	void FramePacer::wait_until(Clock::time_point deadline) {
+		Clock::time_point wake = deadline - m_spin_margin;
+		Clock::time_point now = Clock::now();
+		if (now < wake) {
+			std::this_thread::sleep_until(wake);
+			now = Clock::now();
+			// Keep the margin just above how late sleeps wake up; grow at once, shrink slowly
+			Clock::duration late = now - wake;
+			Clock::duration wanted = late + late / 4 + MIN_SPIN_MARGIN;
+			if (wanted > m_spin_margin) {
+				m_spin_margin = wanted;
+			}
+			else {
+				m_spin_margin -= (m_spin_margin - wanted) / 64;
+			}
+			m_spin_margin = std::clamp(m_spin_margin, MIN_SPIN_MARGIN, MAX_SPIN_MARGIN);
+		}
+		while (Clock::now() < deadline) {
+			std::this_thread::yield();
+		}
+	}
+	
+	void FramePacer::adapt(Clock::duration work) {
+		if (m_rates.size() < 2) {
+			return;
+		}
+		
+		if (work > target() * DOWN_LOAD) {
+			m_under_frames = 0;
+			if (++m_over_frames >= DOWN_FRAMES && m_rate + 1 < m_rates.size()) {
+				m_rate++;
+				m_over_frames = 0;
+			}
+			return;
+		}
+		m_over_frames = 0;
+		
+		if (m_rate == 0) {
+			return;
+		}
+		Clock::duration faster = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::nanoseconds(1000000000 / m_rates[m_rate - 1]));
+		if (work < faster * UP_LOAD) {
+			if (++m_under_frames >= UP_FRAMES) {
+				m_rate--;
+				m_under_frames = 0;
+			}
+		}
+		else {
+			m_under_frames = 0;
+		}
+	}
+	
+	void FramePacer::record(Clock::duration frame, Clock::duration work) {
+		m_frame_times[m_sample] = std::chrono::duration<float, std::milli>(frame).count();
+		m_work_times[m_sample] = std::chrono::duration<float, std::milli>(work).count();
+		m_sample = (m_sample + 1) % WINDOW;
+		m_samples = std::min(m_samples + 1, WINDOW);
+	}
+} // engine::render
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include <GL/glew.h>
+
+namespace engine::render {
+	
+	/**
+	 * Paces presented frames to a target rate. end_frame() sleeps coarsely until shortly before the
+	 * deadline and spins on steady_clock for the rest, so frames land within a few microseconds
+	 * without keeping a core busy. The margin left for spinning follows how late sleeps actually
+	 * wake up.
+	 *
+	 * The target is picked from a list of rates, usually divisors of the monitor refresh: when the
+	 * frame work keeps overrunning its budget the pacer steps down, and when it comfortably fits the
+	 * budget of a faster rate for a while it steps back up. Stepping between divisors keeps frames
+	 * evenly spaced instead of alternating between two lengths.
+	 *
+	 * With vsync the swap already blocks, so the pacer only measures and adapts. With GPU fences the
+	 * CPU waits in begin_frame() until the GPU is at most a set number of frames behind, which keeps
+	 * the driver from queueing frames and adding latency.
+	 */
+	class FramePacer {
+	public:
+		using Clock = std::chrono::steady_clock;
+		
+		struct Stats {
+			double target_rate;
+			// Presented frame-to-frame times over the last WINDOW frames, in milliseconds
+			double mean;
+			double deviation;
+			double min;
+			double max;
+			double p99;
+			// Share of the frame spent working rather than waiting
+			double load;
+			size_t frames;
+		};
+		
+		// Frames the statistics cover
+		static constexpr size_t WINDOW = 240;
+	
+	private:
+		// Frames over budget in a row before stepping down, and frames that would fit the faster budget
+		static constexpr int DOWN_FRAMES = 8;
+		static constexpr int UP_FRAMES = 240;
+		// Share of the budget work may use before counting as over, and the share of the faster
+		// budget it must stay under to step up
+		static constexpr double DOWN_LOAD = 0.95;
+		static constexpr double UP_LOAD = 0.7;
+		
+		std::vector<int> m_rates;
+		size_t m_rate;
+		bool m_vsync;
+		int m_frames_in_flight;
+		
+		Clock::duration m_spin_margin;
+		Clock::time_point m_deadline;
+		Clock::time_point m_last_present;
+		bool m_started;
+		int m_over_frames;
+		int m_under_frames;
+		
+		std::vector<float> m_frame_times;
+		std::vector<float> m_work_times;
+		size_t m_sample;
+		size_t m_samples;
+		
+		std::deque<GLsync> m_fences;
+	
+	public:
+		/**
+		 * @param rates candidate frame rates in Hz, in any order; the pacer starts at the fastest
+		 * @param vsync whether the swap interval already limits the rate
+		 * @param frames_in_flight how far the GPU may fall behind before begin_frame() waits; 0 disables fences
+		 */
+		explicit FramePacer(const std::vector<int>& rates, bool vsync = false, int frames_in_flight = 0);
+		
+		FramePacer(const FramePacer& other) = delete;
+		FramePacer(FramePacer&& other) noexcept = delete;
+		FramePacer& operator=(const FramePacer& other) = delete;
+		FramePacer& operator=(FramePacer&& other) noexcept = delete;
+		~FramePacer();
+		
+		/**
+		 * Call before any work for the frame. Waits on the GPU fence if fences are enabled.
+		 */
+		void begin_frame();
+		/**
+		 * Call right after the swap. Fences the frame, adapts the target and waits for the deadline.
+		 */
+		void end_frame();
+		
+		int target_rate() const;
+		Clock::duration target() const;
+		Clock::duration spin_margin() const;
+		Stats stats() const;
+		/**
+		 * One line summary of stats(), e.g. for the window title.
+		 */
+		std::string report() const;
+		
+		/**
+		 * Deletes pending fences; needs the GL context.
+		 */
+		void destroy();
+		
+		/**
+		 * Whether GL sync objects are available for fences.
+		 */
+		static bool fences_supported();
+	
+	private:
+		void wait_until(Clock::time_point deadline);
+		void adapt(Clock::duration work);
+		void record(Clock::duration frame, Clock::duration work);
+	};
+	
+} // engine::render
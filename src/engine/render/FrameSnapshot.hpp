@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include "../Camera.hpp"
+#include "../math/Mat4.hpp"
+#include "../math/Vec4.hpp"
+#include "../object/Mesh.hpp"
+#include "../object/Material.hpp"
+#include "InstanceRenderer.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * Everything the render thread needs to draw one simulated frame, built by the simulation
+	 * thread and never changed after SnapshotRing::publish(). Meshes and materials are referenced,
+	 * not copied, and must outlive the ring.
+	 */
+	struct FrameSnapshot {
+		struct Draw {
+			const Mesh* mesh;
+			const Material* material;
+			InstanceRenderer::Instance instance;
+		};
+		struct BlendedDraw {
+			const Mesh* mesh;
+			math::Mat4 model;
+			math::Vec4 albedo;
+		};
+		// How large a visible object appears, for streaming in the texture detail it needs
+		struct TextureRequest {
+			const Material* material;
+			float distance;
+			float world_size;
+		};
+		
+		uint64_t frame = 0;
+		// When the input this frame was simulated from was sampled, for measuring latency
+		std::chrono::steady_clock::time_point input_time;
+		// Wall-clock time the simulation had reached with the last tick, and the length of a tick
+		std::chrono::steady_clock::time_point time;
+		std::chrono::nanoseconds step;
+		// State after the last tick and the one before it; the renderer draws in between
+		Camera camera;
+		Camera previous_camera;
+		// Visible opaque objects, in any order
+		std::vector<Draw> opaque;
+		// Visible blended objects, back to front
+		std::vector<BlendedDraw> blended;
+		// One per visible object, nullptr materials stand for the pass' default material
+		std::vector<TextureRequest> texture_requests;
+		// Objects frustum or occlusion culling rejected, and what culling and sorting cost
+		uint32_t culled = 0;
+		std::chrono::nanoseconds cull_time = std::chrono::nanoseconds(0);
+		std::chrono::nanoseconds sort_time = std::chrono::nanoseconds(0);
+		
+		/**
+		 * How far to blend from the previous to the current state when presenting at the given time.
+		 * Rendering runs one tick behind the simulation, so this stays within [0, 1] unless the
+		 * simulation stalls.
+		 */
+		float alpha(std::chrono::steady_clock::time_point now) const {
+			float alpha = std::chrono::duration<float>(now - time).count() / std::chrono::duration<float>(step).count();
+			return alpha < 0 ? 0 : alpha > 1 ? 1 : alpha;
+		}
+	};
+	
+} // engine::render
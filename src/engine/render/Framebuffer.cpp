@@ -0,0 +1,90 @@
+#include "Framebuffer.hpp"
+
+#include <iostream>
+
+#include "GL/glew.h"
+
+#include "../profile/MemoryTracker.hpp"
+
+namespace engine::render {
+	Framebuffer::Framebuffer() : m_fbo(0), m_color(0), m_depth(0), m_width(0), m_height(0) {
+	}
+	
+	Framebuffer Framebuffer::create(int width, int height) {
+		Framebuffer framebuffer;
+		framebuffer.m_width = width;
+		framebuffer.m_height = height;
+		
+		glGenRenderbuffers(1, &framebuffer.m_color);
+		glBindRenderbuffer(GL_RENDERBUFFER, framebuffer.m_color);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glGenRenderbuffers(1, &framebuffer.m_depth);
+		glBindRenderbuffer(GL_RENDERBUFFER, framebuffer.m_depth);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+		profile::MemoryTracker::track(profile::MemoryTracker::RENDERBUFFER, framebuffer.m_color,
+			(size_t) width * height * 4, "framebuffer color");
+		profile::MemoryTracker::track(profile::MemoryTracker::RENDERBUFFER, framebuffer.m_depth,
+			(size_t) width * height * 4, "framebuffer depth");
+		
+		glGenFramebuffers(1, &framebuffer.m_fbo);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.m_fbo);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, framebuffer.m_color);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, framebuffer.m_depth);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			std::cerr << "Framebuffer " << width << "x" << height << " is incomplete" << std::endl;
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			framebuffer.destroy();
+			return framebuffer;
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		return framebuffer;
+	}
+	
+	void Framebuffer::bind() const {
+		glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+		glViewport(0, 0, m_width, m_height);
+	}
+	void Framebuffer::unbind() {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+	
+	std::vector<uint8_t> Framebuffer::read_pixels() const {
+		std::vector<uint8_t> pixels((size_t) m_width * m_height * 4);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fbo);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+		return pixels;
+	}
+	
+	bool Framebuffer::complete() const {
+		return m_fbo != 0;
+	}
+	unsigned int Framebuffer::id() const {
+		return m_fbo;
+	}
+	int Framebuffer::width() const {
+		return m_width;
+	}
+	int Framebuffer::height() const {
+		return m_height;
+	}
+	
+	void Framebuffer::destroy() {
+		if (m_fbo != 0) {
+			glDeleteFramebuffers(1, &m_fbo);
+		}
+		if (m_color != 0) {
+			glDeleteRenderbuffers(1, &m_color);
+			profile::MemoryTracker::untrack(profile::MemoryTracker::RENDERBUFFER, m_color);
+		}
+		if (m_depth != 0) {
+			glDeleteRenderbuffers(1, &m_depth);
+			profile::MemoryTracker::untrack(profile::MemoryTracker::RENDERBUFFER, m_depth);
+		}
+		m_fbo = 0;
+		m_color = 0;
+		m_depth = 0;
+	}
+} // engine::render
\ No newline at end of file
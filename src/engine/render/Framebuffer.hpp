@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace engine::render {
+	
+	/**
+	 * Offscreen render target with an RGBA8 color and a 24-bit depth renderbuffer, for rendering
+	 * without a visible window.
+	 */
+	class Framebuffer {
+	private:
+		unsigned int m_fbo;
+		unsigned int m_color;
+		unsigned int m_depth;
+		int m_width;
+		int m_height;
+	
+	public:
+		Framebuffer();
+		
+		Framebuffer(const Framebuffer& other) = default;
+		Framebuffer(Framebuffer&& other) noexcept = default;
+		Framebuffer& operator=(const Framebuffer& other) = default;
+		Framebuffer& operator=(Framebuffer&& other) noexcept = default;
+		~Framebuffer() = default;
+		
+		/**
+		 * Creates the attachments and checks completeness; check complete() before using it.
+		 */
+		static Framebuffer create(int width, int height);
+		
+		/**
+		 * Binds it for drawing and sets the viewport to its size.
+		 */
+		void bind() const;
+		/**
+		 * Restores the window's framebuffer. The viewport is left for the caller.
+		 */
+		static void unbind();
+		
+		/**
+		 * Reads the color attachment back, RGBA8 rows bottom to top. Waits for the GPU.
+		 */
+		std::vector<uint8_t> read_pixels() const;
+		
+		bool complete() const;
+		unsigned int id() const;
+		int width() const;
+		int height() const;
+		
+		void destroy();
+	};
+	
+} // engine::render
@@ -0,0 +1,94 @@
+#include "FrustumCuller.hpp"
+
+#include "../jobs/JobSystem.hpp"
+
+namespace engine::render {
+	void FrustumCuller::Bounds::clear() {
+		x.clear();
+		y.clear();
+		z.clear();
+		ex.clear();
+		ey.clear();
+		ez.clear();
+		radius.clear();
+	}
+	void FrustumCuller::Bounds::reserve(size_t count) {
+		x.reserve(count);
+		y.reserve(count);
+		z.reserve(count);
+		ex.reserve(count);
+		ey.reserve(count);
+		ez.reserve(count);
+		radius.reserve(count);
+	}
+	
+	FrustumCuller::FrustumCuller()
+		: m_bounds(), m_visible(), m_candidates(), m_models(), m_tested(0), m_visible_count(0) {
+	}
+	
+	void FrustumCuller::cull(const std::vector<object::Renderable*>& renderables, const math::Frustum& frustum,
+		std::vector<object::Renderable*>& visible) {
+		size_t count = renderables.size();
+		m_tested = count;
+		m_visible_count = 0;
+		
+		// Sphere pass over every renderable, in slices on the job system
+		m_bounds.x.resize(count);
+		m_bounds.y.resize(count);
+		m_bounds.z.resize(count);
+		m_bounds.radius.resize(count);
+		m_models.resize(count);
+		m_visible.resize(count);
+		jobs::JobSystem::shared().parallel_for(0, count, 4096, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				m_models[i] = renderables[i]->get_model();
+				math::Sphere sphere = renderables[i]->get_mesh().bounding_sphere().transform(m_models[i]);
+				m_bounds.x[i] = sphere.center().x();
+				m_bounds.y[i] = sphere.center().y();
+				m_bounds.z[i] = sphere.center().z();
+				m_bounds.radius[i] = sphere.radius();
+			}
+			frustum.test_spheres(&m_bounds.x[begin], &m_bounds.y[begin], &m_bounds.z[begin], &m_bounds.radius[begin],
+				end - begin, &m_visible[begin]);
+		});
+		
+		// Box pass over the survivors, whose spheres may only graze the frustum
+		m_candidates.clear();
+		m_bounds.clear();
+		for (size_t i = 0; i < count; i++) {
+			if (!m_visible[i]) {
+				continue;
+			}
+			math::AABB box = renderables[i]->get_mesh().bounds().transform(m_models[i]);
+			math::Vec3 center = box.center();
+			math::Vec3 extents = box.extents();
+			m_candidates.push_back(renderables[i]);
+			m_bounds.x.push_back(center.x());
+			m_bounds.y.push_back(center.y());
+			m_bounds.z.push_back(center.z());
+			m_bounds.ex.push_back(extents.x());
+			m_bounds.ey.push_back(extents.y());
+			m_bounds.ez.push_back(extents.z());
+		}
+		size_t candidates = m_candidates.size();
+		frustum.test_boxes(m_bounds.x.data(), m_bounds.y.data(), m_bounds.z.data(), m_bounds.ex.data(),
+			m_bounds.ey.data(), m_bounds.ez.data(), candidates, m_visible.data());
+		
+		for (size_t i = 0; i < candidates; i++) {
+			if (m_visible[i]) {
+				visible.push_back(m_candidates[i]);
+				m_visible_count++;
+			}
+		}
+	}
+	
+	size_t FrustumCuller::tested() const {
+		return m_tested;
+	}
+	size_t FrustumCuller::visible() const {
+		return m_visible_count;
+	}
+	size_t FrustumCuller::culled() const {
+		return m_tested - m_visible_count;
+	}
+} // engine::render
\ No newline at end of file
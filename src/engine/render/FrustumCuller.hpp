@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "../object/Renderable.hpp"
+#include "../math/Frustum.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * Drops Renderables whose world bounds are outside the camera frustum.
+	 * Bounds are gathered into structure-of-arrays buffers and tested in batches: a cheap sphere
+	 * pass first, then the tighter box test only for the spheres that survived.
+	 * The buffers are kept between frames, so culling doesn't allocate once they have grown.
+	 * Meant for flat lists of moving objects; static scenes go through scene::StaticBVH, whose leaves
+	 * use the same batch box test.
+	 */
+	class FrustumCuller {
+	private:
+		struct Bounds {
+			std::vector<float> x, y, z;
+			std::vector<float> ex, ey, ez;
+			std::vector<float> radius;
+			
+			void clear();
+			void reserve(size_t count);
+		};
+		
+		Bounds m_bounds;
+		std::vector<uint8_t> m_visible;
+		std::vector<object::Renderable*> m_candidates;
+		std::vector<math::Mat4> m_models;
+		
+		size_t m_tested;
+		size_t m_visible_count;
+	
+	public:
+		FrustumCuller();
+		
+		FrustumCuller(const FrustumCuller& other) = default;
+		FrustumCuller(FrustumCuller&& other) noexcept = default;
+		FrustumCuller& operator=(const FrustumCuller& other) = default;
+		FrustumCuller& operator=(FrustumCuller&& other) noexcept = default;
+		~FrustumCuller() = default;
+		
+		/**
+		 * Appends the visible renderables of the input to the output, keeping their order.
+		 */
+		void cull(const std::vector<object::Renderable*>& renderables, const math::Frustum& frustum,
+			std::vector<object::Renderable*>& visible);
+		
+		/**
+		 * Counts of the last cull() call.
+		 */
+		size_t tested() const;
+		size_t visible() const;
+		size_t culled() const;
+	};
+	
+} // engine::render
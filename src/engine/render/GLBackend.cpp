@@ -0,0 +1,83 @@
+#include "GLBackend.hpp"
+
+#include "GL/glew.h"
+
+#include "StateCache.hpp"
+#include "RenderStats.hpp"
+
+namespace engine::render {
+	static OpenGLBackend s_opengl_backend;
+	static StateCache s_cached_backend(s_opengl_backend);
+	GLBackend* GLBackend::s_current = &s_cached_backend;
+	
+	GLBackend& GLBackend::current() {
+		return *s_current;
+	}
+	void GLBackend::set_current(GLBackend* backend) {
+		s_current = backend ? backend : &s_cached_backend;
+	}
+	GLBackend& GLBackend::opengl() {
+		return s_opengl_backend;
+	}
+	
+	unsigned int OpenGLBackend::create_texture() {
+		unsigned int id;
+		glGenTextures(1, &id);
+		return id;
+	}
+	void OpenGLBackend::delete_texture(unsigned int id) {
+		glDeleteTextures(1, &id);
+	}
+	void OpenGLBackend::bind_texture(unsigned int target, unsigned int id) {
+		RenderStats::add(RenderStats::TEXTURE_BINDS);
+		glBindTexture(target, id);
+	}
+	void OpenGLBackend::tex_image_2d(unsigned int target, int level, int width, int height, const void* data) {
+		glTexImage2D(target, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	}
+	void OpenGLBackend::tex_parameter(unsigned int target, unsigned int name, int value) {
+		glTexParameteri(target, name, value);
+	}
+	void OpenGLBackend::active_texture(unsigned int unit) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+	
+	void OpenGLBackend::use_program(unsigned int id) {
+		RenderStats::add(RenderStats::PROGRAM_SWITCHES);
+		glUseProgram(id);
+	}
+	void OpenGLBackend::delete_program(unsigned int id) {
+		glDeleteProgram(id);
+	}
+	void OpenGLBackend::bind_vertex_array(unsigned int id) {
+		glBindVertexArray(id);
+	}
+	void OpenGLBackend::delete_vertex_array(unsigned int id) {
+		glDeleteVertexArrays(1, &id);
+	}
+	void OpenGLBackend::bind_buffer(unsigned int target, unsigned int id) {
+		glBindBuffer(target, id);
+	}
+	void OpenGLBackend::bind_buffer_base(unsigned int target, unsigned int index, unsigned int id) {
+		glBindBufferBase(target, index, id);
+	}
+	void OpenGLBackend::delete_buffer(unsigned int id) {
+		glDeleteBuffers(1, &id);
+	}
+	
+	void OpenGLBackend::enable(unsigned int capability) {
+		glEnable(capability);
+	}
+	void OpenGLBackend::disable(unsigned int capability) {
+		glDisable(capability);
+	}
+	void OpenGLBackend::blend_func(unsigned int source, unsigned int destination) {
+		glBlendFunc(source, destination);
+	}
+	void OpenGLBackend::depth_func(unsigned int func) {
+		glDepthFunc(func);
+	}
+	void OpenGLBackend::depth_mask(bool write) {
+		glDepthMask(write ? GL_TRUE : GL_FALSE);
+	}
+} // engine::render
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+namespace engine::render {
+	
+	/**
+	 * Thin indirection over the OpenGL calls used by engine systems that need to run without a GPU.
+	 * The default backend is a StateCache in front of OpenGL, a MockGLBackend can be installed to
+	 * run headless. All binds and state changes of the engine go through the current backend, so
+	 * the cache always knows what is bound.
+	 */
+	class GLBackend {
+	public:
+		virtual ~GLBackend() = default;
+		
+		// Textures
+		virtual unsigned int create_texture() = 0;
+		virtual void delete_texture(unsigned int id) = 0;
+		virtual void bind_texture(unsigned int target, unsigned int id) = 0;
+		/**
+		 * Specifies one RGBA8 level of the bound texture. A null data pointer with a zero size releases the level.
+		 */
+		virtual void tex_image_2d(unsigned int target, int level, int width, int height, const void* data) = 0;
+		virtual void tex_parameter(unsigned int target, unsigned int name, int value) = 0;
+		/**
+		 * Selects the texture unit used by bind_texture, as an index (0 for GL_TEXTURE0).
+		 */
+		virtual void active_texture(unsigned int unit) = 0;
+		
+		// Programs, vertex arrays and buffers
+		virtual void use_program(unsigned int id) = 0;
+		virtual void delete_program(unsigned int id) = 0;
+		virtual void bind_vertex_array(unsigned int id) = 0;
+		virtual void delete_vertex_array(unsigned int id) = 0;
+		virtual void bind_buffer(unsigned int target, unsigned int id) = 0;
+		virtual void bind_buffer_base(unsigned int target, unsigned int index, unsigned int id) = 0;
+		virtual void delete_buffer(unsigned int id) = 0;
+		
+		// Fixed function state
+		virtual void enable(unsigned int capability) = 0;
+		virtual void disable(unsigned int capability) = 0;
+		virtual void blend_func(unsigned int source, unsigned int destination) = 0;
+		virtual void depth_func(unsigned int func) = 0;
+		virtual void depth_mask(bool write) = 0;
+	
+	private:
+		static GLBackend* s_current;
+	
+	public:
+		static GLBackend& current();
+		/**
+		 * Installs a backend, nullptr restores the cached OpenGL backend.
+		 */
+		static void set_current(GLBackend* backend);
+		/**
+		 * Forwards straight to OpenGL, without state tracking.
+		 */
+		static GLBackend& opengl();
+	};
+	
+	class OpenGLBackend : public GLBackend {
+	public:
+		unsigned int create_texture() override;
+		void delete_texture(unsigned int id) override;
+		void bind_texture(unsigned int target, unsigned int id) override;
+		void tex_image_2d(unsigned int target, int level, int width, int height, const void* data) override;
+		void tex_parameter(unsigned int target, unsigned int name, int value) override;
+		void active_texture(unsigned int unit) override;
+		
+		void use_program(unsigned int id) override;
+		void delete_program(unsigned int id) override;
+		void bind_vertex_array(unsigned int id) override;
+		void delete_vertex_array(unsigned int id) override;
+		void bind_buffer(unsigned int target, unsigned int id) override;
+		void bind_buffer_base(unsigned int target, unsigned int index, unsigned int id) override;
+		void delete_buffer(unsigned int id) override;
+		
+		void enable(unsigned int capability) override;
+		void disable(unsigned int capability) override;
+		void blend_func(unsigned int source, unsigned int destination) override;
+		void depth_func(unsigned int func) override;
+		void depth_mask(bool write) override;
+	};
+	
+} // engine::render
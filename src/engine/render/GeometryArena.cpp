@@ -0,0 +1,180 @@
+#include "GeometryArena.hpp"
+
+#include <iostream>
+#include <algorithm>
+
+#include "GL/glew.h"
+
+#include "GLBackend.hpp"
+#include "RenderStats.hpp"
+#include "../profile/MemoryTracker.hpp"
+
+namespace engine::render {
+	namespace {
+		// Moves the contents of a buffer into a new, larger one and returns its name
+		unsigned int grow_buffer(unsigned int buffer, size_t usedBytes, size_t capacityBytes, const char* label) {
+			unsigned int grown;
+			glGenBuffers(1, &grown);
+			GLBackend::current().bind_buffer(GL_COPY_WRITE_BUFFER, grown);
+			glBufferData(GL_COPY_WRITE_BUFFER, capacityBytes, nullptr, GL_STATIC_DRAW);
+			if (buffer != 0 && usedBytes > 0) {
+				GLBackend::current().bind_buffer(GL_COPY_READ_BUFFER, buffer);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedBytes);
+				GLBackend::current().bind_buffer(GL_COPY_READ_BUFFER, 0);
+			}
+			GLBackend::current().bind_buffer(GL_COPY_WRITE_BUFFER, 0);
+			if (buffer != 0) {
+				GLBackend::current().delete_buffer(buffer);
+				profile::MemoryTracker::untrack(profile::MemoryTracker::BUFFER, buffer);
+			}
+			profile::MemoryTracker::track(profile::MemoryTracker::BUFFER, grown, capacityBytes, label);
+			return grown;
+		}
+	}
+	
+	GeometryArena::GeometryArena()
+		: m_vao(0), m_vbo(0), m_ibo(0), m_vertex_capacity(0), m_index_capacity(0), m_vertex_top(0), m_index_top(0),
+		m_vertex_count(0), m_index_count(0), m_free_vertices(), m_free_indices() {
+	}
+	
+	GeometryArena GeometryArena::create(size_t vertexCapacity, size_t indexCapacity) {
+		GeometryArena arena;
+		glGenVertexArrays(1, &arena.m_vao);
+		arena.grow_vertices(std::max<size_t>(vertexCapacity, 1));
+		arena.grow_indices(std::max<size_t>(indexCapacity, 1));
+		return arena;
+	}
+	
+	ArenaRange GeometryArena::allocate(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
+		size_t vertexOffset = take(m_free_vertices, m_vertex_top, vertices.size());
+		size_t indexOffset = take(m_free_indices, m_index_top, indices.size());
+		if (m_vertex_top > m_vertex_capacity) {
+			grow_vertices(std::max(m_vertex_top, m_vertex_capacity * 2));
+		}
+		if (m_index_top > m_index_capacity) {
+			grow_indices(std::max(m_index_top, m_index_capacity * 2));
+		}
+		
+		std::vector<float> data = Mesh::interleave(vertices);
+		GLBackend::current().bind_buffer(GL_ARRAY_BUFFER, m_vbo);
+		glBufferSubData(GL_ARRAY_BUFFER, vertexOffset * VERTEX_SIZE, data.size() * sizeof(float), data.data());
+		GLBackend::current().bind_buffer(GL_ARRAY_BUFFER, 0);
+		// The element buffer binding is VAO state, upload through the copy target instead
+		GLBackend::current().bind_buffer(GL_COPY_WRITE_BUFFER, m_ibo);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset * sizeof(unsigned int), indices.size() * sizeof(unsigned int),
+			indices.data());
+		GLBackend::current().bind_buffer(GL_COPY_WRITE_BUFFER, 0);
+		RenderStats::add(RenderStats::BUFFER_BYTES, data.size() * sizeof(float) + indices.size() * sizeof(unsigned int));
+		
+		m_vertex_count += vertices.size();
+		m_index_count += indices.size();
+		return {
+			static_cast<int>(vertexOffset), static_cast<unsigned int>(vertices.size()),
+			static_cast<unsigned int>(indexOffset), static_cast<unsigned int>(indices.size())
+		};
+	}
+	void GeometryArena::free(const ArenaRange& range) {
+		give(m_free_vertices, m_vertex_top, {static_cast<size_t>(range.base_vertex), range.vertex_count});
+		give(m_free_indices, m_index_top, {range.first_index, range.index_count});
+		m_vertex_count -= range.vertex_count;
+		m_index_count -= range.index_count;
+	}
+	
+	unsigned int GeometryArena::vao() const {
+		return m_vao;
+	}
+	unsigned int GeometryArena::vbo() const {
+		return m_vbo;
+	}
+	unsigned int GeometryArena::ibo() const {
+		return m_ibo;
+	}
+	size_t GeometryArena::vertex_count() const {
+		return m_vertex_count;
+	}
+	size_t GeometryArena::index_count() const {
+		return m_index_count;
+	}
+	size_t GeometryArena::vertex_capacity() const {
+		return m_vertex_capacity;
+	}
+	size_t GeometryArena::index_capacity() const {
+		return m_index_capacity;
+	}
+	
+	void GeometryArena::destroy() {
+		std::cout << "Destroying geometry arena (vao=" << m_vao << ", vbo=" << m_vbo << ", ibo=" << m_ibo << ")"
+			<< std::endl;
+		GLBackend::current().delete_vertex_array(m_vao);
+		GLBackend::current().delete_buffer(m_vbo);
+		GLBackend::current().delete_buffer(m_ibo);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::BUFFER, m_vbo);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::BUFFER, m_ibo);
+		*this = GeometryArena();
+	}
+	
+	size_t GeometryArena::take(std::vector<Block>& freeBlocks, size_t& top, size_t size) {
+		for (auto it = freeBlocks.begin(); it != freeBlocks.end(); it++) {
+			if (it->size >= size) {
+				size_t offset = it->offset;
+				it->offset += size;
+				it->size -= size;
+				if (it->size == 0) {
+					freeBlocks.erase(it);
+				}
+				return offset;
+			}
+		}
+		size_t offset = top;
+		top += size;
+		return offset;
+	}
+	void GeometryArena::give(std::vector<Block>& freeBlocks, size_t& top, Block block) {
+		if (block.size == 0) {
+			return;
+		}
+		// Keep the list sorted by offset and merge neighbours so fragmentation stays low
+		auto it = std::lower_bound(freeBlocks.begin(), freeBlocks.end(), block, [](const Block& a, const Block& b) {
+			return a.offset < b.offset;
+		});
+		it = freeBlocks.insert(it, block);
+		if (it + 1 != freeBlocks.end() && it->offset + it->size == (it + 1)->offset) {
+			it->size += (it + 1)->size;
+			freeBlocks.erase(it + 1);
+		}
+		if (it != freeBlocks.begin() && (it - 1)->offset + (it - 1)->size == it->offset) {
+			(it - 1)->size += it->size;
+			it = freeBlocks.erase(it) - 1;
+		}
+		// A block at the end goes back to the bump allocator
+		if (it->offset + it->size == top) {
+			top = it->offset;
+			freeBlocks.erase(it);
+		}
+	}
+	
+	void GeometryArena::grow_vertices(size_t capacity) {
+		m_vbo = grow_buffer(m_vbo, m_vertex_capacity * VERTEX_SIZE, capacity * VERTEX_SIZE, "geometry arena vertices");
+		m_vertex_capacity = capacity;
+		setup_vao();
+	}
+	void GeometryArena::grow_indices(size_t capacity) {
+		m_ibo = grow_buffer(m_ibo, m_index_capacity * sizeof(unsigned int), capacity * sizeof(unsigned int),
+			"geometry arena indices");
+		m_index_capacity = capacity;
+		setup_vao();
+	}
+	void GeometryArena::setup_vao() const {
+		GLBackend::current().bind_vertex_array(m_vao);
+		GLBackend::current().bind_buffer(GL_ARRAY_BUFFER, m_vbo);
+		GLBackend::current().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+		
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*) 0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*) (3 * sizeof(float)));
+		glEnableVertexAttribArray(1);
+		
+		GLBackend::current().bind_vertex_array(0);
+		GLBackend::current().bind_buffer(GL_ARRAY_BUFFER, 0);
+	}
+} // engine::render
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "../object/Mesh.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * Location of a mesh inside a GeometryArena. Indices are relative to base_vertex.
+	 */
+	struct ArenaRange {
+		int base_vertex;
+		unsigned int vertex_count;
+		unsigned int first_index;
+		unsigned int index_count;
+	};
+	
+	/**
+	 * Shared vertex and index buffers with the Mesh vertex layout behind a single VAO.
+	 * Meshes created in the arena are sub-allocated from it (first fit, freed ranges are reused),
+	 * so any number of them can be drawn without rebinding vertex state.
+	 * The buffers grow when full; their names change then, but the VAO stays the same.
+	 */
+	class GeometryArena {
+	private:
+		struct Block {
+			size_t offset;
+			size_t size;
+		};
+		
+		unsigned int m_vao, m_vbo, m_ibo;
+		size_t m_vertex_capacity, m_index_capacity;
+		size_t m_vertex_top, m_index_top;
+		size_t m_vertex_count, m_index_count;
+		std::vector<Block> m_free_vertices;
+		std::vector<Block> m_free_indices;
+	
+	public:
+		static constexpr size_t VERTEX_SIZE = 5 * sizeof(float);
+		
+		GeometryArena();
+		
+		GeometryArena(const GeometryArena& other) = default;
+		GeometryArena(GeometryArena&& other) noexcept = default;
+		GeometryArena& operator=(const GeometryArena& other) = default;
+		GeometryArena& operator=(GeometryArena&& other) noexcept = default;
+		~GeometryArena() = default;
+		
+		static GeometryArena create(size_t vertexCapacity, size_t indexCapacity);
+		
+		ArenaRange allocate(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+		void free(const ArenaRange& range);
+		
+		unsigned int vao() const;
+		unsigned int vbo() const;
+		unsigned int ibo() const;
+		
+		/**
+		 * Vertices and indices currently allocated.
+		 */
+		size_t vertex_count() const;
+		size_t index_count() const;
+		size_t vertex_capacity() const;
+		size_t index_capacity() const;
+		
+		void destroy();
+	
+	private:
+		static size_t take(std::vector<Block>& freeBlocks, size_t& top, size_t size);
+		static void give(std::vector<Block>& freeBlocks, size_t& top, Block block);
+		
+		void grow_vertices(size_t capacity);
+		void grow_indices(size_t capacity);
+		void setup_vao() const;
+	};
+	
+} // engine::render
@@ -0,0 +1,170 @@
+#include "IndirectRenderer.hpp"
+
+#include <iostream>
+#include <algorithm>
+
+#include "GL/glew.h"
+
+#include "GLBackend.hpp"
+#include "RenderStats.hpp"
+#include "../profile/MemoryTracker.hpp"
+
+namespace engine::render {
+	namespace {
+		// Orphans and refills a stream buffer, growing it geometrically
+		void upload(GLenum target, unsigned int buffer, size_t& capacity, const void* data, size_t bytes,
+			const char* label) {
+			GLBackend::current().bind_buffer(target, buffer);
+			if (bytes > capacity) {
+				capacity = std::max(bytes, capacity * 2);
+			}
+			glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+			glBufferSubData(target, 0, bytes, data);
+			RenderStats::add(RenderStats::BUFFER_BYTES, bytes);
+			profile::MemoryTracker::track(profile::MemoryTracker::BUFFER, buffer, capacity, label);
+		}
+	}
+	
+	IndirectRenderer::IndirectRenderer()
+		: m_arena(nullptr), m_command_buffer(0), m_instance_buffer(0), m_command_capacity(0), m_instance_capacity(0),
+		m_passes(), m_pass_indices(), m_commands(), m_instances() {
+	}
+	
+	IndirectRenderer IndirectRenderer::create(GeometryArena& arena) {
+		IndirectRenderer renderer;
+		renderer.m_arena = &arena;
+		glGenBuffers(1, &renderer.m_command_buffer);
+		glGenBuffers(1, &renderer.m_instance_buffer);
+		return renderer;
+	}
+	bool IndirectRenderer::supported() {
+		return GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance);
+	}
+	
+	void IndirectRenderer::begin() {
+		for (Pass& pass : m_passes) {
+			for (Draw& draw : pass.draws) {
+				draw.instances.clear();
+			}
+		}
+	}
+	bool IndirectRenderer::add(const object::Renderable& renderable) {
+		if (renderable.get_mesh().arena() != m_arena) {
+			return false;
+		}
+		return add(renderable.get_mesh(), renderable.get_material(), InstanceRenderer::instance(renderable));
+	}
+	bool IndirectRenderer::add(const Mesh& mesh, const Material* material, const InstanceRenderer::Instance& instance) {
+		if (mesh.arena() != m_arena) {
+			return false;
+		}
+		auto passIt = m_pass_indices.find(material);
+		if (passIt == m_pass_indices.end()) {
+			passIt = m_pass_indices.emplace(material, m_passes.size()).first;
+			m_passes.push_back({material, {}, {}, 0, 0});
+		}
+		Pass& pass = m_passes[passIt->second];
+		
+		// Ranges in the arena don't overlap, so the first index identifies the mesh
+		auto drawIt = pass.draw_indices.find(mesh.first_index());
+		if (drawIt == pass.draw_indices.end()) {
+			drawIt = pass.draw_indices.emplace(mesh.first_index(), pass.draws.size()).first;
+			pass.draws.push_back({0, 0, 0, {}});
+		}
+		Draw& draw = pass.draws[drawIt->second];
+		draw.first_index = mesh.first_index();
+		draw.index_count = mesh.indices().size();
+		draw.base_vertex = mesh.base_vertex();
+		draw.instances.push_back(instance);
+		return true;
+	}
+	
+	void IndirectRenderer::draw(ShaderVariants& variants, const Material& defaultMaterial) {
+		build();
+		if (m_commands.empty()) {
+			return;
+		}
+		upload(GL_DRAW_INDIRECT_BUFFER, m_command_buffer, m_command_capacity, m_commands.data(),
+			m_commands.size() * sizeof(DrawElementsIndirectCommand), "indirect commands");
+		upload(GL_ARRAY_BUFFER, m_instance_buffer, m_instance_capacity, m_instances.data(),
+			m_instances.size() * sizeof(InstanceRenderer::Instance), "indirect instances");
+		
+		// Vertex state is bound once for the whole frame
+		GLBackend::current().bind_vertex_array(m_arena->vao());
+		GLBackend::current().bind_buffer(GL_ARRAY_BUFFER, m_instance_buffer);
+		InstanceRenderer::set_instance_attributes(0);
+		
+		const Shader* current = nullptr;
+		for (const Pass& pass : m_passes) {
+			if (pass.command_count == 0) {
+				continue;
+			}
+			const Material& material = pass.material ? *pass.material : defaultMaterial;
+			const Shader& shader = material.shader(variants, {InstanceRenderer::DEFINE});
+			if (!shader.ready()) {
+				continue;
+			}
+			if (&shader != current) {
+				shader.use();
+				current = &shader;
+			}
+			material.bind(shader);
+			
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+				(void*) (pass.first_command * sizeof(DrawElementsIndirectCommand)), pass.command_count, 0);
+			// One call, but every command is a draw as far as the GPU is concerned
+			RenderStats::add(RenderStats::DRAW_CALLS);
+			for (size_t i = pass.first_command; i < pass.first_command + pass.command_count; i++) {
+				RenderStats::add(RenderStats::TRIANGLES, (uint64_t) m_commands[i].count / 3 * m_commands[i].instanceCount);
+			}
+		}
+	}
+	
+	size_t IndirectRenderer::pass_count() const {
+		size_t count = 0;
+		for (const Pass& pass : m_passes) {
+			if (pass.command_count > 0) {
+				count++;
+			}
+		}
+		return count;
+	}
+	size_t IndirectRenderer::command_count() const {
+		return m_commands.size();
+	}
+	size_t IndirectRenderer::instance_count() const {
+		return m_instances.size();
+	}
+	
+	void IndirectRenderer::destroy() {
+		std::cout << "Destroying indirect renderer (commands=" << m_command_buffer << ", instances="
+			<< m_instance_buffer << ")" << std::endl;
+		GLBackend::current().delete_buffer(m_command_buffer);
+		GLBackend::current().delete_buffer(m_instance_buffer);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::BUFFER, m_command_buffer);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::BUFFER, m_instance_buffer);
+		m_command_buffer = 0;
+		m_instance_buffer = 0;
+		m_command_capacity = 0;
+		m_instance_capacity = 0;
+	}
+	
+	void IndirectRenderer::build() {
+		m_commands.clear();
+		m_instances.clear();
+		for (Pass& pass : m_passes) {
+			pass.first_command = m_commands.size();
+			for (const Draw& draw : pass.draws) {
+				if (draw.instances.empty()) {
+					continue;
+				}
+				m_commands.push_back({
+					draw.index_count, static_cast<unsigned int>(draw.instances.size()), draw.first_index,
+					draw.base_vertex, static_cast<unsigned int>(m_instances.size())
+				});
+				m_instances.insert(m_instances.end(), draw.instances.begin(), draw.instances.end());
+			}
+			pass.command_count = m_commands.size() - pass.first_command;
+		}
+	}
+} // engine::render
\ No newline at end of file
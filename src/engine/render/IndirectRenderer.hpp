@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "../object/Renderable.hpp"
+#include "../object/Material.hpp"
+#include "GeometryArena.hpp"
+#include "InstanceRenderer.hpp"
+#include "ShaderVariants.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * Layout read by glMultiDrawElementsIndirect.
+	 */
+	struct DrawElementsIndirectCommand {
+		unsigned int count;
+		unsigned int instanceCount;
+		unsigned int firstIndex;
+		int baseVertex;
+		unsigned int baseInstance;
+	};
+	
+	/**
+	 * Submits every Renderable whose mesh lives in a GeometryArena with one glMultiDrawElementsIndirect
+	 * per material. Renderables with the same mesh become one command with several instances.
+	 * Per-draw data (model matrix and albedo) is read through the instance attributes of
+	 * InstanceRenderer; each command's baseInstance points at its range of the instance buffer, so the
+	 * INSTANCED shader permutation works unchanged and doesn't need gl_DrawID (GLSL 4.60).
+	 * Requires OpenGL 4.3 or ARB_multi_draw_indirect with ARB_base_instance.
+	 */
+	class IndirectRenderer {
+	private:
+		struct Draw {
+			unsigned int first_index;
+			unsigned int index_count;
+			int base_vertex;
+			std::vector<InstanceRenderer::Instance> instances;
+		};
+		
+		struct Pass {
+			const Material* material;
+			std::vector<Draw> draws;
+			std::unordered_map<unsigned int, size_t> draw_indices;
+			size_t first_command;
+			size_t command_count;
+		};
+		
+		GeometryArena* m_arena;
+		unsigned int m_command_buffer, m_instance_buffer;
+		size_t m_command_capacity, m_instance_capacity;
+		std::vector<Pass> m_passes;
+		std::unordered_map<const Material*, size_t> m_pass_indices;
+		std::vector<DrawElementsIndirectCommand> m_commands;
+		std::vector<InstanceRenderer::Instance> m_instances;
+	
+	public:
+		IndirectRenderer();
+		
+		IndirectRenderer(const IndirectRenderer& other) = default;
+		IndirectRenderer(IndirectRenderer&& other) noexcept = default;
+		IndirectRenderer& operator=(const IndirectRenderer& other) = default;
+		IndirectRenderer& operator=(IndirectRenderer&& other) noexcept = default;
+		~IndirectRenderer() = default;
+		
+		/**
+		 * Creates the command and instance buffers for drawing meshes of the arena.
+		 */
+		static IndirectRenderer create(GeometryArena& arena);
+		static bool supported();
+		
+		/**
+		 * Clears the draws of the previous frame, keeping the allocations.
+		 */
+		void begin();
+		/**
+		 * @return false if the mesh of the renderable isn't in this renderer's arena
+		 */
+		bool add(const object::Renderable& renderable);
+		bool add(const Mesh& mesh, const Material* material, const InstanceRenderer::Instance& instance);
+		/**
+		 * Uploads all commands and instances and submits one multi-draw per material.
+		 * Renderables without a material use the default one.
+		 */
+		void draw(ShaderVariants& variants, const Material& defaultMaterial);
+		
+		size_t pass_count() const;
+		size_t command_count() const;
+		size_t instance_count() const;
+		
+		void destroy();
+	
+	private:
+		void build();
+	};
+	
+} // engine::render
@@ -0,0 +1,175 @@
+#include "InstanceRenderer.hpp"
+
+#include <iostream>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+#include "GL/glew.h"
+
+#include "GLBackend.hpp"
+#include "RenderStats.hpp"
+#include "../profile/MemoryTracker.hpp"
+
+#include "../util/Hash.hpp"
+
+namespace engine::render {
+	InstanceRenderer::InstanceRenderer()
+		: m_vbo(0), m_capacity(0), m_groups(), m_group_indices(), m_staging() {
+	}
+	
+	InstanceRenderer InstanceRenderer::create() {
+		InstanceRenderer renderer;
+		glGenBuffers(1, &renderer.m_vbo);
+		return renderer;
+	}
+	
+	void InstanceRenderer::begin() {
+		for (Group& group : m_groups) {
+			group.instances.clear();
+		}
+	}
+	void InstanceRenderer::add(const object::Renderable& renderable) {
+		add(renderable.get_mesh(), renderable.get_material(), instance(renderable));
+	}
+	void InstanceRenderer::add(const Mesh& mesh, const Material* material, const Instance& instance) {
+		GroupKey key{mesh.vao(), mesh.first_index(), material};
+		auto it = m_group_indices.find(key);
+		if (it == m_group_indices.end()) {
+			it = m_group_indices.emplace(key, m_groups.size()).first;
+			m_groups.push_back({0, 0, 0, 0, material, {}});
+		}
+		Group& group = m_groups[it->second];
+		// The mesh may have been recreated under the same vao name, or the arena may have grown
+		group.vao = mesh.vao();
+		group.index_count = mesh.indices().size();
+		group.first_index = mesh.first_index();
+		group.base_vertex = mesh.base_vertex();
+		
+		group.instances.push_back(instance);
+	}
+	
+	void InstanceRenderer::draw(ShaderVariants& variants, const Material& defaultMaterial) {
+		upload();
+		
+		const Shader* current = nullptr;
+		const Material* currentMaterial = nullptr;
+		size_t first = 0;
+		for (const Group& group : m_groups) {
+			size_t count = group.instances.size();
+			if (count == 0) {
+				continue;
+			}
+			const Material& material = group.material ? *group.material : defaultMaterial;
+			const Shader& shader = material.shader(variants, {DEFINE});
+			if (!shader.ready()) {
+				first += count;
+				continue;
+			}
+			if (&shader != current) {
+				shader.use();
+				current = &shader;
+				currentMaterial = nullptr;
+			}
+			if (&material != currentMaterial) {
+				material.bind(shader);
+				currentMaterial = &material;
+			}
+			
+			// The VAO holds the mesh's index buffer
+			GLBackend::current().bind_vertex_array(group.vao);
+			
+			// Point the instance attributes at this group's range of the buffer
+			GLBackend::current().bind_buffer(GL_ARRAY_BUFFER, m_vbo);
+			set_instance_attributes(first * sizeof(Instance));
+			
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, group.index_count, GL_UNSIGNED_INT,
+				(void*) (group.first_index * sizeof(unsigned int)), count, group.base_vertex);
+			RenderStats::add(RenderStats::DRAW_CALLS);
+			RenderStats::add(RenderStats::TRIANGLES, group.index_count / 3 * count);
+			
+			first += count;
+		}
+	}
+	
+	size_t InstanceRenderer::group_count() const {
+		size_t count = 0;
+		for (const Group& group : m_groups) {
+			if (!group.instances.empty()) {
+				count++;
+			}
+		}
+		return count;
+	}
+	size_t InstanceRenderer::instance_count() const {
+		size_t count = 0;
+		for (const Group& group : m_groups) {
+			count += group.instances.size();
+		}
+		return count;
+	}
+	unsigned int InstanceRenderer::vbo() const {
+		return m_vbo;
+	}
+	
+	void InstanceRenderer::destroy() {
+		std::cout << "Destroying instance buffer (vbo=" << m_vbo << ")" << std::endl;
+		GLBackend::current().delete_buffer(m_vbo);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::BUFFER, m_vbo);
+		m_vbo = 0;
+		m_capacity = 0;
+	}
+	
+	size_t InstanceRenderer::GroupKeyHash::operator()(const GroupKey& key) const {
+		uint64_t hash = util::hash_combine(key.vao, key.first_index);
+		return util::hash_combine(hash, reinterpret_cast<uintptr_t>(key.material));
+	}
+	
+	InstanceRenderer::Instance InstanceRenderer::instance(const object::Renderable& renderable) {
+		return instance(renderable.get_model(), renderable.get_albedo());
+	}
+	InstanceRenderer::Instance InstanceRenderer::instance(const math::Mat4& model, const math::Vec4& albedo) {
+		Instance instance;
+		std::memcpy(instance.model, model.data(), sizeof(instance.model));
+		instance.albedo[0] = albedo.x();
+		instance.albedo[1] = albedo.y();
+		instance.albedo[2] = albedo.z();
+		instance.albedo[3] = albedo.w();
+		return instance;
+	}
+	void InstanceRenderer::set_instance_attributes(size_t offset) {
+		for (unsigned int row = 0; row < 4; row++) {
+			unsigned int location = MODEL_LOCATION + row;
+			glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+				(void*) (offset + row * 4 * sizeof(float)));
+			glVertexAttribDivisor(location, 1);
+			glEnableVertexAttribArray(location);
+		}
+		glVertexAttribPointer(ALBEDO_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			(void*) (offset + offsetof(Instance, albedo)));
+		glVertexAttribDivisor(ALBEDO_LOCATION, 1);
+		glEnableVertexAttribArray(ALBEDO_LOCATION);
+	}
+	
+	void InstanceRenderer::upload() {
+		m_staging.clear();
+		for (const Group& group : m_groups) {
+			m_staging.insert(m_staging.end(), group.instances.begin(), group.instances.end());
+		}
+		if (m_staging.empty()) {
+			return;
+		}
+		
+		size_t bytes = m_staging.size() * sizeof(Instance);
+		GLBackend::current().bind_buffer(GL_ARRAY_BUFFER, m_vbo);
+		if (bytes > m_capacity) {
+			// Grow geometrically so a slowly growing scene doesn't reallocate every frame
+			m_capacity = std::max(bytes, m_capacity * 2);
+		}
+		// Orphan the previous frame's storage instead of waiting for the GPU to finish reading it
+		glBufferData(GL_ARRAY_BUFFER, m_capacity, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_staging.data());
+		RenderStats::add(RenderStats::BUFFER_BYTES, bytes);
+		profile::MemoryTracker::track(profile::MemoryTracker::BUFFER, m_vbo, m_capacity, "instance buffer");
+	}
+} // engine::render
\ No newline at end of file
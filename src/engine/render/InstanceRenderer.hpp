@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "../object/Renderable.hpp"
+#include "../object/Material.hpp"
+#include "ShaderVariants.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * Draws Renderables that share a mesh and material with one glDrawElementsInstanced per group.
+	 * Model matrices and albedo of all instances are streamed into a single per-instance vertex
+	 * buffer each frame, read by the INSTANCED permutation of tex-3d.vert.
+	 * Instances keep the order they were added in within their group, but groups are drawn one
+	 * after another, so blended objects that have to be sorted should be drawn individually.
+	 */
+	class InstanceRenderer {
+	public:
+		// Attribute locations of the per-instance data, the model matrix takes four of them
+		static constexpr unsigned int MODEL_LOCATION = 2;
+		static constexpr unsigned int ALBEDO_LOCATION = 6;
+		static constexpr const char* DEFINE = "INSTANCED";
+		
+		// Layout of one instance in the per-instance vertex buffer
+		struct Instance {
+			float model[16];
+			float albedo[4];
+		};
+	
+	private:
+		struct Group {
+			unsigned int vao;
+			size_t index_count;
+			unsigned int first_index;
+			int base_vertex;
+			const Material* material;
+			std::vector<Instance> instances;
+		};
+		// Meshes in a GeometryArena share the vao, so their first index tells them apart
+		struct GroupKey {
+			unsigned int vao;
+			unsigned int first_index;
+			const Material* material;
+			
+			bool operator==(const GroupKey& other) const = default;
+		};
+		struct GroupKeyHash {
+			size_t operator()(const GroupKey& key) const;
+		};
+		
+		unsigned int m_vbo;
+		size_t m_capacity;
+		std::vector<Group> m_groups;
+		std::unordered_map<GroupKey, size_t, GroupKeyHash> m_group_indices;
+		std::vector<Instance> m_staging;
+	
+	public:
+		InstanceRenderer();
+		
+		InstanceRenderer(const InstanceRenderer& other) = default;
+		InstanceRenderer(InstanceRenderer&& other) noexcept = default;
+		InstanceRenderer& operator=(const InstanceRenderer& other) = default;
+		InstanceRenderer& operator=(InstanceRenderer&& other) noexcept = default;
+		~InstanceRenderer() = default;
+		
+		/**
+		 * Creates the per-instance vertex buffer.
+		 */
+		static InstanceRenderer create();
+		
+		/**
+		 * Clears the instances of the previous frame, keeping the allocations.
+		 */
+		void begin();
+		void add(const object::Renderable& renderable);
+		/**
+		 * Adds an instance without going through a Renderable, for callers that keep their
+		 * transforms elsewhere. A null material uses the default one.
+		 */
+		void add(const Mesh& mesh, const Material* material, const Instance& instance);
+		/**
+		 * Uploads all instances and draws every group. Renderables without a material use the
+		 * default one. Groups whose shader permutation isn't ready yet are skipped.
+		 */
+		void draw(ShaderVariants& variants, const Material& defaultMaterial);
+		
+		size_t group_count() const;
+		size_t instance_count() const;
+		unsigned int vbo() const;
+		
+		void destroy();
+		
+		static Instance instance(const object::Renderable& renderable);
+		static Instance instance(const math::Mat4& model, const math::Vec4& albedo);
+		/**
+		 * Points the instance attributes of the bound VAO at the buffer bound to GL_ARRAY_BUFFER,
+		 * starting at the given byte offset.
+		 */
+		static void set_instance_attributes(size_t offset);
+	
+	private:
+		void upload();
+	};
+	
+} // engine::render
@@ -0,0 +1,197 @@
+#include "MockGLBackend.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "GL/glew.h"
+
+namespace engine::render {
+	size_t MockGLBackend::Calls::state_changes() const {
+		return bind_texture + active_texture + use_program + bind_vertex_array + bind_buffer + bind_buffer_base + enable
+			+ disable + blend_func + depth_func + depth_mask;
+	}
+	
+	MockGLBackend::MockGLBackend()
+		: m_next_id(1), m_textures(), m_uploaded_bytes(0), m_active_unit(0), m_bound_textures(), m_program(0),
+		m_vertex_array(0), m_buffers(), m_indexed_buffers(), m_capabilities(), m_blend_func(GL_ONE, GL_ZERO), m_depth_func(GL_LESS), m_depth_mask(true),
+		m_calls() {
+	}
+	
+	unsigned int MockGLBackend::create_texture() {
+		m_calls.create_texture++;
+		unsigned int id = m_next_id++;
+		m_textures[id] = TextureState();
+		return id;
+	}
+	void MockGLBackend::delete_texture(unsigned int id) {
+		m_calls.delete_texture++;
+		m_textures.erase(id);
+		for (auto& [binding, texture] : m_bound_textures) {
+			if (texture == id) {
+				texture = 0;
+			}
+		}
+	}
+	void MockGLBackend::bind_texture(unsigned int target, unsigned int id) {
+		m_calls.bind_texture++;
+		m_bound_textures[{m_active_unit, target}] = id;
+	}
+	void MockGLBackend::tex_image_2d(unsigned int target, int level, int width, int height, const void* data) {
+		m_calls.tex_image_2d++;
+		std::vector<std::pair<int, int>>& levels = bound(target, "tex_image_2d").levels;
+		if (levels.size() <= static_cast<size_t>(level)) {
+			levels.resize(level + 1, {0, 0});
+		}
+		levels[level] = {width, height};
+		if (data != nullptr) {
+			m_uploaded_bytes += static_cast<size_t>(width) * height * 4;
+		}
+	}
+	void MockGLBackend::tex_parameter(unsigned int target, unsigned int name, int value) {
+		m_calls.tex_parameter++;
+		bound(target, "tex_parameter").parameters[name] = value;
+	}
+	void MockGLBackend::active_texture(unsigned int unit) {
+		m_calls.active_texture++;
+		m_active_unit = unit;
+	}
+	
+	void MockGLBackend::use_program(unsigned int id) {
+		m_calls.use_program++;
+		m_program = id;
+	}
+	void MockGLBackend::delete_program(unsigned int id) {
+		m_calls.delete_program++;
+		if (m_program == id) {
+			m_program = 0;
+		}
+	}
+	void MockGLBackend::bind_vertex_array(unsigned int id) {
+		m_calls.bind_vertex_array++;
+		m_vertex_array = id;
+	}
+	void MockGLBackend::delete_vertex_array(unsigned int id) {
+		m_calls.delete_vertex_array++;
+		if (m_vertex_array == id) {
+			m_vertex_array = 0;
+		}
+	}
+	void MockGLBackend::bind_buffer(unsigned int target, unsigned int id) {
+		m_calls.bind_buffer++;
+		m_buffers[target] = id;
+	}
+	void MockGLBackend::bind_buffer_base(unsigned int target, unsigned int index, unsigned int id) {
+		m_calls.bind_buffer_base++;
+		// Binds the generic binding point as well
+		m_indexed_buffers[{target, index}] = id;
+		m_buffers[target] = id;
+	}
+	void MockGLBackend::delete_buffer(unsigned int id) {
+		m_calls.delete_buffer++;
+		for (auto& [target, buffer] : m_buffers) {
+			if (buffer == id) {
+				buffer = 0;
+			}
+		}
+		for (auto& [binding, buffer] : m_indexed_buffers) {
+			if (buffer == id) {
+				buffer = 0;
+			}
+		}
+	}
+	
+	void MockGLBackend::enable(unsigned int capability) {
+		m_calls.enable++;
+		m_capabilities[capability] = true;
+	}
+	void MockGLBackend::disable(unsigned int capability) {
+		m_calls.disable++;
+		m_capabilities[capability] = false;
+	}
+	void MockGLBackend::blend_func(unsigned int source, unsigned int destination) {
+		m_calls.blend_func++;
+		m_blend_func = {source, destination};
+	}
+	void MockGLBackend::depth_func(unsigned int func) {
+		m_calls.depth_func++;
+		m_depth_func = func;
+	}
+	void MockGLBackend::depth_mask(bool write) {
+		m_calls.depth_mask++;
+		m_depth_mask = write;
+	}
+	
+	const MockGLBackend::Calls& MockGLBackend::calls() const {
+		return m_calls;
+	}
+	void MockGLBackend::reset_calls() {
+		m_calls = Calls();
+	}
+	
+	bool MockGLBackend::has_texture(unsigned int id) const {
+		return m_textures.contains(id);
+	}
+	const MockGLBackend::TextureState& MockGLBackend::texture(unsigned int id) const {
+		return m_textures.at(id);
+	}
+	size_t MockGLBackend::texture_bytes() const {
+		size_t bytes = 0;
+		for (const auto& [id, state] : m_textures) {
+			bytes += texture_bytes(id);
+		}
+		return bytes;
+	}
+	size_t MockGLBackend::texture_bytes(unsigned int id) const {
+		size_t bytes = 0;
+		for (const auto& [width, height] : m_textures.at(id).levels) {
+			bytes += static_cast<size_t>(width) * height * 4;
+		}
+		return bytes;
+	}
+	size_t MockGLBackend::uploaded_bytes() const {
+		return m_uploaded_bytes;
+	}
+	
+	unsigned int MockGLBackend::active_unit() const {
+		return m_active_unit;
+	}
+	unsigned int MockGLBackend::bound_texture(unsigned int unit, unsigned int target) const {
+		auto it = m_bound_textures.find({unit, target});
+		return it == m_bound_textures.end() ? 0 : it->second;
+	}
+	unsigned int MockGLBackend::program() const {
+		return m_program;
+	}
+	unsigned int MockGLBackend::vertex_array() const {
+		return m_vertex_array;
+	}
+	unsigned int MockGLBackend::buffer(unsigned int target) const {
+		auto it = m_buffers.find(target);
+		return it == m_buffers.end() ? 0 : it->second;
+	}
+	unsigned int MockGLBackend::buffer(unsigned int target, unsigned int index) const {
+		auto it = m_indexed_buffers.find({target, index});
+		return it == m_indexed_buffers.end() ? 0 : it->second;
+	}
+	bool MockGLBackend::enabled(unsigned int capability) const {
+		auto it = m_capabilities.find(capability);
+		return it != m_capabilities.end() && it->second;
+	}
+	std::pair<unsigned int, unsigned int> MockGLBackend::blend_func() const {
+		return m_blend_func;
+	}
+	unsigned int MockGLBackend::depth_func() const {
+		return m_depth_func;
+	}
+	bool MockGLBackend::depth_mask() const {
+		return m_depth_mask;
+	}
+	
+	MockGLBackend::TextureState& MockGLBackend::bound(unsigned int target, const char* call) {
+		auto it = m_textures.find(bound_texture(m_active_unit, target));
+		if (it == m_textures.end()) {
+			throw std::logic_error(std::string(call) + " without a bound texture");
+		}
+		return it->second;
+	}
+} // engine::render
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+#include "GLBackend.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * A GLBackend that never touches OpenGL.
+	 * It hands out fake object names and records what was allocated, what is bound and how often each
+	 * call was made, so GPU-side bookkeeping and redundant state changes can be checked without a context.
+	 */
+	class MockGLBackend : public GLBackend {
+	public:
+		struct Calls {
+			size_t create_texture = 0;
+			size_t delete_texture = 0;
+			size_t bind_texture = 0;
+			size_t tex_image_2d = 0;
+			size_t tex_parameter = 0;
+			size_t active_texture = 0;
+			size_t use_program = 0;
+			size_t delete_program = 0;
+			size_t bind_vertex_array = 0;
+			size_t delete_vertex_array = 0;
+			size_t bind_buffer = 0;
+			size_t bind_buffer_base = 0;
+			size_t delete_buffer = 0;
+			size_t enable = 0;
+			size_t disable = 0;
+			size_t blend_func = 0;
+			size_t depth_func = 0;
+			size_t depth_mask = 0;
+			
+			/**
+			 * Calls that change binding or fixed function state.
+			 */
+			size_t state_changes() const;
+		};
+		struct TextureState {
+			// (width, height) per level, (0, 0) for undefined levels
+			std::vector<std::pair<int, int>> levels;
+			std::map<unsigned int, int> parameters;
+		};
+	
+	private:
+		unsigned int m_next_id;
+		std::map<unsigned int, TextureState> m_textures;
+		// Bytes passed to tex_image_2d with data, levels only allocated don't count
+		size_t m_uploaded_bytes;
+		
+		unsigned int m_active_unit;
+		// (unit, target) -> texture
+		std::map<std::pair<unsigned int, unsigned int>, unsigned int> m_bound_textures;
+		unsigned int m_program;
+		unsigned int m_vertex_array;
+		std::map<unsigned int, unsigned int> m_buffers;
+		// (target, index) -> buffer
+		std::map<std::pair<unsigned int, unsigned int>, unsigned int> m_indexed_buffers;
+		std::map<unsigned int, bool> m_capabilities;
+		std::pair<unsigned int, unsigned int> m_blend_func;
+		unsigned int m_depth_func;
+		bool m_depth_mask;
+		
+		Calls m_calls;
+	
+	public:
+		MockGLBackend();
+		
+		unsigned int create_texture() override;
+		void delete_texture(unsigned int id) override;
+		void bind_texture(unsigned int target, unsigned int id) override;
+		void tex_image_2d(unsigned int target, int level, int width, int height, const void* data) override;
+		void tex_parameter(unsigned int target, unsigned int name, int value) override;
+		void active_texture(unsigned int unit) override;
+		
+		void use_program(unsigned int id) override;
+		void delete_program(unsigned int id) override;
+		void bind_vertex_array(unsigned int id) override;
+		void delete_vertex_array(unsigned int id) override;
+		void bind_buffer(unsigned int target, unsigned int id) override;
+		void bind_buffer_base(unsigned int target, unsigned int index, unsigned int id) override;
+		void delete_buffer(unsigned int id) override;
+		
+		void enable(unsigned int capability) override;
+		void disable(unsigned int capability) override;
+		void blend_func(unsigned int source, unsigned int destination) override;
+		void depth_func(unsigned int func) override;
+		void depth_mask(bool write) override;
+		
+		const Calls& calls() const;
+		void reset_calls();
+		
+		bool has_texture(unsigned int id) const;
+		const TextureState& texture(unsigned int id) const;
+		/**
+		 * Sum of all defined RGBA8 texture levels.
+		 */
+		size_t texture_bytes() const;
+		size_t texture_bytes(unsigned int id) const;
+		size_t uploaded_bytes() const;
+		
+		unsigned int active_unit() const;
+		unsigned int bound_texture(unsigned int unit, unsigned int target) const;
+		unsigned int program() const;
+		unsigned int vertex_array() const;
+		unsigned int buffer(unsigned int target) const;
+		unsigned int buffer(unsigned int target, unsigned int index) const;
+		bool enabled(unsigned int capability) const;
+		std::pair<unsigned int, unsigned int> blend_func() const;
+		unsigned int depth_func() const;
+		bool depth_mask() const;
+	
+	private:
+		TextureState& bound(unsigned int target, const char* call);
+	};
+	
+} // engine::render
@@ -0,0 +1,316 @@
+#include "OcclusionCuller.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OCCLUSION_SSE
+#endif
+
+namespace {
+	// Triangles thinner than this in pixels cover nothing worth storing
+	constexpr float MIN_AREA = 1e-6f;
+	// Bounds with a corner closer than this to the camera plane are never culled
+	constexpr float MIN_W = 1e-5f;
+	// Slack in the depth test so a surface in the depth buffer doesn't hide itself through rounding
+	constexpr float DEPTH_EPSILON = 1e-5f;
+}
+
+namespace engine::render {
+	OcclusionCuller::OcclusionCuller()
+		: OcclusionCuller(DEFAULT_WIDTH, DEFAULT_HEIGHT) {
+	}
+	OcclusionCuller::OcclusionCuller(int width, int height)
+		: m_width((std::max(width, 4) + 3) & ~3), m_height(std::max(height, 1)), m_view_projection(), m_levels(),
+		m_level_widths(), m_level_heights(), m_clip_vertices(), m_occluders(), m_triangles(0), m_tested(0),
+		m_occluded(0) {
+		int levelWidth = m_width;
+		int levelHeight = m_height;
+		while (true) {
+			m_levels.emplace_back(static_cast<size_t>(levelWidth) * levelHeight, 1.0f);
+			m_level_widths.push_back(levelWidth);
+			m_level_heights.push_back(levelHeight);
+			if (levelWidth == 1 && levelHeight == 1) {
+				break;
+			}
+			levelWidth = std::max(1, (levelWidth + 1) / 2);
+			levelHeight = std::max(1, (levelHeight + 1) / 2);
+		}
+	}
+	
+	void OcclusionCuller::begin(const math::Mat4& viewProjection) {
+		m_view_projection = viewProjection;
+		std::fill(m_levels[0].begin(), m_levels[0].end(), 1.0f);
+		m_occluders.clear();
+		m_triangles = 0;
+	}
+	void OcclusionCuller::add_occluder(const object::Renderable& renderable) {
+		add_occluder(renderable.get_mesh(), renderable.get_model());
+		m_occluders.push_back(&renderable);
+	}
+	void OcclusionCuller::add_occluder(const Mesh& mesh, const math::Mat4& model) {
+		std::vector<math::Vec3> positions(mesh.vertices().size());
+		for (size_t i = 0; i < positions.size(); i++) {
+			positions[i] = mesh.vertices()[i].position;
+		}
+		add_occluder(positions, mesh.indices(), model);
+	}
+	void OcclusionCuller::add_occluder(const std::vector<math::Vec3>& positions,
+		const std::vector<unsigned int>& indices, const math::Mat4& model) {
+		math::Mat4 matrix = m_view_projection * model;
+		const float* m = matrix.data();
+		m_clip_vertices.resize(positions.size());
+		for (size_t i = 0; i < positions.size(); i++) {
+			const math::Vec3& p = positions[i];
+			m_clip_vertices[i] = {
+				m[0] * p.x() + m[1] * p.y() + m[2] * p.z() + m[3],
+				m[4] * p.x() + m[5] * p.y() + m[6] * p.z() + m[7],
+				m[8] * p.x() + m[9] * p.y() + m[10] * p.z() + m[11],
+				m[12] * p.x() + m[13] * p.y() + m[14] * p.z() + m[15]
+			};
+		}
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			rasterize(m_clip_vertices[indices[i]], m_clip_vertices[indices[i + 1]], m_clip_vertices[indices[i + 2]]);
+		}
+	}
+	void OcclusionCuller::finish() {
+		// Each texel keeps the farthest depth below it, so a test against it is conservative
+		for (size_t level = 1; level < m_levels.size(); level++) {
+			const std::vector<float>& source = m_levels[level - 1];
+			std::vector<float>& target = m_levels[level];
+			int sourceWidth = m_level_widths[level - 1];
+			int sourceHeight = m_level_heights[level - 1];
+			for (int y = 0; y < m_level_heights[level]; y++) {
+				int y0 = std::min(2 * y, sourceHeight - 1);
+				int y1 = std::min(2 * y + 1, sourceHeight - 1);
+				for (int x = 0; x < m_level_widths[level]; x++) {
+					int x0 = std::min(2 * x, sourceWidth - 1);
+					int x1 = std::min(2 * x + 1, sourceWidth - 1);
+					target[y * m_level_widths[level] + x] = std::max(
+						std::max(source[y0 * sourceWidth + x0], source[y0 * sourceWidth + x1]),
+						std::max(source[y1 * sourceWidth + x0], source[y1 * sourceWidth + x1]));
+				}
+			}
+		}
+	}
+	
+	bool OcclusionCuller::visible(const math::AABB& box) const {
+		const float* m = m_view_projection.data();
+		const math::Vec3& lo = box.min();
+		const math::Vec3& hi = box.max();
+		float minX = m_width, minY = m_height, maxX = 0, maxY = 0, minZ = 1;
+		int behind = 0;
+		for (int i = 0; i < 8; i++) {
+			float px = i & 1 ? hi.x() : lo.x();
+			float py = i & 2 ? hi.y() : lo.y();
+			float pz = i & 4 ? hi.z() : lo.z();
+			float x = m[0] * px + m[1] * py + m[2] * pz + m[3];
+			float y = m[4] * px + m[5] * py + m[6] * pz + m[7];
+			float z = m[8] * px + m[9] * py + m[10] * pz + m[11];
+			float w = m[12] * px + m[13] * py + m[14] * pz + m[15];
+			if (w < MIN_W || z < -w) {
+				behind++;
+				continue;
+			}
+			float sx = (x / w * 0.5f + 0.5f) * m_width;
+			float sy = (y / w * 0.5f + 0.5f) * m_height;
+			minX = std::min(minX, sx);
+			maxX = std::max(maxX, sx);
+			minY = std::min(minY, sy);
+			maxY = std::max(maxY, sy);
+			minZ = std::min(minZ, z / w * 0.5f + 0.5f);
+		}
+		if (behind == 8) {
+			return false;
+		}
+		if (behind > 0) {
+			// Crosses the near plane, its screen bounds are unbounded
+			return true;
+		}
+		if (maxX < 0 || maxY < 0 || minX >= m_width || minY >= m_height) {
+			return false;
+		}
+		
+		int x0 = std::clamp(static_cast<int>(minX), 0, m_width - 1);
+		int x1 = std::clamp(static_cast<int>(maxX), 0, m_width - 1);
+		int y0 = std::clamp(static_cast<int>(minY), 0, m_height - 1);
+		int y1 = std::clamp(static_cast<int>(maxY), 0, m_height - 1);
+		// Coarsest level needed so the rectangle covers at most 2x2 texels
+		size_t level = 0;
+		while (level + 1 < m_levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+			level++;
+		}
+		const std::vector<float>& depth = m_levels[level];
+		int levelWidth = m_level_widths[level];
+		float maxDepth = 0;
+		for (int y = y0 >> level; y <= y1 >> level; y++) {
+			for (int x = x0 >> level; x <= x1 >> level; x++) {
+				maxDepth = std::max(maxDepth, depth[y * levelWidth + x]);
+			}
+		}
+		return minZ <= maxDepth + DEPTH_EPSILON;
+	}
+	void OcclusionCuller::cull(const std::vector<object::Renderable*>& renderables,
+		std::vector<object::Renderable*>& visible) {
+		m_tested = 0;
+		m_occluded = 0;
+		for (object::Renderable* renderable : renderables) {
+			// There are only a few occluders, a linear search is fine
+			if (std::find(m_occluders.begin(), m_occluders.end(), renderable) != m_occluders.end()) {
+				visible.push_back(renderable);
+				continue;
+			}
+			m_tested++;
+			if (this->visible(renderable->get_mesh().bounds().transform(renderable->get_model()))) {
+				visible.push_back(renderable);
+			}
+			else {
+				m_occluded++;
+			}
+		}
+	}
+	
+	int OcclusionCuller::width() const {
+		return m_width;
+	}
+	int OcclusionCuller::height() const {
+		return m_height;
+	}
+	size_t OcclusionCuller::level_count() const {
+		return m_levels.size();
+	}
+	int OcclusionCuller::level_width(size_t level) const {
+		return m_level_widths[level];
+	}
+	int OcclusionCuller::level_height(size_t level) const {
+		return m_level_heights[level];
+	}
+	const std::vector<float>& OcclusionCuller::level(size_t level) const {
+		return m_levels[level];
+	}
+	
+	size_t OcclusionCuller::triangle_count() const {
+		return m_triangles;
+	}
+	size_t OcclusionCuller::tested() const {
+		return m_tested;
+	}
+	size_t OcclusionCuller::occluded() const {
+		return m_occluded;
+	}
+	
+	void OcclusionCuller::rasterize(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c) {
+		// Clip against the near plane (z >= -w), which can turn the triangle into a quad
+		const ClipVertex* input[3] = {&a, &b, &c};
+		ClipVertex polygon[4];
+		int count = 0;
+		for (int i = 0; i < 3; i++) {
+			const ClipVertex& current = *input[i];
+			const ClipVertex& next = *input[(i + 1) % 3];
+			float dCurrent = current.z + current.w;
+			float dNext = next.z + next.w;
+			if (dCurrent >= 0) {
+				polygon[count++] = current;
+			}
+			if ((dCurrent >= 0) != (dNext >= 0)) {
+				float t = dCurrent / (dCurrent - dNext);
+				polygon[count++] = {
+					current.x + (next.x - current.x) * t,
+					current.y + (next.y - current.y) * t,
+					current.z + (next.z - current.z) * t,
+					current.w + (next.w - current.w) * t
+				};
+			}
+		}
+		if (count < 3) {
+			return;
+		}
+		
+		ScreenVertex screen[4];
+		for (int i = 0; i < count; i++) {
+			const ClipVertex& v = polygon[i];
+			if (v.w < MIN_W) {
+				return;
+			}
+			screen[i] = {
+				(v.x / v.w * 0.5f + 0.5f) * m_width,
+				(v.y / v.w * 0.5f + 0.5f) * m_height,
+				v.z / v.w * 0.5f + 0.5f
+			};
+		}
+		rasterize(screen[0], screen[1], screen[2]);
+		if (count == 4) {
+			rasterize(screen[0], screen[2], screen[3]);
+		}
+	}
+	void OcclusionCuller::rasterize(ScreenVertex a, ScreenVertex b, ScreenVertex c) {
+		float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+		if (std::abs(area) < MIN_AREA) {
+			return;
+		}
+		// Occluders are rasterized from both sides, make the winding counter-clockwise
+		if (area < 0) {
+			std::swap(b, c);
+			area = -area;
+		}
+		
+		int minX = std::max(0, static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))));
+		int maxX = std::min(m_width - 1, static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))));
+		int minY = std::max(0, static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))));
+		int maxY = std::min(m_height - 1, static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))));
+		if (minX > maxX || minY > maxY) {
+			return;
+		}
+		m_triangles++;
+		
+		// Edge functions e(x, y) = ex * x + ey * y + e0, positive inside; edge i is opposite vertex i
+		float e0x = b.y - c.y, e0y = c.x - b.x, e00 = b.x * c.y - b.y * c.x;
+		float e1x = c.y - a.y, e1y = a.x - c.x, e10 = c.x * a.y - c.y * a.x;
+		float e2x = a.y - b.y, e2y = b.x - a.x, e20 = a.x * b.y - a.y * b.x;
+		// Depth is affine in screen space: z = zx * x + zy * y + z0
+		float zx = (e0x * a.z + e1x * b.z + e2x * c.z) / area;
+		float zy = (e0y * a.z + e1y * b.z + e2y * c.z) / area;
+		float z0 = (e00 * a.z + e10 * b.z + e20 * c.z) / area;
+		
+		std::vector<float>& depth = m_levels[0];
+		// Rows are processed in aligned blocks of four pixels
+		int startX = minX & ~3;
+		for (int y = minY; y <= maxY; y++) {
+			float py = y + 0.5f;
+			float* row = depth.data() + static_cast<size_t>(y) * m_width;
+			int x = startX;
+#ifdef OCCLUSION_SSE
+			const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+			const __m128 zero = _mm_setzero_ps();
+			__m128 row0 = _mm_set1_ps(e0y * py + e00);
+			__m128 row1 = _mm_set1_ps(e1y * py + e10);
+			__m128 row2 = _mm_set1_ps(e2y * py + e20);
+			__m128 rowZ = _mm_set1_ps(zy * py + z0);
+			for (; x <= maxX; x += 4) {
+				__m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+				__m128 w0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e0x), px), row0);
+				__m128 w1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e1x), px), row1);
+				__m128 w2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e2x), px), row2);
+				__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)),
+					_mm_cmpge_ps(w2, zero));
+				if (_mm_movemask_ps(inside) == 0) {
+					continue;
+				}
+				__m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(zx), px), rowZ);
+				__m128 current = _mm_loadu_ps(row + x);
+				__m128 nearer = _mm_min_ps(current, z);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+			}
+#else
+			for (; x <= maxX; x++) {
+				float px = x + 0.5f;
+				if (e0x * px + e0y * py + e00 >= 0 && e1x * px + e1y * py + e10 >= 0 &&
+					e2x * px + e2y * py + e20 >= 0) {
+					row[x] = std::min(row[x], zx * px + zy * py + z0);
+				}
+			}
+#endif
+		}
+	}
+} // engine::render
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "../math/Vec3.hpp"
+#include "../math/Mat4.hpp"
+#include "../math/AABB.hpp"
+#include "../object/Renderable.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * Software occlusion culling. Selected occluder meshes are rasterized on the CPU into a small
+	 * depth buffer (four pixels at a time with SSE2), which is then reduced into a pyramid holding
+	 * the farthest depth of each 2x2 block. An object is hidden if the nearest point of its screen
+	 * space bounds is behind every pyramid texel covering them; one pyramid level is picked so that
+	 * no more than 2x2 texels are read per object.
+	 * Needs no GL context.
+	 */
+	class OcclusionCuller {
+	public:
+		static constexpr int DEFAULT_WIDTH = 256;
+		static constexpr int DEFAULT_HEIGHT = 128;
+	
+	private:
+		struct ClipVertex {
+			float x, y, z, w;
+		};
+		struct ScreenVertex {
+			float x, y, z;
+		};
+		
+		int m_width, m_height;
+		math::Mat4 m_view_projection;
+		// Level 0 is the full resolution depth buffer, depths are in [0, 1] with 1 the far plane
+		std::vector<std::vector<float>> m_levels;
+		std::vector<int> m_level_widths;
+		std::vector<int> m_level_heights;
+		
+		std::vector<ClipVertex> m_clip_vertices;
+		// Occluders added as renderables, cull() keeps them without testing them against themselves
+		std::vector<const object::Renderable*> m_occluders;
+		size_t m_triangles;
+		size_t m_tested;
+		size_t m_occluded;
+	
+	public:
+		OcclusionCuller();
+		/**
+		 * The width is rounded up to a multiple of four for the SIMD rows.
+		 */
+		OcclusionCuller(int width, int height);
+		
+		OcclusionCuller(const OcclusionCuller& other) = default;
+		OcclusionCuller(OcclusionCuller&& other) noexcept = default;
+		OcclusionCuller& operator=(const OcclusionCuller& other) = default;
+		OcclusionCuller& operator=(OcclusionCuller&& other) noexcept = default;
+		~OcclusionCuller() = default;
+		
+		/**
+		 * Clears the depth buffer for a new frame.
+		 */
+		void begin(const math::Mat4& viewProjection);
+		/**
+		 * Rasterizes the renderable's mesh and remembers it, so cull() never hides it behind itself.
+		 */
+		void add_occluder(const object::Renderable& renderable);
+		void add_occluder(const Mesh& mesh, const math::Mat4& model);
+		void add_occluder(const std::vector<math::Vec3>& positions, const std::vector<unsigned int>& indices,
+			const math::Mat4& model);
+		/**
+		 * Builds the depth pyramid, call after the last occluder and before testing.
+		 */
+		void finish();
+		
+		/**
+		 * @return false if the box is entirely hidden behind the occluders or off screen
+		 */
+		bool visible(const math::AABB& box) const;
+		/**
+		 * Appends the renderables that aren't occluded to the output, keeping their order.
+		 * Renderables added as occluders this frame are appended without being tested.
+		 */
+		void cull(const std::vector<object::Renderable*>& renderables, std::vector<object::Renderable*>& visible);
+		
+		int width() const;
+		int height() const;
+		size_t level_count() const;
+		int level_width(size_t level) const;
+		int level_height(size_t level) const;
+		const std::vector<float>& level(size_t level) const;
+		
+		size_t triangle_count() const;
+		size_t tested() const;
+		size_t occluded() const;
+	
+	private:
+		void rasterize(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c);
+		void rasterize(ScreenVertex a, ScreenVertex b, ScreenVertex c);
+	};
+	
+} // engine::render
@@ -0,0 +1,147 @@
+#include "ProgramCache.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+
+#include "GL/glew.h"
+
+#include "../util/Hash.hpp"
+
+namespace {
+	struct BinaryHeader {
+		char magic[4];
+		uint32_t version;
+		uint64_t key;
+		uint32_t format;
+		uint32_t length;
+	};
+	
+	constexpr char MAGIC[4] = {'G', 'L', 'P', 'B'};
+	constexpr uint32_t VERSION = 1;
+	
+	const char* gl_string(GLenum name) {
+		const unsigned char* value = glGetString(name);
+		return value ? reinterpret_cast<const char*>(value) : "";
+	}
+	bool binaries_supported() {
+		if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) {
+			return false;
+		}
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		return formats > 0;
+	}
+}
+
+namespace engine::render {
+	std::string ProgramCache::s_directory;
+	
+	void ProgramCache::set_directory(const std::string& directory) {
+		s_directory = directory;
+		if (!s_directory.empty()) {
+			std::error_code error;
+			std::filesystem::create_directories(s_directory, error);
+			if (error) {
+				std::cerr << "Failed to create shader cache directory " << s_directory << ": " << error.message()
+					<< std::endl;
+				s_directory.clear();
+			}
+		}
+	}
+	const std::string& ProgramCache::directory() {
+		return s_directory;
+	}
+	bool ProgramCache::enabled() {
+		return !s_directory.empty();
+	}
+	
+	uint64_t ProgramCache::key(const std::string& vertexSource, const std::string& fragmentSource) {
+		uint64_t hash = util::fnv1a(vertexSource);
+		hash = util::fnv1a(std::string_view("\0", 1), hash);
+		hash = util::fnv1a(fragmentSource, hash);
+		// Binaries are only valid for the driver that produced them
+		hash = util::fnv1a(gl_string(GL_VENDOR), hash);
+		hash = util::fnv1a(gl_string(GL_RENDERER), hash);
+		hash = util::fnv1a(gl_string(GL_VERSION), hash);
+		return hash;
+	}
+	
+	bool ProgramCache::load(uint64_t key, unsigned int program) {
+		if (!enabled() || !binaries_supported()) {
+			return false;
+		}
+		std::ifstream file(path(key), std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		BinaryHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+			header.key != key) {
+			return false;
+		}
+		std::vector<char> binary(header.length);
+		file.read(binary.data(), header.length);
+		if (!file) {
+			return false;
+		}
+		
+		glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+		int success;
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		if (!success) {
+			// The driver rejected the binary (e.g. after an update), compile from source instead
+			std::remove(path(key).c_str());
+			return false;
+		}
+		return true;
+	}
+	void ProgramCache::store(uint64_t key, unsigned int program) {
+		if (!enabled() || !binaries_supported()) {
+			return;
+		}
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0) {
+			return;
+		}
+		std::vector<char> binary(length);
+		GLenum format = 0;
+		glGetProgramBinary(program, length, nullptr, &format, binary.data());
+		
+		BinaryHeader header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.key = key;
+		header.format = format;
+		header.length = static_cast<uint32_t>(length);
+		
+		// Write to a temporary file first so a crash never leaves a truncated entry behind
+		std::string file_path = path(key);
+		std::string temp_path = file_path + ".tmp";
+		{
+			std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(binary.data(), length);
+			if (!file) {
+				std::cerr << "Failed to write shader cache entry " << temp_path << std::endl;
+				return;
+			}
+		}
+		std::error_code error;
+		std::filesystem::rename(temp_path, file_path, error);
+		if (error) {
+			std::cerr << "Failed to write shader cache entry " << file_path << ": " << error.message() << std::endl;
+		}
+	}
+	
+	std::string ProgramCache::path(uint64_t key) {
+		char name[17];
+		std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+		return (std::filesystem::path(s_directory) / (std::string(name) + ".bin")).string();
+	}
+} // engine::render
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace engine::render {
+	
+	/**
+	 * On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary).
+	 * Entries are keyed by the final shader sources and the driver, so a driver update or a
+	 * changed define simply misses the cache and the program is compiled again.
+	 * The cache is disabled until a directory is set.
+	 */
+	class ProgramCache {
+	private:
+		static std::string s_directory;
+	
+	public:
+		static void set_directory(const std::string& directory);
+		static const std::string& directory();
+		static bool enabled();
+		
+		static uint64_t key(const std::string& vertexSource, const std::string& fragmentSource);
+		
+		/**
+		 * Loads the cached binary into the program.
+		 * @return true if the program is linked and ready to use
+		 */
+		static bool load(uint64_t key, unsigned int program);
+		/**
+		 * Writes the binary of a linked program, which should have been linked with
+		 * GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+		 */
+		static void store(uint64_t key, unsigned int program);
+	
+	private:
+		static std::string path(uint64_t key);
+	};
+	
+} // engine::render
@@ -2,22 +2,33 @@
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 #include "../math/Mat4.hpp"
 #include "../math/Vec3.hpp"
 #include "../math/Vec4.hpp"
+#include "../jobs/JobSystem.hpp"
+#include "../profile/Profiler.hpp"
 
 namespace engine::render {
 	void RenderHelper::sortObjects(std::vector<object::Renderable*>& objects, const Camera& camera) {
+		PROFILE_SCOPE("RenderHelper::sortObjects");
 		math::Mat4 view = camera.view_matrix();
 		
-		std::sort(objects.begin(), objects.end(), [&view](const object::Renderable* a, const object::Renderable* b) {
-			math::Vec4 posA = view * a->get_model() * math::Vec4(0, 0, 0, 1);
-			math::Vec4 posB = view * b->get_model() * math::Vec4(0, 0, 0, 1);
-			
-			posA /= posA.w();
-			posB /= posB.w();
-			
-			return posA.z() < posB.z();
+		// The sort key is computed once per object, spread over the workers, instead of twice per comparison
+		std::vector<std::pair<float, object::Renderable*>> keyed(objects.size());
+		jobs::JobSystem::shared().parallel_for(0, objects.size(), 256, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				math::Vec4 position = view * objects[i]->get_model() * math::Vec4(0, 0, 0, 1);
+				position /= position.w();
+				keyed[i] = {position.z(), objects[i]};
+			}
 		});
+		
+		std::stable_sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) {
+			return a.first < b.first;
+		});
+		for (size_t i = 0; i < objects.size(); i++) {
+			objects[i] = keyed[i].second;
+		}
 	}
-} // engine::render
\ No newline at end of file
+} // engine::render
@@ -0,0 +1,160 @@
+#include "RenderStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace engine::render {
+	uint64_t RenderStats::s_counters[COUNTER_COUNT] = {};
+	std::vector<uint64_t> RenderStats::s_history[COUNTER_COUNT];
+	std::vector<RenderStats::Phase> RenderStats::s_phases;
+	uint64_t RenderStats::s_frames = 0;
+	
+	static const char* COUNTER_NAMES[RenderStats::COUNTER_COUNT] = {
+		"draw_calls",
+		"triangles",
+		"program_switches",
+		"texture_binds",
+		"uniform_uploads",
+		"buffer_bytes",
+		"objects_drawn",
+		"objects_culled"
+	};
+	
+	void RenderStats::add_time(const std::string& phase, std::chrono::nanoseconds time) {
+		for (Phase& existing : s_phases) {
+			if (existing.name == phase) {
+				existing.time += time;
+				return;
+			}
+		}
+		s_phases.push_back({phase, time, std::vector<float>(WINDOW, 0.0f)});
+	}
+	
+	void RenderStats::end_frame() {
+		size_t slot = s_frames % WINDOW;
+		for (int i = 0; i < COUNTER_COUNT; i++) {
+			if (s_history[i].empty()) {
+				s_history[i].resize(WINDOW, 0);
+			}
+			s_history[i][slot] = s_counters[i];
+			s_counters[i] = 0;
+		}
+		for (Phase& phase : s_phases) {
+			phase.history[slot] = std::chrono::duration<float, std::milli>(phase.time).count();
+			phase.time = std::chrono::nanoseconds(0);
+		}
+		s_frames++;
+	}
+	
+	uint64_t RenderStats::last(Counter counter) {
+		if (s_frames == 0) {
+			return 0;
+		}
+		return s_history[counter][(s_frames - 1) % WINDOW];
+	}
+	
+	RenderStats::Percentiles RenderStats::percentiles(Counter counter) {
+		if (s_frames == 0) {
+			return {0, 0, 0, 0};
+		}
+		return percentiles(std::vector<double>(s_history[counter].begin(), s_history[counter].begin() + samples()));
+	}
+	RenderStats::Percentiles RenderStats::percentiles(const std::string& phase) {
+		for (const Phase& existing : s_phases) {
+			if (existing.name == phase) {
+				return percentiles(std::vector<double>(existing.history.begin(), existing.history.begin() + samples()));
+			}
+		}
+		return {0, 0, 0, 0};
+	}
+	size_t RenderStats::frames() {
+		return s_frames;
+	}
+	
+	const char* RenderStats::name(Counter counter) {
+		return COUNTER_NAMES[counter];
+	}
+	
+	std::string RenderStats::report() {
+		std::string report;
+		char line[128];
+		for (int i = 0; i < COUNTER_COUNT; i++) {
+			Percentiles p = percentiles((Counter) i);
+			std::snprintf(line, sizeof(line), "%-18s p50 %10.0f  p95 %10.0f  p99 %10.0f\n", COUNTER_NAMES[i], p.p50,
+				p.p95, p.p99);
+			report += line;
+		}
+		for (const Phase& phase : s_phases) {
+			Percentiles p = percentiles(phase.name);
+			std::snprintf(line, sizeof(line), "%-18s p50 %7.3f ms  p95 %7.3f ms  p99 %7.3f ms\n", phase.name.c_str(),
+				p.p50, p.p95, p.p99);
+			report += line;
+		}
+		return report;
+	}
+	
+	bool RenderStats::write_csv(const std::string& path) {
+		std::ofstream file(path);
+		if (!file) {
+			std::cerr << "Failed to write render stats to " << path << std::endl;
+			return false;
+		}
+		
+		file << "frame";
+		for (const char* name : COUNTER_NAMES) {
+			file << ',' << name;
+		}
+		for (const Phase& phase : s_phases) {
+			file << ',' << phase.name << "_ms";
+		}
+		file << '\n';
+		
+		for (uint64_t frame = s_frames - samples(); frame < s_frames; frame++) {
+			size_t slot = frame % WINDOW;
+			file << frame;
+			for (int i = 0; i < COUNTER_COUNT; i++) {
+				file << ',' << s_history[i][slot];
+			}
+			for (const Phase& phase : s_phases) {
+				file << ',' << phase.history[slot];
+			}
+			file << '\n';
+		}
+		return (bool) file;
+	}
+	
+	void RenderStats::reset() {
+		for (int i = 0; i < COUNTER_COUNT; i++) {
+			s_counters[i] = 0;
+			s_history[i].clear();
+		}
+		s_phases.clear();
+		s_frames = 0;
+	}
+	
+	size_t RenderStats::samples() {
+		return (size_t) std::min<uint64_t>(s_frames, WINDOW);
+	}
+	
+	RenderStats::Percentiles RenderStats::percentiles(std::vector<double> values) {
+		if (values.empty()) {
+			return {0, 0, 0, 0};
+		}
+		std::sort(values.begin(), values.end());
+		// Nearest rank
+		auto rank = [&](double p) {
+			size_t index = (size_t) std::ceil(p * values.size());
+			return values[std::clamp<size_t>(index, 1, values.size()) - 1];
+		};
+		return {rank(0.5), rank(0.95), rank(0.99), values.back()};
+	}
+	
+	RenderStats::Timer::Timer(const char* phase) : m_phase(phase), m_start(std::chrono::steady_clock::now()) {
+	}
+	RenderStats::Timer::~Timer() {
+		add_time(m_phase, std::chrono::steady_clock::now() - m_start);
+	}
+} // engine::render
\ No newline at end of file
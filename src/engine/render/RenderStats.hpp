@@ -0,0 +1,122 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace engine::render {
+	
+	/**
+	 * Per-frame render counters and phase times. The engine counts draws, triangles, uniform
+	 * uploads and buffer uploads where it issues them; program switches and texture binds are
+	 * counted in OpenGLBackend, so binds the StateCache skips don't show up. end_frame() closes the
+	 * frame and keeps it in a rolling window of WINDOW frames, from which percentiles are taken.
+	 * GL thread only; work done on other threads is handed over with add() or add_time().
+	 */
+	class RenderStats {
+	public:
+		enum Counter {
+			DRAW_CALLS,
+			TRIANGLES,
+			PROGRAM_SWITCHES,
+			TEXTURE_BINDS,
+			UNIFORM_UPLOADS,
+			BUFFER_BYTES,
+			OBJECTS_DRAWN,
+			OBJECTS_CULLED,
+			COUNTER_COUNT
+		};
+		
+		// Frames the percentiles and CSV cover
+		static constexpr size_t WINDOW = 600;
+		
+		struct Percentiles {
+			double p50;
+			double p95;
+			double p99;
+			double max;
+		};
+	
+	private:
+		struct Phase {
+			std::string name;
+			std::chrono::nanoseconds time;
+			// Milliseconds per frame, same ring positions as s_history
+			std::vector<float> history;
+		};
+		
+		static uint64_t s_counters[COUNTER_COUNT];
+		static std::vector<uint64_t> s_history[COUNTER_COUNT];
+		static std::vector<Phase> s_phases;
+		static uint64_t s_frames;
+	
+	public:
+		static void add(Counter counter, uint64_t value = 1) {
+			s_counters[counter] += value;
+		}
+		/**
+		 * Adds to a named phase of the current frame; phases are created on first use.
+		 */
+		static void add_time(const std::string& phase, std::chrono::nanoseconds time);
+		
+		/**
+		 * Closes the current frame, records it and starts counting the next one from zero.
+		 */
+		static void end_frame();
+		
+		/**
+		 * The value of the last finished frame.
+		 */
+		static uint64_t last(Counter counter);
+		static Percentiles percentiles(Counter counter);
+		/**
+		 * In milliseconds.
+		 */
+		static Percentiles percentiles(const std::string& phase);
+		/**
+		 * Nearest rank percentiles of any samples, e.g. frame times recorded outside the window.
+		 */
+		static Percentiles percentiles(std::vector<double> values);
+		static size_t frames();
+		
+		static const char* name(Counter counter);
+		/**
+		 * Multi-line p50/p95/p99 summary of every counter and phase.
+		 */
+		static std::string report();
+		/**
+		 * Writes one row per recorded frame, oldest first, with a column per counter and phase.
+		 * @return false if the file couldn't be written
+		 */
+		static bool write_csv(const std::string& path);
+		
+		/**
+		 * Forgets all recorded frames and phases.
+		 */
+		static void reset();
+		
+		/**
+		 * Times the enclosing block into a phase.
+		 */
+		class Timer {
+		private:
+			const char* m_phase;
+			std::chrono::steady_clock::time_point m_start;
+		
+		public:
+			explicit Timer(const char* phase);
+			
+			Timer(const Timer& other) = delete;
+			Timer(Timer&& other) noexcept = delete;
+			Timer& operator=(const Timer& other) = delete;
+			Timer& operator=(Timer&& other) noexcept = delete;
+			~Timer();
+		};
+	
+	private:
+		static size_t samples();
+	};
+	
+} // engine::render
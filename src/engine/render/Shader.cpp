@@ -7,6 +7,14 @@
 
 #include "GL/glew.h"
 
+#include "GLBackend.hpp"
+#include "RenderStats.hpp"
+#include "../profile/Profiler.hpp"
+#include "../profile/MemoryTracker.hpp"
+
+#include "ProgramCache.hpp"
+#include "CameraUniforms.hpp"
+
 static std::string read_file(const std::string& path) {
 	std::string content;
 	std::ifstream file(path);
@@ -23,61 +31,65 @@ static std::string read_file(const std::string& path) {
 	return content;
 }
 
+static std::string inject_defines(const std::string& source, const std::vector<std::string>& defines) {
+	if (defines.empty()) {
+		return source;
+	}
+	std::string block;
+	for (const std::string& define : defines) {
+		block += "#define " + define + "\n";
+	}
+	// #version has to stay the first statement
+	size_t position = 0;
+	if (source.compare(0, 8, "#version") == 0) {
+		position = source.find('\n');
+		position = position == std::string::npos ? source.size() : position + 1;
+	}
+	return source.substr(0, position) + block + source.substr(position);
+}
+
 namespace engine {
+	// Programs have no size to query; the driver binary is the closest measure where it can be read back
+	static void track_program(unsigned int id, const std::string& label) {
+		GLint length = 0;
+		if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+			glGetProgramiv(id, GL_PROGRAM_BINARY_LENGTH, &length);
+		}
+		profile::MemoryTracker::track(profile::MemoryTracker::PROGRAM, id, length, label);
+	}
+	
 	std::vector<Shader> Shader::s_shaders;
-	Shader::Shader() : m_id(0) {
+	Shader::Shader() : m_id(0), m_failed(false), m_memory(profile::MemoryTracker::SHADERS, sizeof(Shader)) {
 	}
-	Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
-		std::string vertexSource = read_file(vertexPath);
-		std::string fragmentSource = read_file(fragmentPath);
-		
-		// Compile shaders
-		unsigned int vertexId, fragmentId;
+	Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath,
+		const std::vector<std::string>& defines)
+		: m_id(0), m_failed(false), m_memory(profile::MemoryTracker::SHADERS, sizeof(Shader)) {
+		PROFILE_SCOPE("Shader::load");
+		std::string vertexSource = load_source(vertexPath, defines);
+		std::string fragmentSource = load_source(fragmentPath, defines);
 		
-		// Vertex shader_col_3d
-		{
-			const char* vertexSourceCStr = vertexSource.c_str();
-			vertexId = glCreateShader(GL_VERTEX_SHADER);
-			glShaderSource(vertexId, 1, &vertexSourceCStr, nullptr);
-			glCompileShader(vertexId);
-			
-			int success;
-			char infoLog[512];
-			glGetShaderiv(vertexId, GL_COMPILE_STATUS, &success);
-			if (!success) {
-				glGetShaderInfoLog(vertexId, 512, nullptr, infoLog);
-				std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-			}
-		}
-		// Fragment shader_col_3d
-		{
-			const char* fragmentSourceCStr = fragmentSource.c_str();
-			fragmentId = glCreateShader(GL_FRAGMENT_SHADER);
-			glShaderSource(fragmentId, 1, &fragmentSourceCStr, nullptr);
-			glCompileShader(fragmentId);
-			
-			int success;
-			char infoLog[512];
-			glGetShaderiv(fragmentId, GL_COMPILE_STATUS, &success);
-			if (!success) {
-				glGetShaderInfoLog(fragmentId, 512, nullptr, infoLog);
-				std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-			}
+		// Reuse the driver binary from a previous run if there is one
+		m_id = glCreateProgram();
+		uint64_t cacheKey = render::ProgramCache::key(vertexSource, fragmentSource);
+		if (render::ProgramCache::load(cacheKey, m_id)) {
+			render::CameraUniforms::bind_block(m_id);
+			track_program(m_id, vertexPath + " + " + fragmentPath);
+			s_shaders.push_back(*this);
+			return;
 		}
 		
-		// Link shaders
-		m_id = glCreateProgram();
-		glAttachShader(m_id, vertexId);
-		glAttachShader(m_id, fragmentId);
-		glLinkProgram(m_id);
+		// Compile shaders
+		unsigned int vertexId = compile_stage(GL_VERTEX_SHADER, vertexSource);
+		unsigned int fragmentId = compile_stage(GL_FRAGMENT_SHADER, fragmentSource);
+		check_compile(vertexId, "VERTEX");
+		check_compile(fragmentId, "FRAGMENT");
 		
-		// Check program
-		int success;
-		char infoLog[512];
-		glGetProgramiv(m_id, GL_LINK_STATUS, &success);
-		if (!success) {
-			glGetProgramInfoLog(m_id, 512, nullptr, infoLog);
-			std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+		// Link shaders
+		link_program(m_id, vertexId, fragmentId);
+		if (check_link(m_id)) {
+			render::ProgramCache::store(cacheKey, m_id);
+			render::CameraUniforms::bind_block(m_id);
+			track_program(m_id, vertexPath + " + " + fragmentPath);
 		}
 		
 		// Delete shaders
@@ -86,24 +98,49 @@ namespace engine {
 		
 		s_shaders.push_back(*this);
 	}
+	Shader Shader::fromProgram(unsigned int id, const std::string& label) {
+		Shader shader;
+		shader.m_id = id;
+		render::CameraUniforms::bind_block(id);
+		track_program(id, label);
+		s_shaders.push_back(shader);
+		return shader;
+	}
+	
+	bool Shader::ready() const {
+		return m_id != 0;
+	}
+	bool Shader::failed() const {
+		return m_failed;
+	}
+	unsigned int Shader::id() const {
+		return m_id;
+	}
+	
 	void Shader::use() const {
-		glUseProgram(m_id);
+		PROFILE_SCOPE("Shader::use");
+		render::GLBackend::current().use_program(m_id);
 	}
 	void Shader::release() const {
-		glUseProgram(0);
+		render::GLBackend::current().use_program(0);
 	}
 	void Shader::destroy() const {
 		std::cout << "Destroying shader_col_3d " << m_id << std::endl;
-		glDeleteProgram(m_id);
+		render::GLBackend::current().delete_program(m_id);
+		profile::MemoryTracker::untrack(profile::MemoryTracker::PROGRAM, m_id);
 		erase_if(s_shaders, [this](const Shader& shader) {
 			return shader.m_id == m_id;
 		});
 	}
 	
 	void Shader::set_bool(const std::string& name, bool value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniform1i(getUniformLocation(name), (int) value);
 	}
 	void Shader::set_bool(const std::string& name, const std::vector<bool>& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		std::vector<int> intValues(value.size());
 		for (size_t i = 0; i < value.size(); i++) {
 			intValues[i] = (int) value[i];
@@ -111,41 +148,77 @@ namespace engine {
 		glUniform1iv(getUniformLocation(name), intValues.size(), intValues.data());
 	}
 	void Shader::set_int(const std::string& name, int value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniform1i(getUniformLocation(name), value);
 	}
 	void Shader::set_int(const std::string& name, const std::vector<int>& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniform1iv(getUniformLocation(name), value.size(), value.data());
 	}
 	void Shader::set_uint(const std::string& name, unsigned int value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniform1ui(getUniformLocation(name), value);
 	}
 	void Shader::set_uint(const std::string& name, const std::vector<unsigned int>& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniform1uiv(getUniformLocation(name), value.size(), value.data());
 	}
 	void Shader::set_float(const std::string& name, float value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniform1f(getUniformLocation(name), value);
 	}
 	void Shader::set_float(const std::string& name, const std::vector<float>& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniform1fv(getUniformLocation(name), value.size(), value.data());
 	}
 	
 	void Shader::set_vec2(const std::string& name, const math::Vec2& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniform2f(getUniformLocation(name), value.x(), value.y());
 	}
 	void Shader::set_vec3(const std::string& name, const math::Vec3& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniform3f(getUniformLocation(name), value.x(), value.y(), value.z());
 	}
 	void Shader::set_vec4(const std::string& name, const math::Vec4& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniform4f(getUniformLocation(name), value.x(), value.y(), value.z(), value.w());
 	}
+	void Shader::set_vec4(const std::string& name, const std::vector<math::Vec4>& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
+		std::vector<float> floatValues(value.size() * 4);
+		for (size_t i = 0; i < value.size(); i++) {
+			floatValues[i * 4 + 0] = value[i].x();
+			floatValues[i * 4 + 1] = value[i].y();
+			floatValues[i * 4 + 2] = value[i].z();
+			floatValues[i * 4 + 3] = value[i].w();
+		}
+		glUniform4fv(getUniformLocation(name), value.size(), floatValues.data());
+	}
 	
 	void Shader::set_mat2(const std::string& name, const math::Mat2& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniformMatrix2fv(getUniformLocation(name), 1, GL_TRUE, value.data());
 	}
 	void Shader::set_mat3(const std::string& name, const math::Mat3& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniformMatrix3fv(getUniformLocation(name), 1, GL_TRUE, value.data());
 	}
 	void Shader::set_mat4(const std::string& name, const math::Mat4& value) const {
+		PROFILE_SCOPE("Shader::set_uniform");
+		render::RenderStats::add(render::RenderStats::UNIFORM_UPLOADS);
 		glUniformMatrix4fv(getUniformLocation(name), 1, GL_TRUE, value.data());
 	}
 	int Shader::getUniformLocation(const std::string& name) const {
@@ -156,4 +229,43 @@ namespace engine {
 			s_shaders.back().destroy();
 		}
 	}
+	
+	std::string Shader::load_source(const std::string& path, const std::vector<std::string>& defines) {
+		return inject_defines(read_file(path), defines);
+	}
+	unsigned int Shader::compile_stage(unsigned int type, const std::string& source) {
+		const char* sourceCStr = source.c_str();
+		unsigned int id = glCreateShader(type);
+		glShaderSource(id, 1, &sourceCStr, nullptr);
+		glCompileShader(id);
+		return id;
+	}
+	void Shader::link_program(unsigned int program, unsigned int vertexId, unsigned int fragmentId) {
+		glAttachShader(program, vertexId);
+		glAttachShader(program, fragmentId);
+		if (render::ProgramCache::enabled()) {
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+		glLinkProgram(program);
+	}
+	bool Shader::check_compile(unsigned int id, const char* stage) {
+		int success;
+		char infoLog[512];
+		glGetShaderiv(id, GL_COMPILE_STATUS, &success);
+		if (!success) {
+			glGetShaderInfoLog(id, 512, nullptr, infoLog);
+			std::cerr << "ERROR::SHADER::" << stage << "::COMPILATION_FAILED\n" << infoLog << std::endl;
+		}
+		return success;
+	}
+	bool Shader::check_link(unsigned int program) {
+		int success;
+		char infoLog[512];
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		if (!success) {
+			glGetProgramInfoLog(program, 512, nullptr, infoLog);
+			std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+		}
+		return success;
+	}
 } // engine
\ No newline at end of file
@@ -9,16 +9,28 @@
 #include "../math/Vec2.hpp"
 #include "../math/Vec3.hpp"
 #include "../math/Vec4.hpp"
+#include "../profile/MemoryTracker.hpp"
+
+namespace engine::render {
+	class ShaderBatch;
+}
 
 namespace engine {
 	
 	class Shader {
 	private:
 		unsigned int m_id;
+		// Set by ShaderBatch when the program doesn't link
+		bool m_failed;
+		profile::MemoryTracker::Allocation m_memory;
 	
 	public:
 		Shader();
-		Shader(const std::string& vertexPath, const std::string& fragmentPath);
+		/**
+		 * @param defines preprocessor definitions ("NAME" or "NAME VALUE") inserted after the #version line of both stages
+		 */
+		Shader(const std::string& vertexPath, const std::string& fragmentPath,
+			const std::vector<std::string>& defines = {});
 		
 		Shader(const Shader&) = default;
 		Shader(Shader&&) = default;
@@ -26,6 +38,22 @@ namespace engine {
 		Shader& operator=(Shader&&) = default;
 		~Shader() = default;
 		
+		/**
+		 * Wraps an already linked program and registers it for destroyAll().
+		 * @param label shown in memory reports
+		 */
+		static Shader fromProgram(unsigned int id, const std::string& label = "");
+		
+		/**
+		 * False while the program is still being built by a ShaderBatch.
+		 */
+		bool ready() const;
+		/**
+		 * True if a ShaderBatch failed to build the program, it then never becomes ready().
+		 */
+		bool failed() const;
+		unsigned int id() const;
+		
 		void use() const;
 		void release() const;
 		
@@ -43,6 +71,7 @@ namespace engine {
 		void set_vec2(const std::string& name, const math::Vec2& value) const;
 		void set_vec3(const std::string& name, const math::Vec3& value) const;
 		void set_vec4(const std::string& name, const math::Vec4& value) const;
+		void set_vec4(const std::string& name, const std::vector<math::Vec4>& value) const;
 		
 		void set_mat2(const std::string& name, const math::Mat2& value) const;
 		void set_mat3(const std::string& name, const math::Mat3& value) const;
@@ -51,6 +80,14 @@ namespace engine {
 	private:
 		int getUniformLocation(const std::string& name) const;
 		
+		// Build steps shared with ShaderBatch; compiling and linking never wait for the driver, the checks do
+		friend class render::ShaderBatch;
+		static std::string load_source(const std::string& path, const std::vector<std::string>& defines);
+		static unsigned int compile_stage(unsigned int type, const std::string& source);
+		static void link_program(unsigned int program, unsigned int vertexId, unsigned int fragmentId);
+		static bool check_compile(unsigned int id, const char* stage);
+		static bool check_link(unsigned int program);
+		
 		static std::vector<Shader> s_shaders;
 	public:
 		static void destroyAll();
@@ -0,0 +1,119 @@
+#include "ShaderBatch.hpp"
+
+#include <iostream>
+
+#include "GL/glew.h"
+
+#include "GLBackend.hpp"
+
+#include "ProgramCache.hpp"
+
+namespace engine::render {
+	ShaderBatch::ShaderBatch()
+		: m_builds(), m_pending(0) {
+	}
+	
+	void ShaderBatch::add(Shader& target, const std::string& vertexPath, const std::string& fragmentPath,
+		const std::vector<std::string>& defines) {
+		target = Shader();
+		m_builds.push_back({&target, vertexPath, fragmentPath, defines, 0, 0, 0, 0, false, false});
+		m_pending++;
+	}
+	
+	void ShaderBatch::submit() {
+		if (parallel()) {
+			// Let the driver pick how many compiler threads to use
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+		}
+		
+		// Issue every compile before any link so no link has to wait on a stage queued after it
+		for (Build& build : m_builds) {
+			if (build.submitted) {
+				continue;
+			}
+			std::string vertexSource = Shader::load_source(build.vertex_path, build.defines);
+			std::string fragmentSource = Shader::load_source(build.fragment_path, build.defines);
+			
+			build.program = glCreateProgram();
+			build.cache_key = ProgramCache::key(vertexSource, fragmentSource);
+			if (ProgramCache::load(build.cache_key, build.program)) {
+				build.submitted = true;
+				continue;
+			}
+			build.vertex_id = Shader::compile_stage(GL_VERTEX_SHADER, vertexSource);
+			build.fragment_id = Shader::compile_stage(GL_FRAGMENT_SHADER, fragmentSource);
+		}
+		for (Build& build : m_builds) {
+			if (build.submitted) {
+				continue;
+			}
+			Shader::link_program(build.program, build.vertex_id, build.fragment_id);
+			build.submitted = true;
+		}
+	}
+	
+	bool ShaderBatch::poll() {
+		bool canQuery = parallel();
+		for (Build& build : m_builds) {
+			if (!build.submitted || build.done) {
+				continue;
+			}
+			if (canQuery && build.vertex_id != 0) {
+				int completed;
+				glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &completed);
+				if (!completed) {
+					continue;
+				}
+			}
+			finish(build);
+		}
+		return done();
+	}
+	void ShaderBatch::wait() {
+		submit();
+		for (Build& build : m_builds) {
+			if (!build.done) {
+				finish(build);
+			}
+		}
+	}
+	
+	size_t ShaderBatch::pending() const {
+		return m_pending;
+	}
+	bool ShaderBatch::done() const {
+		return m_pending == 0;
+	}
+	
+	bool ShaderBatch::parallel() {
+		return GLEW_KHR_parallel_shader_compile;
+	}
+	
+	void ShaderBatch::finish(Build& build) {
+		bool linked = true;
+		// Programs loaded from the cache have no stages and were already checked
+		if (build.vertex_id != 0) {
+			linked = Shader::check_link(build.program);
+			if (!linked) {
+				Shader::check_compile(build.vertex_id, "VERTEX");
+				Shader::check_compile(build.fragment_id, "FRAGMENT");
+				std::cerr << "Failed to build " << build.vertex_path << " + " << build.fragment_path << std::endl;
+			}
+			else {
+				ProgramCache::store(build.cache_key, build.program);
+			}
+			glDeleteShader(build.vertex_id);
+			glDeleteShader(build.fragment_id);
+		}
+		
+		if (linked) {
+			*build.target = Shader::fromProgram(build.program, build.vertex_path + " + " + build.fragment_path);
+		}
+		else {
+			GLBackend::current().delete_program(build.program);
+			build.target->m_failed = true;
+		}
+		build.done = true;
+		m_pending--;
+	}
+} // engine::render
\ No newline at end of file
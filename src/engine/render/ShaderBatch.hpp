@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Shader.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * Builds many programs at once. submit() issues every compile and link without querying their
+	 * status, so the driver can work on them concurrently (on its own threads with
+	 * GL_KHR_parallel_shader_compile). poll() then hands out the programs that have finished.
+	 * Each target Shader stays not ready() until its program is done, and must outlive the batch.
+	 * Targets whose program fails to build are marked failed() instead.
+	 */
+	class ShaderBatch {
+	private:
+		struct Build {
+			Shader* target;
+			std::string vertex_path;
+			std::string fragment_path;
+			std::vector<std::string> defines;
+			uint64_t cache_key;
+			unsigned int program;
+			unsigned int vertex_id;
+			unsigned int fragment_id;
+			bool submitted;
+			bool done;
+		};
+		
+		std::vector<Build> m_builds;
+		size_t m_pending;
+	
+	public:
+		ShaderBatch();
+		
+		ShaderBatch(const ShaderBatch& other) = delete;
+		ShaderBatch(ShaderBatch&& other) noexcept = default;
+		ShaderBatch& operator=(const ShaderBatch& other) = delete;
+		ShaderBatch& operator=(ShaderBatch&& other) noexcept = default;
+		~ShaderBatch() = default;
+		
+		void add(Shader& target, const std::string& vertexPath, const std::string& fragmentPath,
+			const std::vector<std::string>& defines = {});
+		/**
+		 * Starts building everything added since the last submit.
+		 */
+		void submit();
+		/**
+		 * Finishes the programs the driver is done with, without blocking.
+		 * Without GL_KHR_parallel_shader_compile the status can't be queried without waiting, so
+		 * everything is finished on the first poll.
+		 * @return true once every program is ready
+		 */
+		bool poll();
+		/**
+		 * Blocks until every program is ready.
+		 */
+		void wait();
+		
+		size_t pending() const;
+		bool done() const;
+		
+		static bool parallel();
+	
+	private:
+		void finish(Build& build);
+	};
+	
+} // engine::render
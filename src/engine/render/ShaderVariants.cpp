@@ -0,0 +1,56 @@
+#include "ShaderVariants.hpp"
+
+#include <iostream>
+
+#include "../util/Hash.hpp"
+
+namespace engine::render {
+	ShaderVariants::ShaderVariants()
+		: m_vertex_path(), m_fragment_path(), m_variants() {
+	}
+	ShaderVariants::ShaderVariants(const std::string& vertexPath, const std::string& fragmentPath)
+		: m_vertex_path(vertexPath), m_fragment_path(fragmentPath), m_variants() {
+	}
+	
+	const Shader& ShaderVariants::get(const std::vector<std::string>& defines) {
+		uint64_t variant = key(defines);
+		auto it = m_variants.find(variant);
+		if (it != m_variants.end()) {
+			return it->second;
+		}
+		std::cout << "Compiling shader variant " << std::hex << variant << std::dec << " of " << m_fragment_path
+			<< std::endl;
+		return m_variants.emplace(variant, Shader(m_vertex_path, m_fragment_path, defines)).first->second;
+	}
+	void ShaderVariants::prepare(const std::vector<std::string>& defines, ShaderBatch& batch) {
+		uint64_t variant = key(defines);
+		if (m_variants.contains(variant)) {
+			return;
+		}
+		// Map nodes never move, so the batch can fill the entry in later
+		batch.add(m_variants[variant], m_vertex_path, m_fragment_path, defines);
+	}
+	bool ShaderVariants::contains(const std::vector<std::string>& defines) const {
+		return m_variants.contains(key(defines));
+	}
+	size_t ShaderVariants::size() const {
+		return m_variants.size();
+	}
+	
+	const std::string& ShaderVariants::vertex_path() const {
+		return m_vertex_path;
+	}
+	const std::string& ShaderVariants::fragment_path() const {
+		return m_fragment_path;
+	}
+	
+	uint64_t ShaderVariants::key(const std::vector<std::string>& defines) {
+		uint64_t hash = util::FNV_OFFSET_BASIS;
+		for (const std::string& define : defines) {
+			// Separator so {"AB", "C"} and {"A", "BC"} differ
+			hash = util::fnv1a(define, hash);
+			hash = util::fnv1a("\n", hash);
+		}
+		return hash;
+	}
+} // engine::render
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Shader.hpp"
+#include "ShaderBatch.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * Compiles specialized permutations of one vertex/fragment pair on demand.
+	 * Each permutation is identified by its list of #defines and compiled only once.
+	 */
+	class ShaderVariants {
+	private:
+		std::string m_vertex_path;
+		std::string m_fragment_path;
+		std::unordered_map<uint64_t, Shader> m_variants;
+	
+	public:
+		ShaderVariants();
+		ShaderVariants(const std::string& vertexPath, const std::string& fragmentPath);
+		
+		ShaderVariants(const ShaderVariants& other) = default;
+		ShaderVariants(ShaderVariants&& other) noexcept = default;
+		ShaderVariants& operator=(const ShaderVariants& other) = default;
+		ShaderVariants& operator=(ShaderVariants&& other) noexcept = default;
+		~ShaderVariants() = default;
+		
+		/**
+		 * Returns the permutation for the defines, compiling it on first use.
+		 */
+		const Shader& get(const std::vector<std::string>& defines);
+		/**
+		 * Queues the permutation on a batch instead of compiling it right away.
+		 * get() returns it as not ready() until the batch has finished it.
+		 */
+		void prepare(const std::vector<std::string>& defines, ShaderBatch& batch);
+		bool contains(const std::vector<std::string>& defines) const;
+		size_t size() const;
+		
+		const std::string& vertex_path() const;
+		const std::string& fragment_path() const;
+		
+		static uint64_t key(const std::vector<std::string>& defines);
+	};
+	
+} // engine::render
@@ -0,0 +1,32 @@
+#include "SnapshotRing.hpp"
+
+namespace engine::render {
+	SnapshotRing::SnapshotRing()
+		: m_slots(), m_back(0), m_middle(1), m_front(2), m_has_front(false) {
+	}
+	
+	FrameSnapshot& SnapshotRing::back() {
+		return m_slots[m_back];
+	}
+	void SnapshotRing::publish() {
+		// Release makes the snapshot visible to the consumer that picks this slot up
+		uint8_t previous = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel);
+		m_back = previous & INDEX_MASK;
+	}
+	
+	bool SnapshotRing::acquire() {
+		if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) {
+			return false;
+		}
+		uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+		m_front = previous & INDEX_MASK;
+		m_has_front = true;
+		return true;
+	}
+	const FrameSnapshot& SnapshotRing::front() const {
+		return m_slots[m_front];
+	}
+	bool SnapshotRing::has_front() const {
+		return m_has_front;
+	}
+} // engine::render
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "FrameSnapshot.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * Lock-free triple buffer handing frame snapshots from one producer thread to one consumer.
+	 * The producer fills back() and publishes it; the consumer acquire()s the newest published
+	 * snapshot and reads front() until its next acquire(). The third slot sits in between, so
+	 * neither side ever waits and the consumer always gets the latest frame, skipping stale ones.
+	 * Slots are reused, so the vectors inside keep their capacity.
+	 */
+	class SnapshotRing {
+	private:
+		static constexpr uint8_t INDEX_MASK = 0x3;
+		// Set on the middle index when it holds a snapshot the consumer hasn't taken yet
+		static constexpr uint8_t FRESH = 0x4;
+		
+		FrameSnapshot m_slots[3];
+		uint8_t m_back;
+		std::atomic<uint8_t> m_middle;
+		uint8_t m_front;
+		bool m_has_front;
+	
+	public:
+		SnapshotRing();
+		
+		SnapshotRing(const SnapshotRing& other) = delete;
+		SnapshotRing(SnapshotRing&& other) noexcept = delete;
+		SnapshotRing& operator=(const SnapshotRing& other) = delete;
+		SnapshotRing& operator=(SnapshotRing&& other) noexcept = delete;
+		~SnapshotRing() = default;
+		
+		/**
+		 * Producer side: the slot to fill. It still holds an older snapshot.
+		 */
+		FrameSnapshot& back();
+		void publish();
+		
+		/**
+		 * Consumer side: takes the newest published snapshot, if there is one since the last call.
+		 * @return whether front() changed
+		 */
+		bool acquire();
+		/**
+		 * Only valid once acquire() succeeded.
+		 */
+		const FrameSnapshot& front() const;
+		bool has_front() const;
+	};
+	
+} // engine::render
@@ -0,0 +1,179 @@
+#include "StateCache.hpp"
+
+#include "GL/glew.h"
+
+namespace engine::render {
+	size_t StateCache::Skipped::total() const {
+		return program + vertex_array + buffer + active_texture + texture + capability + blend_func + depth_func
+			+ depth_mask;
+	}
+	
+	StateCache::StateCache(GLBackend& backend)
+		: m_backend(&backend), m_program(UNKNOWN), m_vertex_array(UNKNOWN), m_buffers(), m_active_unit(UNKNOWN),
+		m_textures(), m_capabilities(), m_blend_source(UNKNOWN), m_blend_destination(UNKNOWN), m_depth_func(UNKNOWN),
+		m_depth_mask(UNKNOWN), m_skipped() {
+	}
+	
+	unsigned int StateCache::create_texture() {
+		return m_backend->create_texture();
+	}
+	void StateCache::delete_texture(unsigned int id) {
+		m_backend->delete_texture(id);
+		// Deleted textures are unbound from every unit, and the name may be handed out again
+		for (auto& [key, texture] : m_textures) {
+			if (texture == id) {
+				texture = 0;
+			}
+		}
+	}
+	void StateCache::bind_texture(unsigned int target, unsigned int id) {
+		uint64_t key = (static_cast<uint64_t>(m_active_unit) << 32) | target;
+		auto it = m_textures.find(key);
+		if (m_active_unit != UNKNOWN && it != m_textures.end() && it->second == id) {
+			m_skipped.texture++;
+			return;
+		}
+		m_backend->bind_texture(target, id);
+		if (m_active_unit != UNKNOWN) {
+			m_textures[key] = id;
+		}
+	}
+	void StateCache::tex_image_2d(unsigned int target, int level, int width, int height, const void* data) {
+		m_backend->tex_image_2d(target, level, width, height, data);
+	}
+	void StateCache::tex_parameter(unsigned int target, unsigned int name, int value) {
+		m_backend->tex_parameter(target, name, value);
+	}
+	void StateCache::active_texture(unsigned int unit) {
+		if (unit == m_active_unit) {
+			m_skipped.active_texture++;
+			return;
+		}
+		m_backend->active_texture(unit);
+		m_active_unit = unit;
+	}
+	
+	void StateCache::use_program(unsigned int id) {
+		if (id == m_program) {
+			m_skipped.program++;
+			return;
+		}
+		m_backend->use_program(id);
+		m_program = id;
+	}
+	void StateCache::delete_program(unsigned int id) {
+		m_backend->delete_program(id);
+		// A program in use is only flagged for deletion, but its name must not match a new one
+		if (m_program == id) {
+			m_program = UNKNOWN;
+		}
+	}
+	void StateCache::bind_vertex_array(unsigned int id) {
+		if (id == m_vertex_array) {
+			m_skipped.vertex_array++;
+			return;
+		}
+		m_backend->bind_vertex_array(id);
+		m_vertex_array = id;
+	}
+	void StateCache::delete_vertex_array(unsigned int id) {
+		m_backend->delete_vertex_array(id);
+		if (m_vertex_array == id) {
+			m_vertex_array = 0;
+		}
+	}
+	void StateCache::bind_buffer(unsigned int target, unsigned int id) {
+		if (target != GL_ELEMENT_ARRAY_BUFFER) {
+			auto it = m_buffers.find(target);
+			if (it != m_buffers.end() && it->second == id) {
+				m_skipped.buffer++;
+				return;
+			}
+			m_buffers[target] = id;
+		}
+		m_backend->bind_buffer(target, id);
+	}
+	void StateCache::bind_buffer_base(unsigned int target, unsigned int index, unsigned int id) {
+		// Indexed bindings are not tracked, but they also replace the generic binding
+		m_backend->bind_buffer_base(target, index, id);
+		m_buffers[target] = id;
+	}
+	void StateCache::delete_buffer(unsigned int id) {
+		m_backend->delete_buffer(id);
+		for (auto& [target, buffer] : m_buffers) {
+			if (buffer == id) {
+				buffer = 0;
+			}
+		}
+	}
+	
+	void StateCache::enable(unsigned int capability) {
+		set_capability(capability, true);
+	}
+	void StateCache::disable(unsigned int capability) {
+		set_capability(capability, false);
+	}
+	void StateCache::blend_func(unsigned int source, unsigned int destination) {
+		if (source == m_blend_source && destination == m_blend_destination) {
+			m_skipped.blend_func++;
+			return;
+		}
+		m_backend->blend_func(source, destination);
+		m_blend_source = source;
+		m_blend_destination = destination;
+	}
+	void StateCache::depth_func(unsigned int func) {
+		if (func == m_depth_func) {
+			m_skipped.depth_func++;
+			return;
+		}
+		m_backend->depth_func(func);
+		m_depth_func = func;
+	}
+	void StateCache::depth_mask(bool write) {
+		if (static_cast<unsigned int>(write) == m_depth_mask) {
+			m_skipped.depth_mask++;
+			return;
+		}
+		m_backend->depth_mask(write);
+		m_depth_mask = write;
+	}
+	
+	void StateCache::invalidate() {
+		m_program = UNKNOWN;
+		m_vertex_array = UNKNOWN;
+		m_buffers.clear();
+		m_active_unit = UNKNOWN;
+		m_textures.clear();
+		m_capabilities.clear();
+		m_blend_source = UNKNOWN;
+		m_blend_destination = UNKNOWN;
+		m_depth_func = UNKNOWN;
+		m_depth_mask = UNKNOWN;
+	}
+	
+	GLBackend& StateCache::backend() const {
+		return *m_backend;
+	}
+	const StateCache::Skipped& StateCache::skipped() const {
+		return m_skipped;
+	}
+	void StateCache::reset_skipped() {
+		m_skipped = Skipped();
+	}
+	
+	void StateCache::set_capability(unsigned int capability, bool enabled) {
+		auto it = m_capabilities.find(capability);
+		if (it != m_capabilities.end() && it->second == static_cast<unsigned int>(enabled)) {
+			m_skipped.capability++;
+			return;
+		}
+		if (enabled) {
+			m_backend->enable(capability);
+		}
+		else {
+			m_backend->disable(capability);
+		}
+		m_capabilities[capability] = enabled;
+	}
+} // engine::render
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+#include "GLBackend.hpp"
+
+namespace engine::render {
+	
+	/**
+	 * GLBackend that remembers the bound program, vertex array, buffers, textures per unit and the
+	 * blend/depth state, and only forwards calls that change something. Skipped calls are counted.
+	 * State starts out unknown, so the first call of each kind is always forwarded.
+	 * GL_ELEMENT_ARRAY_BUFFER belongs to the bound vertex array and is never skipped.
+	 * Code that changes state behind the cache's back has to call invalidate().
+	 */
+	class StateCache : public GLBackend {
+	public:
+		struct Skipped {
+			size_t program = 0;
+			size_t vertex_array = 0;
+			size_t buffer = 0;
+			size_t active_texture = 0;
+			size_t texture = 0;
+			size_t capability = 0;
+			size_t blend_func = 0;
+			size_t depth_func = 0;
+			size_t depth_mask = 0;
+			
+			size_t total() const;
+		};
+	
+	private:
+		static constexpr unsigned int UNKNOWN = 0xFFFFFFFF;
+		
+		GLBackend* m_backend;
+		
+		unsigned int m_program;
+		unsigned int m_vertex_array;
+		std::unordered_map<unsigned int, unsigned int> m_buffers;
+		unsigned int m_active_unit;
+		// (unit << 32 | target) -> texture
+		std::unordered_map<uint64_t, unsigned int> m_textures;
+		// capability -> enabled (0/1)
+		std::unordered_map<unsigned int, unsigned int> m_capabilities;
+		unsigned int m_blend_source, m_blend_destination;
+		unsigned int m_depth_func;
+		unsigned int m_depth_mask;
+		
+		Skipped m_skipped;
+	
+	public:
+		explicit StateCache(GLBackend& backend);
+		
+		unsigned int create_texture() override;
+		void delete_texture(unsigned int id) override;
+		void bind_texture(unsigned int target, unsigned int id) override;
+		void tex_image_2d(unsigned int target, int level, int width, int height, const void* data) override;
+		void tex_parameter(unsigned int target, unsigned int name, int value) override;
+		void active_texture(unsigned int unit) override;
+		
+		void use_program(unsigned int id) override;
+		void delete_program(unsigned int id) override;
+		void bind_vertex_array(unsigned int id) override;
+		void delete_vertex_array(unsigned int id) override;
+		void bind_buffer(unsigned int target, unsigned int id) override;
+		void bind_buffer_base(unsigned int target, unsigned int index, unsigned int id) override;
+		void delete_buffer(unsigned int id) override;
+		
+		void enable(unsigned int capability) override;
+		void disable(unsigned int capability) override;
+		void blend_func(unsigned int source, unsigned int destination) override;
+		void depth_func(unsigned int func) override;
+		void depth_mask(bool write) override;
+		
+		/**
+		 * Forgets all state, the next call of each kind is forwarded again.
+		 */
+		void invalidate();
+		
+		GLBackend& backend() const;
+		const Skipped& skipped() const;
+		void reset_skipped();
+	
+	private:
+		void set_capability(unsigned int capability, bool enabled);
+	};
+	
+} // engine::render
@@ -0,0 +1,419 @@
+#include "DynamicBVH.hpp"
+
+#include <algorithm>
+
+namespace engine::scene {
+	bool DynamicBVH::Node::leaf() const {
+		return left == NONE;
+	}
+	
+	DynamicBVH::DynamicBVH()
+		: DynamicBVH(0.1f) {
+	}
+	DynamicBVH::DynamicBVH(float margin)
+		: m_nodes(), m_root(NONE), m_free(NONE), m_leaf_count(0), m_margin(margin), m_moved(), m_pass(0) {
+	}
+	
+	int DynamicBVH::insert(const math::AABB& box, uint32_t value) {
+		int leaf = allocate();
+		Node& node = m_nodes[leaf];
+		node.box = box.grow(m_margin);
+		node.value = value;
+		node.height = 0;
+		insert_leaf(leaf, true);
+		m_leaf_count++;
+		return leaf;
+	}
+	void DynamicBVH::remove(int proxy) {
+		remove_leaf(proxy);
+		release(proxy);
+		m_leaf_count--;
+	}
+	bool DynamicBVH::move(int proxy, const math::AABB& box, const math::Vec3& displacement) {
+		if (m_nodes[proxy].box.contains(box)) {
+			return false;
+		}
+		// Growing the fat box in place would loosen every ancestor for good; the best spot for the
+		// new box is found again instead
+		remove_leaf(proxy);
+		m_nodes[proxy].box = fatten(box, displacement);
+		insert_leaf(proxy, false);
+		m_moved.push_back(proxy);
+		return true;
+	}
+	void DynamicBVH::rebalance() {
+		m_pass++;
+		for (int leaf : m_moved) {
+			// Leaves removed since they moved have a negative height, reused nodes are harmless
+			if (m_nodes[leaf].height < 0) {
+				continue;
+			}
+			int index = m_nodes[leaf].parent;
+			while (index != NONE) {
+				int height = m_nodes[index].height;
+				bool visited = m_nodes[index].pass == m_pass;
+				if (!visited) {
+					m_nodes[index].pass = m_pass;
+					rotate(index);
+				}
+				Node& node = m_nodes[index];
+				node.height = 1 + std::max(m_nodes[node.left].height, m_nodes[node.right].height);
+				// The rest of the path was already walked by an earlier leaf
+				if (visited && node.height == height) {
+					break;
+				}
+				index = node.parent;
+			}
+		}
+		m_moved.clear();
+	}
+	void DynamicBVH::clear() {
+		m_nodes.clear();
+		m_root = NONE;
+		m_free = NONE;
+		m_leaf_count = 0;
+		m_moved.clear();
+	}
+	
+	const math::AABB& DynamicBVH::fat_box(int proxy) const {
+		return m_nodes[proxy].box;
+	}
+	uint32_t DynamicBVH::value(int proxy) const {
+		return m_nodes[proxy].value;
+	}
+	
+	void DynamicBVH::query(const math::Frustum& frustum, std::vector<uint32_t>& values) const {
+		if (m_root == NONE) {
+			return;
+		}
+		std::vector<int> stack;
+		stack.reserve(64);
+		stack.push_back(m_root);
+		while (!stack.empty()) {
+			int index = stack.back();
+			stack.pop_back();
+			const Node& node = m_nodes[index];
+			
+			math::Frustum::Containment containment = frustum.classify(node.box);
+			if (containment == math::Frustum::OUTSIDE) {
+				continue;
+			}
+			if (node.leaf()) {
+				values.push_back(node.value);
+			}
+			else if (containment == math::Frustum::INSIDE) {
+				collect(index, values, stack);
+			}
+			else {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+	void DynamicBVH::query(const math::AABB& box, std::vector<uint32_t>& values) const {
+		if (m_root == NONE) {
+			return;
+		}
+		std::vector<int> stack;
+		stack.reserve(64);
+		stack.push_back(m_root);
+		while (!stack.empty()) {
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+			if (!node.box.intersects(box)) {
+				continue;
+			}
+			if (node.leaf()) {
+				values.push_back(node.value);
+			}
+			else {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+	void DynamicBVH::query(const math::Sphere& sphere, std::vector<uint32_t>& values) const {
+		if (m_root == NONE) {
+			return;
+		}
+		std::vector<int> stack;
+		stack.reserve(64);
+		stack.push_back(m_root);
+		while (!stack.empty()) {
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+			if (!sphere.intersects(node.box)) {
+				continue;
+			}
+			if (node.leaf()) {
+				values.push_back(node.value);
+			}
+			else {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+	void DynamicBVH::raycast(const math::Ray& ray, float maxDistance, std::vector<Hit>& hits) const {
+		if (m_root == NONE) {
+			return;
+		}
+		size_t first = hits.size();
+		std::vector<int> stack;
+		stack.reserve(64);
+		stack.push_back(m_root);
+		while (!stack.empty()) {
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+			float distance;
+			if (!ray.intersects(node.box, maxDistance, distance)) {
+				continue;
+			}
+			if (node.leaf()) {
+				hits.push_back({node.value, distance});
+			}
+			else {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+		std::sort(hits.begin() + first, hits.end(), [](const Hit& a, const Hit& b) {
+			return a.distance < b.distance;
+		});
+	}
+	
+	size_t DynamicBVH::size() const {
+		return m_leaf_count;
+	}
+	int DynamicBVH::height() const {
+		return m_root == NONE ? 0 : m_nodes[m_root].height;
+	}
+	float DynamicBVH::cost() const {
+		if (m_root == NONE) {
+			return 0;
+		}
+		float rootArea = m_nodes[m_root].box.surface_area();
+		if (rootArea <= 0) {
+			return 0;
+		}
+		float total = 0;
+		for (const Node& node : m_nodes) {
+			if (node.height > 0) {
+				total += node.box.surface_area();
+			}
+		}
+		return total / rootArea;
+	}
+	
+	int DynamicBVH::allocate() {
+		if (m_free == NONE) {
+			m_nodes.push_back({math::AABB(), 0, NONE, NONE, NONE, 0, 0});
+			return static_cast<int>(m_nodes.size() - 1);
+		}
+		int index = m_free;
+		m_free = m_nodes[index].parent;
+		m_nodes[index] = {math::AABB(), 0, NONE, NONE, NONE, 0, 0};
+		return index;
+	}
+	void DynamicBVH::release(int index) {
+		// A negative height keeps freed nodes out of cost()
+		m_nodes[index].parent = m_free;
+		m_nodes[index].height = -1;
+		m_free = index;
+	}
+	
+	void DynamicBVH::insert_leaf(int leaf, bool rebalance) {
+		if (m_root == NONE) {
+			m_root = leaf;
+			m_nodes[leaf].parent = NONE;
+			return;
+		}
+		
+		int sibling = find_sibling(m_nodes[leaf].box);
+		int oldParent = m_nodes[sibling].parent;
+		int newParent = allocate();
+		Node& parent = m_nodes[newParent];
+		parent.parent = oldParent;
+		parent.left = sibling;
+		parent.right = leaf;
+		if (oldParent != NONE) {
+			replace_child(oldParent, sibling, newParent);
+		}
+		else {
+			m_root = newParent;
+		}
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+		
+		refit_upwards(newParent, rebalance);
+	}
+	void DynamicBVH::remove_leaf(int leaf) {
+		if (leaf == m_root) {
+			m_root = NONE;
+			return;
+		}
+		
+		int parent = m_nodes[leaf].parent;
+		int grandParent = m_nodes[parent].parent;
+		int sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+		if (grandParent != NONE) {
+			replace_child(grandParent, parent, sibling);
+			release(parent);
+			// Only shrinks boxes, rotations are left to the insertion or rebalance() that follows
+			refit_upwards(grandParent, false);
+		}
+		else {
+			m_root = sibling;
+			m_nodes[sibling].parent = NONE;
+			release(parent);
+		}
+	}
+	math::AABB DynamicBVH::fatten(const math::AABB& box, const math::Vec3& displacement) const {
+		math::AABB fat = box.grow(m_margin);
+		math::Vec3 ahead = displacement * DISPLACEMENT_MULTIPLIER;
+		return fat.merge(math::AABB(fat.min() + ahead, fat.max() + ahead));
+	}
+	int DynamicBVH::find_sibling(const math::AABB& box) const {
+		// Descend towards the child that grows the least, stopping where pairing with the node
+		// itself is cheaper; the inherited cost is the growth of every ancestor on the way down
+		int index = m_root;
+		while (!m_nodes[index].leaf()) {
+			const Node& node = m_nodes[index];
+			float area = node.box.surface_area();
+			float combinedArea = node.box.merge(box).surface_area();
+			float cost = 2 * combinedArea;
+			float inheritance = 2 * (combinedArea - area);
+			
+			float childCost[2];
+			int children[2] = {node.left, node.right};
+			for (int i = 0; i < 2; i++) {
+				const Node& child = m_nodes[children[i]];
+				float merged = child.box.merge(box).surface_area();
+				childCost[i] = (child.leaf() ? merged : merged - child.box.surface_area()) + inheritance;
+			}
+			
+			if (cost < childCost[0] && cost < childCost[1]) {
+				break;
+			}
+			index = childCost[0] < childCost[1] ? node.left : node.right;
+		}
+		return index;
+	}
+	void DynamicBVH::refit_upwards(int index, bool rebalance) {
+		while (index != NONE) {
+			Node& node = m_nodes[index];
+			const Node& left = m_nodes[node.left];
+			const Node& right = m_nodes[node.right];
+			node.box = left.box.merge(right.box);
+			node.height = 1 + std::max(left.height, right.height);
+			if (rebalance) {
+				rotate(index);
+			}
+			index = m_nodes[index].parent;
+		}
+	}
+	void DynamicBVH::rotate(int index) {
+		// Swapping a child with a grandchild on the other side keeps this node's box but can
+		// shrink the child it moves into; pick the swap that shrinks it the most
+		enum Rotation {
+			KEEP, LEFT_WITH_RIGHT_LEFT, LEFT_WITH_RIGHT_RIGHT, RIGHT_WITH_LEFT_LEFT, RIGHT_WITH_LEFT_RIGHT
+		};
+		const Node& node = m_nodes[index];
+		if (node.height < 2) {
+			return;
+		}
+		int b = node.left;
+		int c = node.right;
+		const Node& nodeB = m_nodes[b];
+		const Node& nodeC = m_nodes[c];
+		
+		Rotation best = KEEP;
+		float bestGain = 0;
+		if (!nodeC.leaf()) {
+			float area = nodeC.box.surface_area();
+			float gain = area - nodeB.box.merge(m_nodes[nodeC.right].box).surface_area();
+			if (gain > bestGain) {
+				bestGain = gain;
+				best = LEFT_WITH_RIGHT_LEFT;
+			}
+			gain = area - nodeB.box.merge(m_nodes[nodeC.left].box).surface_area();
+			if (gain > bestGain) {
+				bestGain = gain;
+				best = LEFT_WITH_RIGHT_RIGHT;
+			}
+		}
+		if (!nodeB.leaf()) {
+			float area = nodeB.box.surface_area();
+			float gain = area - nodeC.box.merge(m_nodes[nodeB.right].box).surface_area();
+			if (gain > bestGain) {
+				bestGain = gain;
+				best = RIGHT_WITH_LEFT_LEFT;
+			}
+			gain = area - nodeC.box.merge(m_nodes[nodeB.left].box).surface_area();
+			if (gain > bestGain) {
+				bestGain = gain;
+				best = RIGHT_WITH_LEFT_RIGHT;
+			}
+		}
+		
+		int child, other, grandChild;
+		switch (best) {
+			case LEFT_WITH_RIGHT_LEFT:
+				child = b;
+				other = c;
+				grandChild = nodeC.left;
+				break;
+			case LEFT_WITH_RIGHT_RIGHT:
+				child = b;
+				other = c;
+				grandChild = nodeC.right;
+				break;
+			case RIGHT_WITH_LEFT_LEFT:
+				child = c;
+				other = b;
+				grandChild = nodeB.left;
+				break;
+			case RIGHT_WITH_LEFT_RIGHT:
+				child = c;
+				other = b;
+				grandChild = nodeB.right;
+				break;
+			default:
+				return;
+		}
+		replace_child(index, child, grandChild);
+		replace_child(other, grandChild, child);
+		
+		Node& otherNode = m_nodes[other];
+		otherNode.box = m_nodes[otherNode.left].box.merge(m_nodes[otherNode.right].box);
+		otherNode.height = 1 + std::max(m_nodes[otherNode.left].height, m_nodes[otherNode.right].height);
+		Node& rotated = m_nodes[index];
+		rotated.height = 1 + std::max(m_nodes[rotated.left].height, m_nodes[rotated.right].height);
+	}
+	void DynamicBVH::replace_child(int parent, int child, int replacement) {
+		Node& node = m_nodes[parent];
+		if (node.left == child) {
+			node.left = replacement;
+		}
+		else {
+			node.right = replacement;
+		}
+		m_nodes[replacement].parent = parent;
+	}
+	void DynamicBVH::collect(int index, std::vector<uint32_t>& values, std::vector<int>& stack) const {
+		// Uses the top of the caller's stack, which is back to where it was on return
+		size_t base = stack.size();
+		stack.push_back(index);
+		while (stack.size() > base) {
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+			if (node.leaf()) {
+				values.push_back(node.value);
+			}
+			else {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+} // engine::scene
\ No newline at end of file
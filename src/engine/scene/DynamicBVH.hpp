@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "../math/AABB.hpp"
+#include "../math/Sphere.hpp"
+#include "../math/Frustum.hpp"
+#include "../math/Ray.hpp"
+#include "Hit.hpp"
+
+namespace engine::scene {
+	
+	/**
+	 * Bounding volume hierarchy for objects that move, in the style of Box2D's dynamic tree.
+	 * Leaves store a fattened box, stretched ahead along the last displacement, so small and steady
+	 * moves don't touch the tree at all. A leaf that leaves its fat box is removed and reinserted
+	 * next to the sibling with the lowest surface area cost. Once per frame, rebalance() rotates the
+	 * ancestors of the reinserted leaves where swapping a child with a grandchild shrinks them, each
+	 * node at most once, which keeps the tree close to a fresh build without ever rebuilding it.
+	 * Query results are conservative by the margin; callers test the exact bounds if they need to.
+	 */
+	class DynamicBVH {
+	public:
+		static constexpr int NONE = -1;
+		// How many displacements ahead the fat box of a moving leaf reaches
+		static constexpr float DISPLACEMENT_MULTIPLIER = 4;
+	
+	private:
+		struct Node {
+			math::AABB box;
+			uint32_t value;
+			// Next free node while the node is unused
+			int parent;
+			int left, right;
+			int height;
+			// Last rebalance() that rotated the node
+			uint32_t pass;
+			
+			bool leaf() const;
+		};
+		
+		std::vector<Node> m_nodes;
+		int m_root;
+		int m_free;
+		size_t m_leaf_count;
+		float m_margin;
+		// Leaves reinserted since the last rebalance()
+		std::vector<int> m_moved;
+		uint32_t m_pass;
+	
+	public:
+		DynamicBVH();
+		/**
+		 * @param margin how far leaf boxes are grown on every side
+		 */
+		explicit DynamicBVH(float margin);
+		
+		DynamicBVH(const DynamicBVH& other) = default;
+		DynamicBVH(DynamicBVH&& other) noexcept = default;
+		DynamicBVH& operator=(const DynamicBVH& other) = default;
+		DynamicBVH& operator=(DynamicBVH&& other) noexcept = default;
+		~DynamicBVH() = default;
+		
+		/**
+		 * @return the proxy of the new leaf, stable until it is removed
+		 */
+		int insert(const math::AABB& box, uint32_t value);
+		void remove(int proxy);
+		/**
+		 * Updates the bounds of a leaf. Nothing happens while the box stays inside the fat box;
+		 * otherwise the leaf is reinserted with a new fat box, stretched along the displacement
+		 * since the last move. Its ancestors are rotated by the next rebalance().
+		 * @return true if the tree changed
+		 */
+		bool move(int proxy, const math::AABB& box, const math::Vec3& displacement = math::Vec3::ZERO);
+		/**
+		 * Rotates the ancestors of the leaves reinserted since the last call, each one once.
+		 * Call it once per frame, after the moves.
+		 */
+		void rebalance();
+		void clear();
+		
+		const math::AABB& fat_box(int proxy) const;
+		uint32_t value(int proxy) const;
+		
+		/**
+		 * Appends the values of the leaves touching the volume.
+		 */
+		void query(const math::Frustum& frustum, std::vector<uint32_t>& values) const;
+		void query(const math::AABB& box, std::vector<uint32_t>& values) const;
+		void query(const math::Sphere& sphere, std::vector<uint32_t>& values) const;
+		/**
+		 * Appends the leaves hit before maxDistance, sorted by where the ray enters their box.
+		 */
+		void raycast(const math::Ray& ray, float maxDistance, std::vector<Hit>& hits) const;
+		
+		size_t size() const;
+		int height() const;
+		/**
+		 * Surface area of all internal nodes relative to the root, lower is a better tree.
+		 */
+		float cost() const;
+	
+	private:
+		int allocate();
+		void release(int index);
+		
+		void insert_leaf(int leaf, bool rebalance);
+		void remove_leaf(int leaf);
+		math::AABB fatten(const math::AABB& box, const math::Vec3& displacement) const;
+		int find_sibling(const math::AABB& box) const;
+		/**
+		 * Recomputes the boxes and heights from the node to the root, rotating each node when rebalancing.
+		 */
+		void refit_upwards(int index, bool rebalance);
+		void rotate(int index);
+		void replace_child(int parent, int child, int replacement);
+		void collect(int index, std::vector<uint32_t>& values, std::vector<int>& stack) const;
+	};
+	
+} // engine::scene
@@ -0,0 +1,179 @@
+#include "HashGrid.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+#include "../util/Hash.hpp"
+
+namespace engine::scene {
+	HashGrid::HashGrid()
+		: HashGrid(16.0f) {
+	}
+	HashGrid::HashGrid(float cellSize)
+		: m_cell_size(cellSize), m_inverse_cell_size(1 / cellSize), m_cells(), m_entries(), m_free(NONE), m_size(0),
+		m_max_radius(0) {
+	}
+	
+	int HashGrid::insert(const math::Sphere& bounds, uint32_t value) {
+		int handle;
+		if (m_free == NONE) {
+			handle = static_cast<int>(m_entries.size());
+			m_entries.emplace_back();
+		}
+		else {
+			handle = m_free;
+			m_free = m_entries[handle].slot;
+		}
+		Entry& entry = m_entries[handle];
+		entry.position = bounds.center();
+		entry.radius = bounds.radius();
+		entry.value = value;
+		add_to_cell(handle, cell_key(entry.position));
+		m_size++;
+		return handle;
+	}
+	void HashGrid::move(int handle, const math::Sphere& bounds) {
+		Entry& entry = m_entries[handle];
+		entry.position = bounds.center();
+		entry.radius = bounds.radius();
+		
+		CellKey key = cell_key(entry.position);
+		if (key == entry.key) {
+			entry.cell->max_radius = std::max(entry.cell->max_radius, entry.radius);
+			m_max_radius = std::max(m_max_radius, entry.radius);
+			return;
+		}
+		remove_from_cell(handle);
+		add_to_cell(handle, key);
+	}
+	void HashGrid::remove(int handle) {
+		remove_from_cell(handle);
+		m_entries[handle].slot = m_free;
+		m_free = handle;
+		m_size--;
+	}
+	void HashGrid::clear() {
+		m_cells.clear();
+		m_entries.clear();
+		m_free = NONE;
+		m_size = 0;
+		m_max_radius = 0;
+	}
+	
+	void HashGrid::query(const math::Frustum& frustum, std::vector<uint32_t>& values) const {
+		// Only occupied cells exist, so walking all of them is bounded by the object count
+		for (const auto& [key, cell] : m_cells) {
+			math::Frustum::Containment containment = frustum.classify(loose_bounds(key, cell));
+			if (containment == math::Frustum::OUTSIDE) {
+				continue;
+			}
+			for (int handle : cell.entries) {
+				const Entry& entry = m_entries[handle];
+				if (containment == math::Frustum::INSIDE ||
+					frustum.intersects(math::Sphere(entry.position, entry.radius))) {
+					values.push_back(entry.value);
+				}
+			}
+		}
+	}
+	void HashGrid::query(const math::Sphere& sphere, std::vector<uint32_t>& values) const {
+		const math::Vec3& center = sphere.center();
+		// Entries are filed by center, so anything reaching into the sphere is centered within it
+		// grown by the largest radius
+		float reach = sphere.radius() + m_max_radius;
+		int x0 = cell_coordinate(center.x() - reach), x1 = cell_coordinate(center.x() + reach);
+		int y0 = cell_coordinate(center.y() - reach), y1 = cell_coordinate(center.y() + reach);
+		int z0 = cell_coordinate(center.z() - reach), z1 = cell_coordinate(center.z() + reach);
+		
+		size_t range = static_cast<size_t>(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+		if (range > m_cells.size()) {
+			// Large radius: cheaper to walk the occupied cells than to look up every cell in range
+			for (const auto& [key, cell] : m_cells) {
+				query_cell(key, cell, sphere, values);
+			}
+			return;
+		}
+		for (int x = x0; x <= x1; x++) {
+			for (int y = y0; y <= y1; y++) {
+				for (int z = z0; z <= z1; z++) {
+					auto it = m_cells.find({x, y, z});
+					if (it != m_cells.end()) {
+						query_cell(it->first, it->second, sphere, values);
+					}
+				}
+			}
+		}
+	}
+	
+	math::Sphere HashGrid::bounds(int handle) const {
+		return math::Sphere(m_entries[handle].position, m_entries[handle].radius);
+	}
+	uint32_t HashGrid::value(int handle) const {
+		return m_entries[handle].value;
+	}
+	size_t HashGrid::size() const {
+		return m_size;
+	}
+	size_t HashGrid::cell_count() const {
+		return m_cells.size();
+	}
+	float HashGrid::cell_size() const {
+		return m_cell_size;
+	}
+	
+	size_t HashGrid::CellHash::operator()(const CellKey& key) const {
+		// All 32 bits of every coordinate are hashed; the map compares whole keys, so distant cells never merge
+		uint64_t hash = util::hash_combine(static_cast<uint32_t>(key.x), static_cast<uint32_t>(key.y));
+		return static_cast<size_t>(util::hash_combine(hash, static_cast<uint32_t>(key.z)));
+	}
+	
+	int HashGrid::cell_coordinate(float position) const {
+		return static_cast<int>(std::floor(position * m_inverse_cell_size));
+	}
+	HashGrid::CellKey HashGrid::cell_key(const math::Vec3& position) const {
+		return {cell_coordinate(position.x()), cell_coordinate(position.y()), cell_coordinate(position.z())};
+	}
+	math::AABB HashGrid::loose_bounds(const CellKey& key, const Cell& cell) const {
+		math::Vec3 min(key.x * m_cell_size, key.y * m_cell_size, key.z * m_cell_size);
+		return math::AABB(min, min + math::Vec3(m_cell_size)).grow(cell.max_radius);
+	}
+	void HashGrid::add_to_cell(int handle, const CellKey& key) {
+		auto [it, inserted] = m_cells.try_emplace(key);
+		Cell& cell = it->second;
+		if (inserted) {
+			cell.max_radius = 0;
+		}
+		Entry& entry = m_entries[handle];
+		cell.max_radius = std::max(cell.max_radius, entry.radius);
+		m_max_radius = std::max(m_max_radius, entry.radius);
+		entry.key = key;
+		entry.cell = &cell;
+		entry.slot = static_cast<int>(cell.entries.size());
+		cell.entries.push_back(handle);
+	}
+	void HashGrid::remove_from_cell(int handle) {
+		Cell& cell = *m_entries[handle].cell;
+		// Swap with the last entry so removal doesn't shift the list
+		int slot = m_entries[handle].slot;
+		int last = cell.entries.back();
+		cell.entries[slot] = last;
+		m_entries[last].slot = slot;
+		cell.entries.pop_back();
+		// The max radius only shrinks when the cell empties, which keeps moves O(1)
+		if (cell.entries.empty()) {
+			m_cells.erase(m_entries[handle].key);
+		}
+	}
+	void HashGrid::query_cell(const CellKey& key, const Cell& cell, const math::Sphere& sphere,
+		std::vector<uint32_t>& values) const {
+		if (!sphere.intersects(loose_bounds(key, cell))) {
+			return;
+		}
+		for (int handle : cell.entries) {
+			const Entry& entry = m_entries[handle];
+			if (sphere.intersects(math::Sphere(entry.position, entry.radius))) {
+				values.push_back(entry.value);
+			}
+		}
+	}
+} // engine::scene
\ No newline at end of file
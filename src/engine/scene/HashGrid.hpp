@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "../math/Vec3.hpp"
+#include "../math/AABB.hpp"
+#include "../math/Sphere.hpp"
+#include "../math/Frustum.hpp"
+
+namespace engine::scene {
+	
+	/**
+	 * Loose uniform grid over an unbounded world, with only the occupied cells stored in a hash map.
+	 * Each entry lives in the cell containing its center, and every cell remembers the largest
+	 * radius it holds, so queries grow the cell bounds by that much instead of inserting objects
+	 * into every cell they overlap. Insert, move and remove are O(1); moves within a cell only
+	 * update the entry.
+	 * The cell size trades per-cell overhead against how tightly cells fit the queries; a handful
+	 * of objects per occupied cell works best (see SpatialIndexBench).
+	 */
+	class HashGrid {
+	public:
+		static constexpr int NONE = -1;
+	
+	private:
+		struct CellKey {
+			int x, y, z;
+			
+			bool operator==(const CellKey& other) const = default;
+		};
+		struct CellHash {
+			size_t operator()(const CellKey& key) const;
+		};
+		struct Cell;
+		struct Entry {
+			math::Vec3 position;
+			float radius;
+			uint32_t value;
+			CellKey key;
+			// Map nodes don't move on rehash, so moves within a cell skip the lookup
+			Cell* cell;
+			// Index in the cell's entry list, or the next free entry while unused
+			int slot;
+		};
+		struct Cell {
+			float max_radius;
+			std::vector<int> entries;
+		};
+		
+		float m_cell_size;
+		float m_inverse_cell_size;
+		std::unordered_map<CellKey, Cell, CellHash> m_cells;
+		std::vector<Entry> m_entries;
+		int m_free;
+		size_t m_size;
+		// Largest radius ever inserted, how far outside a cell its entries can reach
+		float m_max_radius;
+	
+	public:
+		HashGrid();
+		explicit HashGrid(float cellSize);
+		
+		// Entries point into the cell map; moving the map keeps its nodes, copying it doesn't
+		HashGrid(const HashGrid& other) = delete;
+		HashGrid(HashGrid&& other) noexcept = default;
+		HashGrid& operator=(const HashGrid& other) = delete;
+		HashGrid& operator=(HashGrid&& other) noexcept = default;
+		~HashGrid() = default;
+		
+		/**
+		 * @return a handle that stays valid until the entry is removed
+		 */
+		int insert(const math::Sphere& bounds, uint32_t value);
+		void move(int handle, const math::Sphere& bounds);
+		void remove(int handle);
+		void clear();
+		
+		/**
+		 * Appends the values of the entries whose bounding sphere touches the volume.
+		 */
+		void query(const math::Frustum& frustum, std::vector<uint32_t>& values) const;
+		void query(const math::Sphere& sphere, std::vector<uint32_t>& values) const;
+		
+		math::Sphere bounds(int handle) const;
+		uint32_t value(int handle) const;
+		size_t size() const;
+		size_t cell_count() const;
+		float cell_size() const;
+	
+	private:
+		int cell_coordinate(float position) const;
+		CellKey cell_key(const math::Vec3& position) const;
+		math::AABB loose_bounds(const CellKey& key, const Cell& cell) const;
+		void add_to_cell(int handle, const CellKey& key);
+		void remove_from_cell(int handle);
+		void query_cell(const CellKey& key, const Cell& cell, const math::Sphere& sphere,
+			std::vector<uint32_t>& values) const;
+	};
+	
+} // engine::scene
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+namespace engine::scene {
+	
+	/**
+	 * An item a raycast through a spatial index hit, and where the ray enters its box.
+	 */
+	struct Hit {
+		uint32_t value;
+		float distance;
+	};
+	
+} // engine::scene
@@ -0,0 +1,273 @@
+#include "SceneGraph.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+
+#include "../jobs/JobSystem.hpp"
+
+namespace engine::scene {
+	namespace {
+		// Nodes per job; smaller levels are updated on the calling thread
+		constexpr size_t PARALLEL_GRAIN = 2048;
+	}
+	
+	SceneGraph::SceneGraph()
+		: m_parents(), m_handles(), m_positions(), m_rotations(), m_scales(), m_world(), m_dirty(), m_levels(),
+		m_indices(), m_handle_parents(), m_used(), m_free(NONE), m_size(0), m_order_dirty(false), m_any_dirty(false),
+		m_updated(0) {
+	}
+	
+	int SceneGraph::create(int parent, const math::Vec3& position, const math::Vec3& rotation,
+		const math::Vec3& scale) {
+		if (parent != NONE && !contains(parent)) {
+			std::cerr << "Scene graph parent " << parent << " does not exist" << std::endl;
+			parent = NONE;
+		}
+		int node;
+		if (m_free == NONE) {
+			node = static_cast<int>(m_indices.size());
+			m_indices.push_back(NONE);
+			m_handle_parents.push_back(NONE);
+			m_used.push_back(false);
+		}
+		else {
+			node = m_free;
+			m_free = m_indices[node];
+		}
+		// Appended at the end until the next rebuild puts it on its level
+		m_indices[node] = static_cast<int>(m_handles.size());
+		m_handle_parents[node] = parent;
+		m_used[node] = true;
+		m_parents.push_back(parent == NONE ? NONE : index(parent));
+		m_handles.push_back(node);
+		m_positions.push_back(position);
+		m_rotations.push_back(rotation);
+		m_scales.push_back(scale);
+		m_world.push_back(parent == NONE ? local(node) : world(parent) * local(node));
+		m_dirty.push_back(1);
+		m_size++;
+		m_order_dirty = true;
+		m_any_dirty = true;
+		return node;
+	}
+	void SceneGraph::destroy(int node) {
+		if (!contains(node)) {
+			return;
+		}
+		release(node);
+		// Descendants are released a level per pass; their packed slots are dropped by the next rebuild
+		bool released = true;
+		while (released) {
+			released = false;
+			for (int child = 0; child < static_cast<int>(m_handle_parents.size()); child++) {
+				int parent = m_handle_parents[child];
+				if (m_used[child] && parent != NONE && !m_used[parent]) {
+					release(child);
+					released = true;
+				}
+			}
+		}
+		m_order_dirty = true;
+	}
+	void SceneGraph::parent(int node, int parent) {
+		if (!contains(node) || (parent != NONE && !contains(parent))) {
+			std::cerr << "Scene graph node " << node << " or parent " << parent << " does not exist" << std::endl;
+			return;
+		}
+		for (int ancestor = parent; ancestor != NONE; ancestor = m_handle_parents[ancestor]) {
+			if (ancestor == node) {
+				std::cerr << "Scene graph node " << node << " can't be parented to its own subtree" << std::endl;
+				return;
+			}
+		}
+		m_handle_parents[node] = parent;
+		m_order_dirty = true;
+		mark(node);
+	}
+	void SceneGraph::clear() {
+		*this = SceneGraph();
+	}
+	
+	bool SceneGraph::contains(int node) const {
+		return node >= 0 && node < static_cast<int>(m_used.size()) && m_used[node];
+	}
+	int SceneGraph::parent(int node) const {
+		return m_handle_parents[node];
+	}
+	size_t SceneGraph::size() const {
+		return m_size;
+	}
+	
+	const math::Vec3& SceneGraph::position(int node) const {
+		return m_positions[index(node)];
+	}
+	const math::Vec3& SceneGraph::rotation(int node) const {
+		return m_rotations[index(node)];
+	}
+	const math::Vec3& SceneGraph::scale(int node) const {
+		return m_scales[index(node)];
+	}
+	math::Vec3& SceneGraph::position(int node) {
+		mark(node);
+		return m_positions[index(node)];
+	}
+	math::Vec3& SceneGraph::rotation(int node) {
+		mark(node);
+		return m_rotations[index(node)];
+	}
+	math::Vec3& SceneGraph::scale(int node) {
+		mark(node);
+		return m_scales[index(node)];
+	}
+	
+	math::Mat4 SceneGraph::local(int node) const {
+		int i = index(node);
+		return math::Mat4::transform(m_positions[i], m_rotations[i], m_scales[i]);
+	}
+	const math::Mat4& SceneGraph::world(int node) const {
+		return m_world[index(node)];
+	}
+	
+	void SceneGraph::update() {
+		if (!prepare()) {
+			m_updated = 0;
+			return;
+		}
+		std::atomic<size_t> updated = 0;
+		for (size_t level = 0; level < level_count(); level++) {
+			jobs::JobSystem::shared().parallel_for(level_begin(level), level_end(level), PARALLEL_GRAIN,
+				[this, &updated](size_t begin, size_t end) {
+					updated += update_range(begin, end);
+				});
+		}
+		finish(updated);
+	}
+	
+	bool SceneGraph::prepare() {
+		if (m_order_dirty) {
+			rebuild();
+		}
+		return m_any_dirty;
+	}
+	size_t SceneGraph::level_count() const {
+		return m_levels.empty() ? 0 : m_levels.size() - 1;
+	}
+	size_t SceneGraph::level_begin(size_t level) const {
+		return m_levels[level];
+	}
+	size_t SceneGraph::level_end(size_t level) const {
+		return m_levels[level + 1];
+	}
+	size_t SceneGraph::update_range(size_t begin, size_t end) {
+		size_t updated = 0;
+		for (size_t i = begin; i < end; i++) {
+			int parent = m_parents[i];
+			// A dirty parent was recomputed on the level above, so its whole subtree follows
+			if (!m_dirty[i] && (parent == NONE || !m_dirty[parent])) {
+				continue;
+			}
+			math::Mat4 local = math::Mat4::transform(m_positions[i], m_rotations[i], m_scales[i]);
+			m_world[i] = parent == NONE ? local : m_world[parent] * local;
+			m_dirty[i] = 1;
+			updated++;
+		}
+		return updated;
+	}
+	void SceneGraph::finish(size_t updated) {
+		std::fill(m_dirty.begin(), m_dirty.end(), 0);
+		m_any_dirty = false;
+		m_updated = updated;
+	}
+	
+	size_t SceneGraph::updated() const {
+		return m_updated;
+	}
+	
+	int SceneGraph::index(int node) const {
+		return m_indices[node];
+	}
+	void SceneGraph::release(int node) {
+		m_used[node] = false;
+		m_handle_parents[node] = NONE;
+		m_indices[node] = m_free;
+		m_free = node;
+		m_size--;
+	}
+	void SceneGraph::mark(int node) {
+		m_dirty[index(node)] = 1;
+		m_any_dirty = true;
+	}
+	void SceneGraph::rebuild() {
+		// Children of every handle as one flat array, offsets by handle
+		size_t handles = m_handle_parents.size();
+		std::vector<int> offsets(handles + 1, 0);
+		for (size_t node = 0; node < handles; node++) {
+			if (m_used[node] && m_handle_parents[node] != NONE) {
+				offsets[m_handle_parents[node] + 1]++;
+			}
+		}
+		for (size_t node = 0; node < handles; node++) {
+			offsets[node + 1] += offsets[node];
+		}
+		std::vector<int> children(offsets[handles]);
+		std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+		std::vector<int> order;
+		order.reserve(m_size);
+		for (size_t node = 0; node < handles; node++) {
+			if (!m_used[node]) {
+				continue;
+			}
+			if (m_handle_parents[node] == NONE) {
+				order.push_back(static_cast<int>(node));
+			}
+			else {
+				children[fill[m_handle_parents[node]]++] = static_cast<int>(node);
+			}
+		}
+		
+		// Breadth-first, one level at a time
+		m_levels.clear();
+		m_levels.push_back(0);
+		size_t begin = 0;
+		while (begin < order.size()) {
+			size_t end = order.size();
+			for (size_t i = begin; i < end; i++) {
+				int node = order[i];
+				order.insert(order.end(), children.begin() + offsets[node], children.begin() + offsets[node + 1]);
+			}
+			m_levels.push_back(end);
+			begin = end;
+		}
+		
+		std::vector<int> parents(order.size());
+		std::vector<math::Vec3> positions(order.size());
+		std::vector<math::Vec3> rotations(order.size());
+		std::vector<math::Vec3> scales(order.size());
+		std::vector<math::Mat4> world(order.size());
+		std::vector<uint8_t> dirty(order.size());
+		for (size_t i = 0; i < order.size(); i++) {
+			int old = m_indices[order[i]];
+			positions[i] = m_positions[old];
+			rotations[i] = m_rotations[old];
+			scales[i] = m_scales[old];
+			world[i] = m_world[old];
+			dirty[i] = m_dirty[old];
+		}
+		for (size_t i = 0; i < order.size(); i++) {
+			m_indices[order[i]] = static_cast<int>(i);
+		}
+		for (size_t i = 0; i < order.size(); i++) {
+			int parent = m_handle_parents[order[i]];
+			parents[i] = parent == NONE ? NONE : m_indices[parent];
+		}
+		m_parents = std::move(parents);
+		m_handles = std::move(order);
+		m_positions = std::move(positions);
+		m_rotations = std::move(rotations);
+		m_scales = std::move(scales);
+		m_world = std::move(world);
+		m_dirty = std::move(dirty);
+		m_order_dirty = false;
+	}
+} // engine::scene
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "../math/Vec3.hpp"
+#include "../math/Mat4.hpp"
+
+namespace engine::scene {
+	
+	/**
+	 * Transform hierarchy. Every node has a local position, rotation (Euler angles, applied like
+	 * Object::model()) and scale relative to its parent, and a cached world matrix.
+	 *
+	 * Nodes are stored breadth-first: one packed array per field, sorted by depth, so a parent
+	 * always comes before its children and update() is a single forward pass. Changing a local
+	 * transform only marks the node; update() recomputes the marked nodes and everything below
+	 * them and leaves the rest of the tree alone.
+	 * All nodes of a level depend only on the level above, so each level is updated in parallel.
+	 *
+	 * Handles are stable; the packed order is rebuilt lazily after the structure changes.
+	 */
+	class SceneGraph {
+	public:
+		static constexpr int NONE = -1;
+	
+	private:
+		// Packed, breadth-first
+		std::vector<int> m_parents;
+		std::vector<int> m_handles;
+		std::vector<math::Vec3> m_positions;
+		std::vector<math::Vec3> m_rotations;
+		std::vector<math::Vec3> m_scales;
+		std::vector<math::Mat4> m_world;
+		std::vector<uint8_t> m_dirty;
+		std::vector<size_t> m_levels;
+		
+		// Handle -> packed index, or the next free handle while unused
+		std::vector<int> m_indices;
+		std::vector<int> m_handle_parents;
+		std::vector<bool> m_used;
+		int m_free;
+		size_t m_size;
+		bool m_order_dirty;
+		bool m_any_dirty;
+		size_t m_updated;
+	
+	public:
+		SceneGraph();
+		
+		SceneGraph(const SceneGraph& other) = default;
+		SceneGraph(SceneGraph&& other) noexcept = default;
+		SceneGraph& operator=(const SceneGraph& other) = default;
+		SceneGraph& operator=(SceneGraph&& other) noexcept = default;
+		~SceneGraph() = default;
+		
+		/**
+		 * @return a handle that stays valid until the node is destroyed
+		 */
+		int create(int parent = NONE, const math::Vec3& position = math::Vec3::ZERO,
+			const math::Vec3& rotation = math::Vec3::ZERO, const math::Vec3& scale = math::Vec3::ONE);
+		/**
+		 * Destroys the node and its whole subtree.
+		 */
+		void destroy(int node);
+		/**
+		 * Keeps the local transform, so the node moves with its new parent.
+		 */
+		void parent(int node, int parent);
+		void clear();
+		
+		bool contains(int node) const;
+		int parent(int node) const;
+		size_t size() const;
+		
+		const math::Vec3& position(int node) const;
+		const math::Vec3& rotation(int node) const;
+		const math::Vec3& scale(int node) const;
+		/**
+		 * Non-const access marks the node dirty.
+		 */
+		math::Vec3& position(int node);
+		math::Vec3& rotation(int node);
+		math::Vec3& scale(int node);
+		
+		math::Mat4 local(int node) const;
+		/**
+		 * As of the last update().
+		 */
+		const math::Mat4& world(int node) const;
+		
+		/**
+		 * Recomputes the world matrices of the dirty subtrees. Large levels are split across the
+		 * shared job system.
+		 */
+		void update();
+		
+		size_t level_count() const;
+		/**
+		 * Nodes recomputed by the last update().
+		 */
+		size_t updated() const;
+	
+	private:
+		/**
+		 * @return false when nothing is dirty and the levels can be skipped
+		 */
+		bool prepare();
+		size_t level_begin(size_t level) const;
+		size_t level_end(size_t level) const;
+		/**
+		 * @return how many nodes of the packed range were recomputed
+		 */
+		size_t update_range(size_t begin, size_t end);
+		void finish(size_t updated);
+		
+		int index(int node) const;
+		void release(int node);
+		void mark(int node);
+		void rebuild();
+	};
+	
+} // engine::scene
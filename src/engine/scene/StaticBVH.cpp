@@ -0,0 +1,295 @@
+#include "StaticBVH.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace engine::scene {
+	StaticBVH::StaticBVH()
+		: m_nodes(), m_items(), m_x(), m_y(), m_z(), m_ex(), m_ey(), m_ez() {
+	}
+	
+	StaticBVH StaticBVH::build(std::vector<Item> items) {
+		StaticBVH bvh;
+		bvh.m_items = std::move(items);
+		if (bvh.m_items.empty()) {
+			return bvh;
+		}
+		std::vector<math::Vec3> centers(bvh.m_items.size());
+		for (size_t i = 0; i < bvh.m_items.size(); i++) {
+			centers[i] = bvh.m_items[i].box.center();
+		}
+		// A binary tree with at least one item per leaf has fewer than twice as many nodes
+		bvh.m_nodes.reserve(2 * bvh.m_items.size() / MAX_LEAF_SIZE + 1);
+		bvh.build_node(0, bvh.m_items.size(), centers);
+		bvh.m_nodes.shrink_to_fit();
+		
+		size_t padded = bvh.m_items.size() + MAX_LEAF_SIZE - 1;
+		for (std::vector<float>* values : {&bvh.m_x, &bvh.m_y, &bvh.m_z, &bvh.m_ex, &bvh.m_ey, &bvh.m_ez}) {
+			values->resize(padded, 0);
+		}
+		for (size_t i = 0; i < bvh.m_items.size(); i++) {
+			math::Vec3 center = bvh.m_items[i].box.center();
+			math::Vec3 extents = bvh.m_items[i].box.extents();
+			bvh.m_x[i] = center.x();
+			bvh.m_y[i] = center.y();
+			bvh.m_z[i] = center.z();
+			bvh.m_ex[i] = extents.x();
+			bvh.m_ey[i] = extents.y();
+			bvh.m_ez[i] = extents.z();
+		}
+		return bvh;
+	}
+	
+	void StaticBVH::query(const math::Frustum& frustum, std::vector<uint32_t>& values) const {
+		if (m_nodes.empty()) {
+			return;
+		}
+		std::vector<uint32_t> stack;
+		stack.reserve(64);
+		stack.push_back(0);
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = m_nodes[index];
+			
+			math::Frustum::Containment containment = frustum.classify(node.box);
+			if (containment == math::Frustum::OUTSIDE) {
+				continue;
+			}
+			if (containment == math::Frustum::INSIDE) {
+				collect(index, values);
+			}
+			else if (node.count > 0) {
+				// A full batch is one SIMD step, the results past the leaf's own items are ignored
+				uint8_t visible[MAX_LEAF_SIZE];
+				frustum.test_boxes(&m_x[node.offset], &m_y[node.offset], &m_z[node.offset], &m_ex[node.offset],
+					&m_ey[node.offset], &m_ez[node.offset], MAX_LEAF_SIZE, visible);
+				for (uint32_t i = 0; i < node.count; i++) {
+					if (visible[i]) {
+						values.push_back(m_items[node.offset + i].value);
+					}
+				}
+			}
+			else {
+				stack.push_back(node.offset);
+				stack.push_back(index + 1);
+			}
+		}
+	}
+	void StaticBVH::query(const math::AABB& box, std::vector<uint32_t>& values) const {
+		if (m_nodes.empty()) {
+			return;
+		}
+		std::vector<uint32_t> stack;
+		stack.reserve(64);
+		stack.push_back(0);
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = m_nodes[index];
+			if (!node.box.intersects(box)) {
+				continue;
+			}
+			if (node.count > 0) {
+				for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+					if (m_items[i].box.intersects(box)) {
+						values.push_back(m_items[i].value);
+					}
+				}
+			}
+			else {
+				stack.push_back(node.offset);
+				stack.push_back(index + 1);
+			}
+		}
+	}
+	void StaticBVH::query(const math::Sphere& sphere, std::vector<uint32_t>& values) const {
+		if (m_nodes.empty()) {
+			return;
+		}
+		std::vector<uint32_t> stack;
+		stack.reserve(64);
+		stack.push_back(0);
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = m_nodes[index];
+			if (!sphere.intersects(node.box)) {
+				continue;
+			}
+			if (node.count > 0) {
+				for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+					if (sphere.intersects(m_items[i].box)) {
+						values.push_back(m_items[i].value);
+					}
+				}
+			}
+			else {
+				stack.push_back(node.offset);
+				stack.push_back(index + 1);
+			}
+		}
+	}
+	void StaticBVH::raycast(const math::Ray& ray, float maxDistance, std::vector<Hit>& hits) const {
+		if (m_nodes.empty()) {
+			return;
+		}
+		size_t first = hits.size();
+		std::vector<uint32_t> stack;
+		stack.reserve(64);
+		stack.push_back(0);
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = m_nodes[index];
+			float distance;
+			if (!ray.intersects(node.box, maxDistance, distance)) {
+				continue;
+			}
+			if (node.count > 0) {
+				for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+					if (ray.intersects(m_items[i].box, maxDistance, distance)) {
+						hits.push_back({m_items[i].value, distance});
+					}
+				}
+			}
+			else {
+				stack.push_back(node.offset);
+				stack.push_back(index + 1);
+			}
+		}
+		std::sort(hits.begin() + first, hits.end(), [](const Hit& a, const Hit& b) {
+			return a.distance < b.distance;
+		});
+	}
+	
+	size_t StaticBVH::size() const {
+		return m_items.size();
+	}
+	size_t StaticBVH::node_count() const {
+		return m_nodes.size();
+	}
+	const math::AABB& StaticBVH::bounds() const {
+		return m_nodes.empty() ? math::AABB::EMPTY : m_nodes[0].box;
+	}
+	
+	uint32_t StaticBVH::build_node(size_t first, size_t count, std::vector<math::Vec3>& centers) {
+		uint32_t index = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.push_back({math::AABB::EMPTY, 0, 0});
+		
+		math::AABB box = math::AABB::EMPTY;
+		math::AABB centerBox = math::AABB::EMPTY;
+		for (size_t i = first; i < first + count; i++) {
+			box = box.merge(m_items[i].box);
+			centerBox = centerBox.expand(centers[i]);
+		}
+		m_nodes[index].box = box;
+		
+		if (count <= MAX_LEAF_SIZE) {
+			m_nodes[index].offset = static_cast<uint32_t>(first);
+			m_nodes[index].count = static_cast<uint32_t>(count);
+			return index;
+		}
+		
+		// Bin the centers along each axis and split where the surface area cost is lowest
+		struct Bin {
+			math::AABB box;
+			size_t count;
+		};
+		int bestAxis = -1;
+		int bestSplit = 0;
+		float bestCost = 0;
+		float minimum[3] = {centerBox.min().x(), centerBox.min().y(), centerBox.min().z()};
+		float extent[3] = {
+			centerBox.max().x() - minimum[0], centerBox.max().y() - minimum[1], centerBox.max().z() - minimum[2]
+		};
+		for (int axis = 0; axis < 3; axis++) {
+			if (extent[axis] <= 0) {
+				continue;
+			}
+			Bin bins[BIN_COUNT];
+			for (Bin& bin : bins) {
+				bin = {math::AABB::EMPTY, 0};
+			}
+			float scale = BIN_COUNT / extent[axis];
+			for (size_t i = first; i < first + count; i++) {
+				float center = axis == 0 ? centers[i].x() : axis == 1 ? centers[i].y() : centers[i].z();
+				int b = std::min(BIN_COUNT - 1, static_cast<int>((center - minimum[axis]) * scale));
+				bins[b].box = bins[b].box.merge(m_items[i].box);
+				bins[b].count++;
+			}
+			
+			// Sweep from the right to get the cost of every right side, then from the left
+			float rightArea[BIN_COUNT];
+			size_t rightCount[BIN_COUNT];
+			math::AABB right = math::AABB::EMPTY;
+			size_t rightTotal = 0;
+			for (int b = BIN_COUNT - 1; b > 0; b--) {
+				right = right.merge(bins[b].box);
+				rightTotal += bins[b].count;
+				rightArea[b] = right.empty() ? 0 : right.surface_area();
+				rightCount[b] = rightTotal;
+			}
+			math::AABB left = math::AABB::EMPTY;
+			size_t leftTotal = 0;
+			for (int b = 1; b < BIN_COUNT; b++) {
+				left = left.merge(bins[b - 1].box);
+				leftTotal += bins[b - 1].count;
+				if (leftTotal == 0 || rightCount[b] == 0) {
+					continue;
+				}
+				float cost = left.surface_area() * leftTotal + rightArea[b] * rightCount[b];
+				if (bestAxis == -1 || cost < bestCost) {
+					bestAxis = axis;
+					bestSplit = b;
+					bestCost = cost;
+				}
+			}
+		}
+		
+		size_t middle;
+		if (bestAxis == -1) {
+			// Every center is in the same spot, any split is as good as another
+			middle = first + count / 2;
+		}
+		else {
+			float scale = BIN_COUNT / extent[bestAxis];
+			size_t i = first;
+			size_t j = first + count;
+			while (i < j) {
+				float center = bestAxis == 0 ? centers[i].x() : bestAxis == 1 ? centers[i].y() : centers[i].z();
+				int b = std::min(BIN_COUNT - 1, static_cast<int>((center - minimum[bestAxis]) * scale));
+				if (b < bestSplit) {
+					i++;
+				}
+				else {
+					j--;
+					std::swap(m_items[i], m_items[j]);
+					std::swap(centers[i], centers[j]);
+				}
+			}
+			middle = i;
+		}
+		
+		build_node(first, middle - first, centers);
+		uint32_t rightChild = build_node(middle, first + count - middle, centers);
+		m_nodes[index].offset = rightChild;
+		return index;
+	}
+	void StaticBVH::collect(uint32_t index, std::vector<uint32_t>& values) const {
+		// Items of a subtree are contiguous: from the first item of its leftmost leaf to the end
+		// of its rightmost one
+		uint32_t leftmost = index;
+		while (m_nodes[leftmost].count == 0) {
+			leftmost++;
+		}
+		uint32_t rightmost = index;
+		while (m_nodes[rightmost].count == 0) {
+			rightmost = m_nodes[rightmost].offset;
+		}
+		uint32_t end = m_nodes[rightmost].offset + m_nodes[rightmost].count;
+		for (uint32_t i = m_nodes[leftmost].offset; i < end; i++) {
+			values.push_back(m_items[i].value);
+		}
+	}
+} // engine::scene
\ No newline at end of file
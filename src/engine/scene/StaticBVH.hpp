@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "../math/AABB.hpp"
+#include "../math/Sphere.hpp"
+#include "../math/Frustum.hpp"
+#include "../math/Ray.hpp"
+#include "Hit.hpp"
+
+namespace engine::scene {
+	
+	/**
+	 * Bounding volume hierarchy for objects that never move, built once with a binned surface area
+	 * heuristic. Nodes are 32 bytes and stored depth first, so the left child of a node is always the
+	 * next one and a traversal mostly walks forward through memory. Leaves keep the exact boxes of
+	 * their items, which are tested individually; against a frustum all items of a leaf are tested
+	 * at once with Frustum::test_boxes().
+	 */
+	class StaticBVH {
+	public:
+		static constexpr size_t MAX_LEAF_SIZE = 4;
+		static constexpr int BIN_COUNT = 16;
+		
+		struct Item {
+			math::AABB box;
+			uint32_t value;
+		};
+	
+	private:
+		struct Node {
+			math::AABB box;
+			// Right child for internal nodes, first item for leaves
+			uint32_t offset;
+			// 0 for internal nodes
+			uint32_t count;
+		};
+		
+		std::vector<Node> m_nodes;
+		std::vector<Item> m_items;
+		// Centers and half extents of the item boxes in item order, padded so every leaf can be read
+		// as one full batch of MAX_LEAF_SIZE
+		std::vector<float> m_x, m_y, m_z;
+		std::vector<float> m_ex, m_ey, m_ez;
+	
+	public:
+		StaticBVH();
+		
+		StaticBVH(const StaticBVH& other) = default;
+		StaticBVH(StaticBVH&& other) noexcept = default;
+		StaticBVH& operator=(const StaticBVH& other) = default;
+		StaticBVH& operator=(StaticBVH&& other) noexcept = default;
+		~StaticBVH() = default;
+		
+		static StaticBVH build(std::vector<Item> items);
+		
+		/**
+		 * Appends the values of the items touching the volume.
+		 */
+		void query(const math::Frustum& frustum, std::vector<uint32_t>& values) const;
+		void query(const math::AABB& box, std::vector<uint32_t>& values) const;
+		void query(const math::Sphere& sphere, std::vector<uint32_t>& values) const;
+		/**
+		 * Appends the items hit before maxDistance, sorted by where the ray enters their box.
+		 */
+		void raycast(const math::Ray& ray, float maxDistance, std::vector<Hit>& hits) const;
+		
+		size_t size() const;
+		size_t node_count() const;
+		const math::AABB& bounds() const;
+	
+	private:
+		uint32_t build_node(size_t first, size_t count, std::vector<math::Vec3>& centers);
+		void collect(uint32_t index, std::vector<uint32_t>& values) const;
+	};
+	
+} // engine::scene
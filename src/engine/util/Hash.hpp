@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace engine::util {
+	
+	// 64-bit FNV-1a, stable across runs and platforms so it can be used for on-disk keys
+	constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+	constexpr uint64_t FNV_PRIME = 1099511628211ull;
+	
+	constexpr uint64_t fnv1a(std::string_view data, uint64_t hash = FNV_OFFSET_BASIS) {
+		for (char c : data) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+	// Without this a string literal would pick the (pointer, size) overload below
+	constexpr uint64_t fnv1a(const char* data, uint64_t hash = FNV_OFFSET_BASIS) {
+		return fnv1a(std::string_view(data), hash);
+	}
+	
+	inline uint64_t fnv1a(const void* data, size_t size, uint64_t hash = FNV_OFFSET_BASIS) {
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+	
+	constexpr uint64_t hash_combine(uint64_t seed, uint64_t value) {
+		return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+	}
+	
+} // engine::util
@@ -1,7 +1,15 @@
 #include <iostream>
+#include <string>
+#include <cstdlib>
 #include <cmath>
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <optional>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -11,12 +19,34 @@
 #include "engine/math/Vec2.hpp"
 #include "engine/math/Mat3.hpp"
 #include "engine/Camera.hpp"
+#include "engine/CameraPath.hpp"
 #include "engine/render/Shader.hpp"
+#include "engine/render/ProgramCache.hpp"
+#include "engine/render/ShaderVariants.hpp"
+#include "engine/render/ShaderBatch.hpp"
+#include "engine/render/CameraUniforms.hpp"
+#include "engine/render/InstanceRenderer.hpp"
+#include "engine/render/GeometryArena.hpp"
+#include "engine/render/IndirectRenderer.hpp"
+#include "engine/scene/StaticBVH.hpp"
+#include "engine/scene/SceneGraph.hpp"
+#include "engine/render/OcclusionCuller.hpp"
+#include "engine/render/SnapshotRing.hpp"
+#include "engine/render/FramePacer.hpp"
+#include "engine/render/RenderStats.hpp"
+#include "engine/render/Framebuffer.hpp"
+#include "engine/profile/Profiler.hpp"
+#include "engine/profile/GpuProfiler.hpp"
+#include "engine/profile/MemoryTracker.hpp"
+#include "engine/render/GLBackend.hpp"
 #include "engine/object/Mesh.hpp"
-#include "engine/object/Object.hpp"
+#include "engine/ecs/Registry.hpp"
+#include "engine/ecs/RenderSystem.hpp"
+#include "engine/ecs/Prefabs.hpp"
 #include "engine/io/Window.hpp"
-#include "engine/render/RenderHelper.hpp"
 #include "engine/object/Material.hpp"
+#include "engine/graphics/TextureAtlas.hpp"
+#include "engine/graphics/TextureResidency.hpp"
 #include "engine/graphics/TextureMixingMode.hpp"
 
 #pragma clang diagnostic push
@@ -24,7 +54,28 @@
 
 // https://docs.gl/
 
-const int GAME_FPS = 60;
+// Let the swap wait for vblank; otherwise the frame pacer alone sets the rate
+const bool VSYNC = false;
+// Frames the CPU may run ahead of the GPU before waiting on a fence; 0 turns fences off
+const int FRAMES_IN_FLIGHT = 2;
+// Length of one simulation tick, independent of the frame rate
+const std::chrono::nanoseconds SIMULATION_STEP(1000000000 / 60);
+// Most ticks simulated in one go after a stall
+const int MAX_SIMULATION_STEPS = 5;
+
+// Command line options, see print_usage()
+struct Options {
+	bool headless = false;
+	int frames = 600;
+	int width = 800;
+	int height = 600;
+	// native, egl or osmesa
+	std::string context = "native";
+	std::string camera_path;
+	std::string stats_path;
+	std::string capture_path;
+	bool profile = false;
+};
 
 engine::io::Window window(800, 600, "Engine");
 engine::Camera camera;
@@ -33,6 +84,12 @@ engine::Shader shader_col_3d;
 engine::Shader shader_tex_3d;
 engine::Shader shader_tex_mix_3d;
 engine::Shader shader_tex_refract_3d;
+engine::render::ShaderBatch shader_batch;
+engine::render::CameraUniforms camera_uniforms;
+engine::render::InstanceRenderer instance_renderer;
+engine::render::GeometryArena geometry_arena;
+engine::render::IndirectRenderer indirect_renderer;
+engine::render::ShaderVariants shader_tex_mix_variants("../res/shaders/tex-3d.vert", "../res/shaders/tex_mix.frag");
 
 engine::graphics::Texture texture1;
 engine::graphics::Texture texture2;
@@ -41,69 +98,56 @@ engine::graphics::Texture texture3;
 engine::render::Material texture;
 engine::render::Material offsetMap;
 engine::render::Material heightMap;
+// GPU memory the streamed textures may use; their finer mips come in as objects get closer
+const size_t TEXTURE_BUDGET = 64 * 1024 * 1024;
+// Created once the context exists, the base texture is streamed through it
+std::optional<engine::graphics::TextureResidency> texture_residency;
+engine::graphics::TextureResidency::Handle streamed_texture = -1;
 
 //engine::render::Mesh _square_mesh;
 engine::render::Mesh square_ring_mesh;
 engine::render::Mesh square_mesh;
-std::vector<engine::object::Object> objects;
+// Every object is an entity with a transform and a render component
+engine::ecs::Registry registry;
+engine::ecs::RenderSystem render_system;
+engine::scene::SceneGraph scene_graph;
+// Objects only move through the scene graph, and rarely, so they are culled through a static tree that
+// update_scene() rebuilds whenever a node moved
+engine::scene::StaticBVH static_objects;
+// Large objects rasterized into the CPU depth buffer to hide what is behind them, as packed render
+// indices; nothing is removed from the registry, so they stay valid
+std::vector<uint32_t> occluders;
+engine::render::OcclusionCuller occlusion_culler;
+// Visible blended objects of the snapshot being built, kept between frames
+std::vector<uint32_t> blended;
 
-void add_cube(engine::math::Vec3 position, float alpha = 1) {
-	engine::render::Mesh& mesh = square_mesh;
-	{
-		engine::object::Object obj(mesh);
-		obj.position() = engine::math::Vec3(0, 0, 1) + position;
-		obj.rotation() = engine::math::Vec3(0, 0, 0);
-		obj.scale() = engine::math::Vec3(1);
-		obj.albedo() = engine::math::Vec4(1, 0, 0, alpha);
-		objects.push_back(obj);
-	}
-	{
-		engine::object::Object obj(mesh);
-		obj.position() = engine::math::Vec3(0, 0, -1) + position;
-		obj.rotation() = engine::math::Vec3(0, M_PI, 0);
-		obj.scale() = engine::math::Vec3(1, 1, 1);
-		obj.albedo() = engine::math::Vec4(1, 0, 0, alpha);
-		objects.push_back(obj);
-	}
-	{
-		engine::object::Object obj(mesh);
-		obj.position() = engine::math::Vec3(-1, 0, 0) + position;
-		obj.rotation() = engine::math::Vec3(0, -M_PI / 2, 0);
-		obj.scale() = engine::math::Vec3(1, 1, 1);
-		obj.albedo() = engine::math::Vec4(0, 1, 0, alpha);
-		objects.push_back(obj);
-	}
-	{
-		engine::object::Object obj(mesh);
-		obj.position() = engine::math::Vec3(1, 0, 0) + position;
-		obj.rotation() = engine::math::Vec3(0, M_PI / 2, 0);
-		obj.scale() = engine::math::Vec3(1, 1, 1);
-		obj.albedo() = engine::math::Vec4(0, 1, 0, alpha);
-		objects.push_back(obj);
-	}
-	{
-		engine::object::Object obj(mesh);
-		obj.position() = engine::math::Vec3(0, 1, 0) + position;
-		obj.rotation() = engine::math::Vec3(-M_PI / 2, 0, 0);
-		obj.scale() = engine::math::Vec3(1, 1, 1);
-		obj.albedo() = engine::math::Vec4(0, 0, 1, alpha);
-		objects.push_back(obj);
-	}
-	{
-		engine::object::Object obj(mesh);
-		obj.position() = engine::math::Vec3(0, -1, 0) + position;
-		obj.rotation() = engine::math::Vec3(M_PI / 2, 0, 0);
-		obj.scale() = engine::math::Vec3(1, 1, 1);
-		obj.albedo() = engine::math::Vec4(0, 0, 1, alpha);
-		objects.push_back(obj);
-	}
-}
+// Input sampled by the main thread for the simulation thread
+struct SharedInput {
+	engine::Camera::Input camera;
+	std::chrono::steady_clock::time_point time;
+	// New aspect ratio after a resize, 0 if unchanged
+	float aspect_ratio = 0;
+};
+std::mutex input_mutex;
+SharedInput shared_input;
+// Simulation thread -> render thread, the render thread always draws the newest frame
+engine::render::SnapshotRing snapshots;
+std::atomic<bool> simulating(false);
+// F2 starts and stops a capture, written to PROFILE_PATH when it stops
+const char* PROFILE_PATH = "profile.json";
+// F3 prints render stats percentiles and writes the recorded frames here; also written on exit
+const char* STATS_PATH = "render_stats.csv";
+// F4 prints CPU and GPU memory usage per subsystem; the full report is written here on exit
+const char* MEMORY_PATH = "memory_report.txt";
+engine::profile::GpuProfiler gpu_profiler;
 
 void on_mouse_move(GLFWwindow* window, double x, double y) {
 }
 
 void on_resize(GLFWwindow* window, int width, int height) {
-	camera.aspect_ratio((float) width / height);
+	// The camera belongs to the simulation thread
+	std::lock_guard<std::mutex> lock(input_mutex);
+	shared_input.aspect_ratio = (float) width / height;
 }
 
 void on_key(GLFWwindow* window, int key, int scancode, int action, int mods) {
@@ -112,56 +156,474 @@ void on_key(GLFWwindow* window, int key, int scancode, int action, int mods) {
 			case GLFW_KEY_ESCAPE:
 				glfwSetWindowShouldClose(window, GLFW_TRUE);
 				break;
+			case GLFW_KEY_F2:
+				if (engine::profile::Profiler::enabled()) {
+					engine::profile::Profiler::enable(false);
+					if (engine::profile::Profiler::write_chrome_trace(PROFILE_PATH)) {
+						std::cout << "Wrote profile to " << PROFILE_PATH << std::endl;
+					}
+				}
+				else {
+					engine::profile::Profiler::clear();
+					engine::profile::Profiler::enable(true);
+				}
+				break;
+			case GLFW_KEY_F3:
+				std::cout << engine::render::RenderStats::report();
+				engine::render::RenderStats::write_csv(STATS_PATH);
+				break;
+			case GLFW_KEY_F4:
+				std::cout << engine::profile::MemoryTracker::report();
+				break;
 			default:
 				break;
 		}
 	}
 }
 
-void render_all() {
-	engine::Shader& shader = shader_tex_mix_3d;
-	std::vector<engine::object::Renderable*> renderables;
-	for (auto& obj : objects) {
-		renderables.push_back(&obj);
+// Propagates scene graph moves to the entities attached to nodes and to the culling tree. Runs on the
+// simulation thread, before build_snapshot().
+void update_scene() {
+	scene_graph.update();
+	if (scene_graph.updated() > 0) {
+		registry.update_transforms();
+		static_objects = engine::scene::StaticBVH::build(engine::ecs::RenderSystem::bounds(registry));
+	}
+}
+
+// Builds the next snapshot: camera, visibility and draw lists. Runs on the simulation thread.
+void build_snapshot(engine::render::FrameSnapshot& snapshot) {
+	PROFILE_SCOPE("build_snapshot");
+	std::chrono::steady_clock::time_point cull_start = std::chrono::steady_clock::now();
+	// Only objects inside the view frustum are sorted and submitted
+	render_system.cull(registry, static_objects, camera.frustum());
+	render_system.occlude(registry, occlusion_culler, camera.projection_matrix() * camera.view_matrix(), occluders);
+	snapshot.culled = (uint32_t) render_system.culled();
+	
+	const std::vector<uint32_t>& transforms = registry.render_transforms();
+	const std::vector<const engine::render::Mesh*>& meshes = registry.meshes();
+	const std::vector<const engine::render::Material*>& materials = registry.materials();
+	const std::vector<engine::math::Vec4>& albedos = registry.albedos();
+	const std::vector<engine::math::Mat4>& world = registry.world_matrices();
+	snapshot.texture_requests.clear();
+	for (uint32_t index : render_system.visible()) {
+		engine::math::AABB bounds = meshes[index]->bounds().transform(world[transforms[index]]);
+		engine::math::Vec3 extents = bounds.extents();
+		float world_size = 2 * std::max({extents.x(), extents.y(), extents.z()});
+		snapshot.texture_requests.push_back({materials[index], (bounds.center() - camera.position()).magnitude(),
+			world_size});
 	}
 	
-	engine::render::RenderHelper::sortObjects(renderables, camera);
+	blended.clear();
+	snapshot.opaque.clear();
+	render_system.submit(registry, snapshot.opaque, blended);
 	
+	std::chrono::steady_clock::time_point sort_start = std::chrono::steady_clock::now();
+	snapshot.cull_time = sort_start - cull_start;
+	engine::ecs::RenderSystem::sort(registry, camera, blended);
+	snapshot.sort_time = std::chrono::steady_clock::now() - sort_start;
+	snapshot.blended.clear();
+	for (uint32_t index : blended) {
+		snapshot.blended.push_back({meshes[index], world[transforms[index]], albedos[index]});
+	}
+	snapshot.camera = camera;
+}
+
+// Runs on the simulation thread until the window closes. The simulation advances in fixed ticks,
+// however long frames take, and publishes a snapshot after each batch of ticks.
+void simulate() {
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point last_time = Clock::now();
+	Clock::duration accumulator(0);
+	engine::Camera previous_camera = camera;
+	uint64_t frame = 0;
+	PROFILE_THREAD("simulation");
+	while (simulating.load(std::memory_order_acquire)) {
+		Clock::time_point now = Clock::now();
+		accumulator += now - last_time;
+		last_time = now;
+		// After a long stall, drop the time that can't be caught up instead of spiralling
+		accumulator = std::min<Clock::duration>(accumulator, SIMULATION_STEP * MAX_SIMULATION_STEPS);
+		
+		int steps = 0;
+		std::chrono::steady_clock::time_point input_time;
+		while (accumulator >= SIMULATION_STEP) {
+			PROFILE_SCOPE("simulation tick");
+			SharedInput input;
+			{
+				std::lock_guard<std::mutex> lock(input_mutex);
+				input = shared_input;
+				shared_input.aspect_ratio = 0;
+			}
+			if (input.aspect_ratio > 0) {
+				camera.aspect_ratio(input.aspect_ratio);
+			}
+			previous_camera = camera;
+			camera.update(input.camera, SIMULATION_STEP);
+			update_scene();
+			input_time = input.time;
+			accumulator -= SIMULATION_STEP;
+			steps++;
+		}
+		
+		if (steps > 0) {
+			engine::render::FrameSnapshot& snapshot = snapshots.back();
+			build_snapshot(snapshot);
+			snapshot.previous_camera = previous_camera;
+			snapshot.frame = frame++;
+			snapshot.input_time = input_time;
+			snapshot.time = now - accumulator;
+			snapshot.step = SIMULATION_STEP;
+			snapshots.publish();
+		}
+		
+		std::this_thread::sleep_until(now + (SIMULATION_STEP - accumulator));
+	}
+}
+
+// Draws a snapshot into a viewport of the given height. Runs on the thread owning the GL context.
+void render_snapshot(const engine::render::FrameSnapshot& snapshot, int viewport_height) {
+	PROFILE_SCOPE("render_snapshot");
+	engine::render::Material& material = texture;
+	
+	// Stream in the mips the visible objects need before anything samples them
+	if (streamed_texture >= 0) {
+		PROFILE_SCOPE("texture streaming");
+		for (const auto& request : snapshot.texture_requests) {
+			if (request.material == nullptr || request.material == &texture) {
+				texture_residency->request(streamed_texture, request.distance, request.world_size,
+					snapshot.camera.fov(), viewport_height);
+			}
+		}
+		texture_residency->update();
+	}
+	
+	// Opaque objects don't depend on draw order and are drawn instanced, grouped by mesh and material
+	// Meshes in the geometry arena are submitted with one multi-draw per material where supported
+	{
+		PROFILE_SCOPE("opaque pass");
+		GPU_PROFILE_SCOPE(gpu_profiler, "opaque pass");
+		engine::render::RenderStats::Timer timer("opaque");
+		bool indirect = engine::render::IndirectRenderer::supported();
+		instance_renderer.begin();
+		indirect_renderer.begin();
+		for (const auto& draw : snapshot.opaque) {
+			if (!indirect || !indirect_renderer.add(*draw.mesh, draw.material, draw.instance)) {
+				instance_renderer.add(*draw.mesh, draw.material, draw.instance);
+			}
+		}
+		if (indirect) {
+			indirect_renderer.draw(shader_tex_mix_variants, material);
+		}
+		instance_renderer.draw(shader_tex_mix_variants, material);
+	}
+	
+	const engine::Shader* permutation = &material.shader(shader_tex_mix_variants);
+	// Without its permutation the material is drawn by the unspecialized shader, reading the mix modes at runtime
+	bool fallback = permutation->failed();
+	const engine::Shader& shader = fallback ? shader_tex_mix_3d : *permutation;
+	if (!shader.ready()) {
+		static bool reported = false;
+		if (shader.failed() && !reported) {
+			std::cerr << "No tex_mix program for the blended pass, blended objects are not drawn" << std::endl;
+			reported = true;
+		}
+		return;
+	}
+	
+	PROFILE_SCOPE("blended pass");
+	GPU_PROFILE_SCOPE(gpu_profiler, "blended pass");
+	engine::render::RenderStats::Timer timer("blended");
 	shader.use();
-	shader.set_mat4("projection", camera.projection_matrix());
-	shader.set_mat4("view", camera.view_matrix());
-	for (auto& obj : renderables) {
-		shader.set_mat4("model", obj->get_model());
-		shader.set_vec4("albedo", obj->get_albedo());
+	
+	// Every object uses the same material, so the textures only need to be bound once per pass
+	material.bind(shader);
+	if (fallback) {
+		material.set_mix_uniforms(shader);
+	}
+	
+	for (const auto& draw : snapshot.blended) {
+		shader.set_mat4("model", draw.model);
+		shader.set_vec4("albedo", draw.albedo);
+		
+		draw.mesh->draw();
+	}
+}
+
+// Interactive mode: simulation on its own thread, rendering to the window until it closes
+int run_window() {
+	camera.reset_mouse_pos();
+	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+		shared_input.camera = engine::Camera::poll_input();
+		shared_input.time = std::chrono::steady_clock::now();
+	}
+	
+	// From here on the camera, scene and culling structures belong to the simulation thread
+	simulating.store(true, std::memory_order_release);
+	std::thread simulation(simulate);
+	
+	// End-to-end latency: input sampled -> frame simulated from it presented
+	std::chrono::steady_clock::time_point report_time = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::duration latency_sum(0);
+	std::chrono::steady_clock::duration latency_max(0);
+	int presented = 0;
+	
+	// Pace to the refresh rate or an even divisor of it
+	const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+	int refresh_rate = mode != nullptr && mode->refreshRate > 0 ? mode->refreshRate : 60;
+	engine::render::FramePacer pacer({refresh_rate, refresh_rate / 2, refresh_rate / 3, refresh_rate / 4}, VSYNC,
+		engine::render::FramePacer::fences_supported() ? FRAMES_IN_FLIGHT : 0);
+	
+	PROFILE_THREAD("main");
+	while (!glfwWindowShouldClose(window.glfw_window())) {
+		pacer.begin_frame();
+		gpu_profiler.begin_frame();
+		std::chrono::steady_clock::time_point frame_start = std::chrono::steady_clock::now();
+		
+		window.event_manager().pollEvents();
+		{
+			std::lock_guard<std::mutex> lock(input_mutex);
+			shared_input.camera = engine::Camera::poll_input();
+			shared_input.time = std::chrono::steady_clock::now();
+		}
+		
+		shader_batch.poll();
+		
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, texture.id());
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, offsetMap.id());
-		shader.set_int("textures", {0, 1});
-		shader.set_int("mixModes",
-			std::vector<int>({static_cast<int>(engine::graphics::TextureMixingMode::Multiply)}));
-		shader.set_int("texCount", 2);
+		bool fresh = snapshots.acquire();
+		if (snapshots.has_front()) {
+			const engine::render::FrameSnapshot& snapshot = snapshots.front();
+			engine::render::RenderStats::add(engine::render::RenderStats::OBJECTS_DRAWN,
+				snapshot.opaque.size() + snapshot.blended.size());
+			engine::render::RenderStats::add(engine::render::RenderStats::OBJECTS_CULLED, snapshot.culled);
+			// Simulation-side phases count once, in the frame that first shows their result
+			if (fresh) {
+				engine::render::RenderStats::add_time("cull", snapshot.cull_time);
+				engine::render::RenderStats::add_time("sort", snapshot.sort_time);
+			}
+			float alpha = snapshot.alpha(std::chrono::steady_clock::now());
+			engine::Camera view = engine::Camera::interpolate(snapshot.previous_camera, snapshot.camera, alpha);
+			camera_uniforms.update(view, (float) glfwGetTime());
+			render_snapshot(snapshot, window.height());
+		}
 		
-		obj->get_mesh().draw();
+		{
+			PROFILE_SCOPE("swap");
+			engine::render::RenderStats::Timer timer("swap");
+			glfwSwapBuffers(window.glfw_window());
+		}
+		engine::render::RenderStats::add_time("frame", std::chrono::steady_clock::now() - frame_start);
+		engine::render::RenderStats::end_frame();
+		pacer.end_frame();
+		
+		if (snapshots.has_front()) {
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			std::chrono::steady_clock::duration latency = now - snapshots.front().input_time;
+			latency_sum += latency;
+			latency_max = std::max(latency_max, latency);
+			presented++;
+			if (now - report_time >= std::chrono::seconds(1)) {
+				double average = std::chrono::duration<double, std::milli>(latency_sum).count() / presented;
+				double maximum = std::chrono::duration<double, std::milli>(latency_max).count();
+				window.set_title("Engine - " + std::to_string(presented) + " fps, latency " +
+					std::to_string((int) std::round(average)) + " ms (max " + std::to_string((int) std::round(maximum)) +
+					" ms) - " + pacer.report());
+				report_time = now;
+				latency_sum = std::chrono::steady_clock::duration(0);
+				latency_max = std::chrono::steady_clock::duration(0);
+				presented = 0;
+			}
+		}
 	}
-	shader.release();
+	
+	simulating.store(false, std::memory_order_release);
+	simulation.join();
+	
+	engine::render::RenderStats::write_csv(STATS_PATH);
+	pacer.destroy();
+	return 0;
+}
+
+// Writes RGBA rows, bottom to top as read back from GL, as a binary PPM
+bool write_ppm(const std::string& path, int width, int height, const std::vector<uint8_t>& pixels) {
+	std::ofstream file(path, std::ios::binary);
+	if (!file) {
+		std::cerr << "Failed to write " << path << std::endl;
+		return false;
+	}
+	file << "P6\n" << width << " " << height << "\n255\n";
+	for (int y = height - 1; y >= 0; y--) {
+		for (int x = 0; x < width; x++) {
+			file.write(reinterpret_cast<const char*>(&pixels[((size_t) y * width + x) * 4]), 3);
+		}
+	}
+	return (bool) file;
+}
+
+// Headless mode: renders a fixed number of frames into an offscreen framebuffer on this thread.
+// The simulation advances one step per frame, however long the frame takes, so every run renders
+// the same frames and only the timing differs.
+int run_headless(const Options& options) {
+	engine::render::Framebuffer target = engine::render::Framebuffer::create(options.width, options.height);
+	if (!target.complete()) {
+		return -1;
+	}
+	engine::CameraPath path;
+	if (!options.camera_path.empty()) {
+		path = engine::CameraPath::load(options.camera_path);
+		if (path.empty()) {
+			std::cerr << "Camera path has no keyframes: " << options.camera_path << std::endl;
+			return -1;
+		}
+	}
+	
+	PROFILE_THREAD("main");
+	// Timing starts once every program is built
+	shader_batch.wait();
+	target.bind();
+	
+	engine::render::FrameSnapshot snapshot;
+	std::vector<double> frame_times;
+	frame_times.reserve(options.frames);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < options.frames; frame++) {
+		std::chrono::steady_clock::time_point frame_start = std::chrono::steady_clock::now();
+		float time = std::chrono::duration<float>(SIMULATION_STEP * frame).count();
+		
+		engine::Camera previous_camera = camera;
+		path.apply(camera, time);
+		update_scene();
+		build_snapshot(snapshot);
+		snapshot.previous_camera = previous_camera;
+		snapshot.frame = frame;
+		engine::render::RenderStats::add(engine::render::RenderStats::OBJECTS_DRAWN,
+			snapshot.opaque.size() + snapshot.blended.size());
+		engine::render::RenderStats::add(engine::render::RenderStats::OBJECTS_CULLED, snapshot.culled);
+		engine::render::RenderStats::add_time("cull", snapshot.cull_time);
+		engine::render::RenderStats::add_time("sort", snapshot.sort_time);
+		
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		camera_uniforms.update(camera, time);
+		render_snapshot(snapshot, options.height);
+		{
+			// Nothing presents the frame, so wait for the GPU to have the frame time include its work
+			engine::render::RenderStats::Timer timer("finish");
+			glFinish();
+		}
+		
+		std::chrono::steady_clock::duration frame_time = std::chrono::steady_clock::now() - frame_start;
+		engine::render::RenderStats::add_time("frame", frame_time);
+		engine::render::RenderStats::end_frame();
+		frame_times.push_back(std::chrono::duration<double, std::milli>(frame_time).count());
+	}
+	double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	
+	if (!options.capture_path.empty()) {
+		write_ppm(options.capture_path, target.width(), target.height(), target.read_pixels());
+	}
+	engine::render::Framebuffer::unbind();
+	target.destroy();
+	
+	// Same ranks as the render stats report, which only keeps its last window of frames
+	engine::render::RenderStats::Percentiles frame_time = engine::render::RenderStats::percentiles(frame_times);
+	std::printf("Rendered %d frames at %dx%d in %.3f s (%.1f fps)\n", options.frames, options.width, options.height, total,
+		total > 0 ? options.frames / total : 0.0);
+	std::printf("frame time p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n", frame_time.p50, frame_time.p95,
+		frame_time.p99, frame_time.max);
+	std::cout << engine::render::RenderStats::report();
+	if (!options.stats_path.empty()) {
+		engine::render::RenderStats::write_csv(options.stats_path);
+	}
+	return 0;
+}
+
+void print_usage(const char* program) {
+	std::cout << "Usage: " << program << " [options]\n"
+		"  --headless           render offscreen for a fixed number of frames and report timing\n"
+		"  --frames N           frames to render headless (default 600)\n"
+		"  --size WxH           headless framebuffer size (default 800x600)\n"
+		"  --context API        headless context (default native): native uses a hidden window and needs a\n"
+		"                       display, egl and osmesa run on GLFW's null platform without one\n"
+		"  --camera-path FILE   headless camera keyframes, see engine::CameraPath\n"
+		"  --stats FILE         write per-frame render stats as CSV after a headless run\n"
+		"  --capture FILE       write the last headless frame as a PPM image\n"
+		"  --profile            record a profile from the start, written to " << PROFILE_PATH << "\n";
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+		if (arg == "--headless") {
+			options.headless = true;
+		}
+		else if (arg == "--profile") {
+			options.profile = true;
+		}
+		else if (arg == "--frames" && has_value) {
+			options.frames = std::atoi(argv[++i]);
+		}
+		else if (arg == "--size" && has_value) {
+			if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2) {
+				options.width = 0;
+			}
+		}
+		else if (arg == "--context" && has_value) {
+			options.context = argv[++i];
+		}
+		else if (arg == "--camera-path" && has_value) {
+			options.camera_path = argv[++i];
+		}
+		else if (arg == "--stats" && has_value) {
+			options.stats_path = argv[++i];
+		}
+		else if (arg == "--capture" && has_value) {
+			options.capture_path = argv[++i];
+		}
+		else {
+			print_usage(argv[0]);
+			return false;
+		}
+	}
+	if (options.frames <= 0 || options.width <= 0 || options.height <= 0 ||
+		(options.context != "native" && options.context != "egl" && options.context != "osmesa")) {
+		print_usage(argv[0]);
+		return false;
+	}
+	return true;
 }
 
 int main(int argc, char** argv) {
+	Options options;
+	if (!parse_options(argc, argv, options)) {
+		return -1;
+	}
+	
+	if (options.headless && options.context != "native") {
+		// No display server needed, EGL or OSMesa create the context on their own
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+	}
 	if (!glfwInit()) {
 		std::cerr << "Failed to initialize GLFW" << std::endl;
 		return -1;
 	}
 	
-	glutInit(&argc, argv);
+	// GLUT needs a display; headless runs have none
+	if (!options.headless) {
+		glutInit(&argc, argv);
+	}
 	
 	// Print GLFW, GLEW, and GLUT versions
 	{
 		std::cout << "Starting engine" << std::endl;
 		const char* glfw_version = glfwGetVersionString();
 		const unsigned char* glew_version = glewGetString(GLEW_VERSION);
-		const int glut_version = glutGet(GLUT_VERSION);
+		const int glut_version = options.headless ? 0 : glutGet(GLUT_VERSION);
 		
 		if (glfw_version == NULL)
 			std::cout << "Failed to get GLFW version" << std::endl;
@@ -171,10 +633,25 @@ int main(int argc, char** argv) {
 			std::cout << "Failed to get GLEW version" << std::endl;
 		else
 			std::cout << "Using GLEW version " << glew_version << std::endl;
-		std::cout << "Using GLUT version " << glut_version << std::endl;
+		if (!options.headless)
+			std::cout << "Using GLUT version " << glut_version << std::endl;
 	}
 	
+	if (options.headless) {
+		// Frames go to an offscreen framebuffer, the window only provides the context
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		if (options.context == "egl") {
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+		}
+		else if (options.context == "osmesa") {
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+		}
+	}
 	window.create();
+	if (!window.glfw_window()) {
+		glfwTerminate();
+		return -1;
+	}
 	
 	// Initialize GLEW
 	{
@@ -203,10 +680,12 @@ int main(int argc, char** argv) {
 		std::cout << std::endl;
 	}
 	
-	glfwSetInputMode(window.glfw_window(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-	
+	if (!options.headless) {
+		glfwSetInputMode(window.glfw_window(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	}
 	
-	camera = engine::Camera(90, (float) window.width() / window.height(), 0.1f, 1000.0f);
+	float aspect_ratio = options.headless ? (float) options.width / options.height : (float) window.width() / window.height();
+	camera = engine::Camera(90, aspect_ratio, 0.1f, 1000.0f);
 	camera.set_position(engine::math::Vec3(0, 0, 0));
 	camera.set_rotation(engine::math::Vec3(0, 0, 0));
 	
@@ -214,18 +693,26 @@ int main(int argc, char** argv) {
 	window.event_manager().addResizeCallback(on_resize);
 	window.event_manager().addKeyCallback(on_key);
 	
-	glfwSwapInterval(1);
+	// Either the swap or the frame pacer limits the rate, never both
+	glfwSwapInterval(VSYNC && !options.headless ? 1 : 0);
+	
+	if (options.profile) {
+		engine::profile::Profiler::enable(true);
+	}
 	
 	// Render settings
 	{
+		// Tracked state goes through the backend so its cache knows about it
+		engine::render::GLBackend& backend = engine::render::GLBackend::current();
+		
 		// Enable depth testing
-		glEnable(GL_DEPTH_TEST);
-		glDepthFunc(GL_LESS);
+		backend.enable(GL_DEPTH_TEST);
+		backend.depth_func(GL_LESS);
 		glClearDepth(1.0);
 		
 		// Enable blending
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		backend.enable(GL_BLEND);
+		backend.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		glAlphaFunc(GL_GREATER, 0.1);
 		
 		// Enable face culling
@@ -234,26 +721,56 @@ int main(int argc, char** argv) {
 		glFrontFace(GL_CCW);
 		
 		// Enable multisampling
-		glEnable(GL_MULTISAMPLE);
+		backend.enable(GL_MULTISAMPLE);
 		
 	}
 	
-	shader_col_3d = engine::Shader("../res/shaders/color-3d.vert", "../res/shaders/color.frag");
-	shader_tex_3d = engine::Shader("../res/shaders/tex-3d.vert", "../res/shaders/tex.frag");
-	shader_tex_mix_3d = engine::Shader("../res/shaders/tex-3d.vert", "../res/shaders/tex_mix.frag");
-	shader_tex_refract_3d = engine::Shader("../res/shaders/tex-3d.vert", "../res/shaders/tex_refract.frag");
+	// Keep linked programs between runs, recompiling only when a source or the driver changes
+	engine::render::ProgramCache::set_directory("../cache/shaders");
+	
+	camera_uniforms = engine::render::CameraUniforms::create();
+	
+	// Build all programs concurrently, they are picked up by the main loop as they finish
+	shader_batch.add(shader_col_3d, "../res/shaders/color-3d.vert", "../res/shaders/color.frag");
+	shader_batch.add(shader_tex_3d, "../res/shaders/tex-3d.vert", "../res/shaders/tex.frag");
+	shader_batch.add(shader_tex_mix_3d, "../res/shaders/tex-3d.vert", "../res/shaders/tex_mix.frag");
+	shader_batch.add(shader_tex_refract_3d, "../res/shaders/tex-3d.vert", "../res/shaders/tex_refract.frag");
 	
 	// Load the textures
 	{
-		texture1 = engine::graphics::Texture("../res/assets/Untitled.jpg").load();
-		texture2 = engine::graphics::Texture("../res/assets/13391-normal.jpg").load();
-		texture3 = engine::graphics::Texture("../res/assets/height.png").load();
+		texture1 = engine::graphics::Texture("../res/assets/Untitled.jpg");
+		texture2 = engine::graphics::Texture("../res/assets/13391-normal.jpg");
+		texture3 = engine::graphics::Texture("../res/assets/height.png");
+		engine::graphics::Texture::loadAll({&texture1, &texture2, &texture3});
+		
+		texture_residency.emplace(TEXTURE_BUDGET);
+		streamed_texture = texture_residency->add(texture1);
+		if (streamed_texture >= 0) {
+			texture = engine::render::Material(*texture_residency, streamed_texture);
+		}
+		// The other maps are packed into one atlas and share its bind
+		engine::graphics::TextureAtlas atlas(1024, 1024);
+		int offset_region = atlas.add(texture2);
+		int height_region = atlas.add(texture3);
+		atlas.build();
+		offsetMap = engine::render::Material(atlas, offset_region);
+		heightMap = engine::render::Material(atlas, height_region);
 		
-		texture = engine::render::Material(texture1);
-		offsetMap = engine::render::Material(texture2);
-		heightMap = engine::render::Material(texture3);
+		texture.add_layer(offsetMap, engine::graphics::TextureMixingMode::Multiply);
 	}
 	
+	instance_renderer = engine::render::InstanceRenderer::create();
+	geometry_arena = engine::render::GeometryArena::create(1 << 16, 1 << 18);
+	indirect_renderer = engine::render::IndirectRenderer::create(geometry_arena);
+	
+	shader_tex_mix_variants.prepare(texture.variant_defines(), shader_batch);
+	{
+		std::vector<std::string> defines = texture.variant_defines();
+		defines.push_back(engine::render::InstanceRenderer::DEFINE);
+		shader_tex_mix_variants.prepare(defines, shader_batch);
+	}
+	shader_batch.submit();
+	
 	// Create the square ring mesh
 	{
 		float inner_radius = 0.2;
@@ -286,7 +803,7 @@ int main(int argc, char** argv) {
 		};
 		
 		// Create the Mesh object
-		square_ring_mesh = engine::render::Mesh(vertices, indices);
+		square_ring_mesh = engine::render::Mesh(vertices, indices, geometry_arena);
 	}
 	
 	// Create the square mesh
@@ -303,7 +820,7 @@ int main(int argc, char** argv) {
 		std::vector<unsigned int> indices = {0, 1, 3, 1, 2, 3};
 		
 		// Create the Mesh object
-		square_mesh = engine::render::Mesh(vertices, indices);
+		square_mesh = engine::render::Mesh(vertices, indices, geometry_arena);
 		//square_mesh = engine::render::Mesh::fromHeightmap(texture3, 0.1, 40, 40);
 	}
 	
@@ -313,62 +830,47 @@ int main(int argc, char** argv) {
 		for (int j = -sl; j <= sl; j++) {
 			for (int k = -sl; k <= sl; k++) {
 				if (i == 0 && j == 0 && k == 0) continue;
-				add_cube(engine::math::Vec3(i * dl, j * dl, k * dl));
+				engine::ecs::Prefabs::add_cube(registry, scene_graph, square_mesh,
+					engine::math::Vec3(i * dl, j * dl, k * dl));
 			}
 		}
 	}*/
-	add_cube(engine::math::Vec3(4, 0, 0), 0.5);
-	add_cube(engine::math::Vec3(-4, 0, 0));
+	engine::ecs::Prefabs::add_cube(registry, scene_graph, square_mesh, engine::math::Vec3(4, 0, 0), nullptr, 0.5);
+	engine::ecs::Prefabs::add_cube(registry, scene_graph, square_mesh, engine::math::Vec3(-4, 0, 0));
 	
 	{
-		engine::object::Object obj(square_mesh);
-		obj.position() = engine::math::Vec3(0, 0, -10);
-		obj.rotation() = engine::math::Vec3(0, 0, 0);
-		obj.scale() = engine::math::Vec3(5);
-		obj.albedo() = engine::math::Vec4(1, 1, 1, 1);
-		objects.push_back(obj);
+		engine::ecs::Entity backdrop = registry.create();
+		registry.add_transform(backdrop, engine::math::Vec3(0, 0, -10), engine::math::Vec3(0, 0, 0),
+			engine::math::Vec3(5));
+		registry.add_render(backdrop, square_mesh, nullptr, engine::math::Vec4(1, 1, 1, 1));
+		occluders.push_back(registry.render_count() - 1);
 	}
 	
-	std::chrono::milliseconds last_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-		std::chrono::system_clock::now().time_since_epoch()
-	);
-	camera.reset_mouse_pos();
+	scene_graph.update();
+	registry.update_transforms();
+	static_objects = engine::scene::StaticBVH::build(engine::ecs::RenderSystem::bounds(registry));
 	
-	while (!glfwWindowShouldClose(window.glfw_window())) {
-		std::chrono::milliseconds start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-			std::chrono::system_clock::now().time_since_epoch()
-		);
-		
-		std::chrono::milliseconds delta_time = start_time - last_time;
-		last_time = start_time;
-		
-		camera.update(delta_time);
-		
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		
-		render_all();
-		
-		glfwSwapBuffers(window.glfw_window());
-		window.event_manager().pollEvents();
-		
-		std::chrono::milliseconds end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-			std::chrono::system_clock::now().time_since_epoch()
-		);
-		std::chrono::milliseconds elapsed_time = end_time - start_time;
-		std::chrono::milliseconds sleep_time = std::chrono::milliseconds(1000 / GAME_FPS) - elapsed_time;
-		if (sleep_time > std::chrono::milliseconds(0)) {
-			std::this_thread::sleep_for(sleep_time);
-		}
-	}
+	int result = options.headless ? run_headless(options) : run_window();
 	
+	if (engine::profile::Profiler::enabled()) {
+		engine::profile::Profiler::write_chrome_trace(PROFILE_PATH);
+	}
+	std::cout << engine::profile::MemoryTracker::report();
+	engine::profile::MemoryTracker::write_report(MEMORY_PATH);
+	gpu_profiler.destroy();
+	camera_uniforms.destroy();
+	instance_renderer.destroy();
+	indirect_renderer.destroy();
 	engine::Shader::destroyAll();
 	engine::render::Mesh::destroyAll();
+	geometry_arena.destroy();
 	engine::render::Material::destroyAll();
+	engine::graphics::TextureAtlas::destroyAll();
+	engine::graphics::TextureArray::destroyAll();
+	texture_residency.reset();
 	engine::graphics::Texture::destroyAll();
 	glfwTerminate();
-	return 0;
+	return result;
 }
 
 #pragma clang diagnostic pop
@@ -0,0 +1,121 @@
+#include <iostream>
+#include <vector>
+
+#include "../engine/Camera.hpp"
+#include "../engine/math/AABB.hpp"
+#include "../engine/render/OcclusionCuller.hpp"
+
+// Checks that occluders don't hide themselves: a backdrop quad like the one in the main scene is
+// rasterized as an occluder and then tested against the depth buffer it filled, from many camera
+// positions on the way towards it.
+
+static int failures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+			failures++; \
+		} \
+	} while (false)
+
+// Stands in for an object with a mesh, without needing GL buffers
+class Marker : public engine::object::Renderable {
+private:
+	engine::render::Mesh m_mesh;
+	engine::math::Mat4 m_model;
+
+public:
+	explicit Marker(const engine::math::Vec3& position)
+		: m_mesh(), m_model(engine::math::Mat4::translation(position)) {
+	}
+	
+	const engine::render::Mesh& get_mesh() const override {
+		return m_mesh;
+	}
+	const engine::math::Mat4 get_model() const override {
+		return m_model;
+	}
+};
+
+// The main scene's square mesh at z = -10, scaled by 5
+static const std::vector<engine::math::Vec3> QUAD_POSITIONS = {
+	engine::math::Vec3(-1, -1, 0), engine::math::Vec3(1, -1, 0), engine::math::Vec3(1, 1, 0), engine::math::Vec3(-1, 1, 0)
+};
+static const std::vector<unsigned int> QUAD_INDICES = {0, 1, 3, 1, 2, 3};
+static const engine::math::Mat4 QUAD_MODEL =
+	engine::math::Mat4::translation(0, 0, -10) * engine::math::Mat4::scale(5, 5, 5);
+static const engine::math::AABB QUAD_BOUNDS(engine::math::Vec3(-5, -5, -10), engine::math::Vec3(5, 5, -10));
+
+static engine::math::Mat4 view_projection(float z) {
+	engine::Camera camera(90, 800.0f / 600.0f, 0.1f, 1000.0f);
+	camera.set_position(engine::math::Vec3(0, 0, z));
+	return camera.projection_matrix() * camera.view_matrix();
+}
+
+static void test_occluder_stays_visible() {
+	engine::render::OcclusionCuller culler;
+	// From 0.5 in front of the quad towards the origin
+	const int POSITIONS = 416;
+	int hidden = 0;
+	for (int i = 0; i < POSITIONS; i++) {
+		float z = -9.5f + 9.5f * i / POSITIONS;
+		culler.begin(view_projection(z));
+		culler.add_occluder(QUAD_POSITIONS, QUAD_INDICES, QUAD_MODEL);
+		culler.finish();
+		if (!culler.visible(QUAD_BOUNDS)) {
+			std::cerr << "Quad hides itself from z = " << z << std::endl;
+			hidden++;
+		}
+	}
+	CHECK(hidden == 0);
+}
+
+static void test_hidden_behind_quad() {
+	engine::render::OcclusionCuller culler;
+	culler.begin(view_projection(0));
+	culler.add_occluder(QUAD_POSITIONS, QUAD_INDICES, QUAD_MODEL);
+	culler.finish();
+	// The slack must not let things well behind the occluder through
+	CHECK(!culler.visible(engine::math::AABB(engine::math::Vec3(-1, -1, -12), engine::math::Vec3(1, 1, -11))));
+	CHECK(culler.visible(engine::math::AABB(engine::math::Vec3(-1, -1, -9), engine::math::Vec3(1, 1, -8))));
+}
+
+static void test_cull_skips_occluders() {
+	engine::render::OcclusionCuller culler;
+	// Both markers are behind the quad, but one of them is registered as an occluder
+	Marker occluder(engine::math::Vec3(0, 0, -20));
+	Marker hidden(engine::math::Vec3(0, 0, -20));
+	culler.begin(view_projection(0));
+	culler.add_occluder(QUAD_POSITIONS, QUAD_INDICES, QUAD_MODEL);
+	culler.add_occluder(occluder);
+	culler.finish();
+	
+	std::vector<engine::object::Renderable*> renderables = {&hidden, &occluder};
+	std::vector<engine::object::Renderable*> visible;
+	culler.cull(renderables, visible);
+	CHECK(visible.size() == 1 && visible[0] == &occluder);
+	CHECK(culler.tested() == 1);
+	CHECK(culler.occluded() == 1);
+	
+	// Occluders only count for the frame they were added in
+	culler.begin(view_projection(0));
+	culler.add_occluder(QUAD_POSITIONS, QUAD_INDICES, QUAD_MODEL);
+	culler.finish();
+	visible.clear();
+	culler.cull(renderables, visible);
+	CHECK(visible.empty());
+}
+
+int main() {
+	test_occluder_stays_visible();
+	test_hidden_behind_quad();
+	test_cull_skips_occluders();
+	
+	if (failures > 0) {
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << "All checks passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,163 @@
+#include <iostream>
+
+#include "GL/glew.h"
+
+#include "../engine/render/StateCache.hpp"
+#include "../engine/render/MockGLBackend.hpp"
+
+// Drives a StateCache over a MockGLBackend and checks which calls reach the backend.
+
+static int failures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+			failures++; \
+		} \
+	} while (false)
+
+static void test_program() {
+	engine::render::MockGLBackend gl;
+	engine::render::StateCache cache(gl);
+	cache.use_program(5);
+	cache.use_program(5);
+	CHECK(gl.calls().use_program == 1);
+	CHECK(cache.skipped().program == 1);
+	cache.use_program(6);
+	CHECK(gl.calls().use_program == 2);
+	CHECK(gl.program() == 6);
+	
+	// A deleted program's name may come back for a new one
+	cache.delete_program(6);
+	cache.use_program(6);
+	CHECK(gl.calls().use_program == 3);
+}
+
+static void test_vertex_array() {
+	engine::render::MockGLBackend gl;
+	engine::render::StateCache cache(gl);
+	cache.bind_vertex_array(1);
+	cache.bind_vertex_array(1);
+	CHECK(gl.calls().bind_vertex_array == 1);
+	CHECK(cache.skipped().vertex_array == 1);
+	cache.bind_vertex_array(2);
+	cache.bind_vertex_array(1);
+	CHECK(gl.calls().bind_vertex_array == 3);
+	CHECK(gl.vertex_array() == 1);
+}
+
+static void test_buffers() {
+	engine::render::MockGLBackend gl;
+	engine::render::StateCache cache(gl);
+	cache.bind_buffer(GL_ARRAY_BUFFER, 3);
+	cache.bind_buffer(GL_ARRAY_BUFFER, 3);
+	CHECK(gl.calls().bind_buffer == 1);
+	CHECK(cache.skipped().buffer == 1);
+	
+	// Targets are tracked separately
+	cache.bind_buffer(GL_UNIFORM_BUFFER, 3);
+	CHECK(gl.calls().bind_buffer == 2);
+	
+	// The element array binding is part of the vertex array, so it is always forwarded
+	cache.bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 4);
+	cache.bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 4);
+	CHECK(gl.calls().bind_buffer == 4);
+	CHECK(gl.buffer(GL_ELEMENT_ARRAY_BUFFER) == 4);
+	CHECK(cache.skipped().buffer == 1);
+	
+	// Indexed bindings replace the generic binding too
+	cache.bind_buffer_base(GL_UNIFORM_BUFFER, 0, 7);
+	CHECK(gl.buffer(GL_UNIFORM_BUFFER, 0) == 7);
+	cache.bind_buffer(GL_UNIFORM_BUFFER, 7);
+	CHECK(gl.calls().bind_buffer == 4);
+	cache.bind_buffer(GL_UNIFORM_BUFFER, 3);
+	CHECK(gl.calls().bind_buffer == 5);
+	
+	cache.delete_buffer(3);
+	cache.bind_buffer(GL_ARRAY_BUFFER, 3);
+	CHECK(gl.calls().bind_buffer == 6);
+}
+
+static void test_textures() {
+	engine::render::MockGLBackend gl;
+	engine::render::StateCache cache(gl);
+	unsigned int texture = cache.create_texture();
+	cache.active_texture(0);
+	cache.bind_texture(GL_TEXTURE_2D, texture);
+	cache.bind_texture(GL_TEXTURE_2D, texture);
+	CHECK(gl.calls().bind_texture == 1);
+	CHECK(cache.skipped().texture == 1);
+	
+	// Each unit and target has its own binding
+	cache.active_texture(1);
+	cache.bind_texture(GL_TEXTURE_2D, texture);
+	cache.bind_texture(GL_TEXTURE_2D_ARRAY, texture);
+	CHECK(gl.calls().bind_texture == 3);
+	CHECK(gl.bound_texture(1, GL_TEXTURE_2D) == texture);
+	
+	cache.active_texture(0);
+	cache.active_texture(0);
+	CHECK(gl.calls().active_texture == 3);
+	CHECK(cache.skipped().active_texture == 1);
+	cache.bind_texture(GL_TEXTURE_2D, texture);
+	CHECK(gl.calls().bind_texture == 3);
+	
+	// Deleting unbinds the texture from every unit
+	cache.delete_texture(texture);
+	cache.bind_texture(GL_TEXTURE_2D, texture);
+	CHECK(gl.calls().bind_texture == 4);
+}
+
+static void test_fixed_function() {
+	engine::render::MockGLBackend gl;
+	engine::render::StateCache cache(gl);
+	cache.enable(GL_BLEND);
+	cache.enable(GL_BLEND);
+	cache.disable(GL_BLEND);
+	CHECK(gl.calls().enable == 1);
+	CHECK(gl.calls().disable == 1);
+	CHECK(!gl.enabled(GL_BLEND));
+	cache.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	cache.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	cache.depth_func(GL_LEQUAL);
+	cache.depth_func(GL_LEQUAL);
+	cache.depth_mask(false);
+	cache.depth_mask(false);
+	CHECK(gl.calls().blend_func == 1);
+	CHECK(gl.calls().depth_func == 1);
+	CHECK(gl.calls().depth_mask == 1);
+	CHECK(cache.skipped().total() == 4);
+}
+
+static void test_invalidate() {
+	engine::render::MockGLBackend gl;
+	engine::render::StateCache cache(gl);
+	cache.use_program(1);
+	cache.bind_vertex_array(1);
+	cache.bind_buffer(GL_ARRAY_BUFFER, 1);
+	gl.reset_calls();
+	
+	// Someone changed state behind the cache's back
+	cache.invalidate();
+	cache.use_program(1);
+	cache.bind_vertex_array(1);
+	cache.bind_buffer(GL_ARRAY_BUFFER, 1);
+	CHECK(gl.calls().state_changes() == 3);
+}
+
+int main() {
+	test_program();
+	test_vertex_array();
+	test_buffers();
+	test_textures();
+	test_fixed_function();
+	test_invalidate();
+	
+	if (failures > 0) {
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << "All checks passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include <iostream>
+#include <algorithm>
+
+#include "GL/glew.h"
+
+#include "../engine/graphics/Texture.hpp"
+#include "../engine/graphics/TextureResidency.hpp"
+#include "../engine/render/MockGLBackend.hpp"
+
+// Streams a texture through TextureResidency into a MockGLBackend and checks that the levels on the
+// "GPU" always match what the residency reports. Takes the path of a small test image.
+
+static int failures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+			failures++; \
+		} \
+	} while (false)
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " image" << std::endl;
+		return 1;
+	}
+	engine::graphics::Texture texture(argv[1]);
+	texture.load();
+	if (!texture.loaded()) {
+		return 1;
+	}
+	
+	engine::render::MockGLBackend gl;
+	{
+		// Mips of at most 4 pixels stay resident, everything finer is streamed
+		engine::graphics::TextureResidency residency(1024 * 1024, 1024 * 1024, 4, gl);
+		engine::graphics::TextureResidency::Handle handle = residency.add(texture);
+		CHECK(handle >= 0);
+		unsigned int id = residency.id(handle);
+		CHECK(gl.has_texture(id));
+		CHECK(gl.calls().create_texture == 1);
+		
+		// Only the tail is uploaded up front
+		int tail = residency.resident_level(handle);
+		CHECK(tail > 0);
+		CHECK(gl.texture_bytes(id) == residency.texture_bytes(handle));
+		CHECK(gl.uploaded_bytes() == residency.resident_bytes());
+		CHECK(gl.texture(id).parameters.at(GL_TEXTURE_BASE_LEVEL) == tail);
+		
+		// Nothing requested, nothing streamed
+		residency.update();
+		CHECK(residency.resident_level(handle) == tail);
+		
+		// One level per update until the full resolution is resident
+		for (int level = tail - 1; level >= 0; level--) {
+			residency.request(handle, static_cast<float>(std::max(texture.width(), texture.height())));
+			residency.update();
+			CHECK(residency.resident_level(handle) == level);
+			CHECK(gl.texture(id).parameters.at(GL_TEXTURE_BASE_LEVEL) == level);
+			CHECK(gl.texture_bytes(id) == residency.texture_bytes(handle));
+		}
+		CHECK(gl.uploaded_bytes() == residency.resident_bytes());
+		
+		// Lowering the budget evicts the unused fine mips again, but never the tail
+		residency.budget(0);
+		residency.update();
+		residency.update();
+		CHECK(residency.resident_level(handle) == tail);
+		CHECK(gl.texture_bytes(id) == residency.texture_bytes(handle));
+		CHECK(gl.texture(id).parameters.at(GL_TEXTURE_BASE_LEVEL) == tail);
+		
+		residency.remove(handle);
+		CHECK(!gl.has_texture(id));
+		CHECK(residency.resident_bytes() == 0);
+	}
+	CHECK(gl.calls().delete_texture == 1);
+	
+	engine::graphics::Texture::destroyAll();
+	
+	if (failures > 0) {
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << "All checks passed" << std::endl;
+	return 0;
+}